@@ -900,7 +900,15 @@ class SensorData {
       FORMULA_MULTIPLY,
       FORMULA_CELL,
       FORMULA_CONSUMPTION,
-      FORMULA_DIST
+      FORMULA_DIST,
+      FORMULA_HISTORY
+    };
+
+    enum
+    {
+      HISTORY_AVERAGE,
+      HISTORY_SLOPE,
+      HISTORY_PERCENTILE
     };
 
     enum {
@@ -960,10 +968,15 @@ class SensorData {
     // for consumption
     unsigned int amps;
 
-    // for cell
+    // for cell and history
     unsigned int source;
     unsigned int index;
 
+    // for history
+    unsigned int stat;
+    unsigned int scale;
+    unsigned int percent;
+
     // for calculations
     int sources[4];
 
@@ -75,6 +75,7 @@ namespace OpenTxM64 {
 #include "radio/src/functions.cpp"
 #include "radio/src/curves.cpp"
 #include "radio/src/mixer.cpp"
+#include "radio/src/timers.cpp"
 #include "radio/src/pulses/pulses_avr.cpp"
 #include "radio/src/stamp.cpp"
 #include "radio/src/maths.cpp"
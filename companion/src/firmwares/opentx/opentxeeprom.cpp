@@ -2679,6 +2679,8 @@ class SensorField: public TransformedField {
           _param = (sensor.gps) + (sensor.alt << 8);
         else if (sensor.formula == SensorData::FORMULA_CONSUMPTION)
           _param = (sensor.amps);
+        else if (sensor.formula == SensorData::FORMULA_HISTORY)
+          _param = (sensor.source) + (sensor.stat << 8) + (sensor.scale << 16) + (sensor.percent << 24);
       }
     }
 
@@ -2700,6 +2702,8 @@ class SensorField: public TransformedField {
           (sensor.gps = _sources[0], sensor.alt = _sources[1]);
         else if (sensor.formula == SensorData::FORMULA_CONSUMPTION)
           sensor.amps = _sources[0];
+        else if (sensor.formula == SensorData::FORMULA_HISTORY)
+          (sensor.source = _sources[0], sensor.stat = _sources[1], sensor.scale = _sources[2], sensor.percent = _sources[3]);
       }
     }
 
@@ -498,11 +498,23 @@ TelemetrySensorPanel::TelemetrySensorPanel(QWidget *parent, SensorData & sensor,
     ui->cellsIndex->addItem(tr("Cell %1").arg(i), i);
   ui->cellsIndex->addItem(tr("Highest"), 0);
   ui->cellsIndex->addItem(tr("Delta"), 0);
+  ui->cellsIndex->addItem(tr("Sag"), 0);
   ui->cellsIndex->setField(sensor.index);
+  ui->historySensor->setField(sensor.source);
+  ui->historyStat->addItem(tr("Average"), 0);
+  ui->historyStat->addItem(tr("Slope/s"), 1);
+  ui->historyStat->addItem(tr("Percentile"), 2);
+  ui->historyStat->setField(sensor.stat);
+  ui->historyScale->addItem(tr("3.2s"), 0);
+  ui->historyScale->addItem(tr("32s"), 1);
+  ui->historyScale->addItem(tr("320s"), 2);
+  ui->historyScale->setField(sensor.scale);
+  ui->historyPercent->setField(sensor.percent);
   ui->source1->setField(sensor.sources[0]);
   ui->source2->setField(sensor.sources[1]);
   ui->source3->setField(sensor.sources[2]);
   ui->source4->setField(sensor.sources[3]);
+  connect(ui->historyStat, SIGNAL(currentIndexChanged(int)), this, SLOT(update()));
   update();
 }
 
@@ -517,6 +529,7 @@ void TelemetrySensorPanel::update()
   bool gpsFieldsDisplayed = false;
   bool cellsFieldsDisplayed = false;
   bool consFieldsDisplayed = false;
+  bool historyFieldsDisplayed = false;
   bool ratioFieldsDisplayed = false;
   bool sources12FieldsDisplayed = false;
   bool sources34FieldsDisplayed = false;
@@ -535,10 +548,11 @@ void TelemetrySensorPanel::update()
     ui->instance->hide();
     ui->formula->show();
     ui->formula->setCurrentIndex(sensor.formula);
-    precDisplayed = (sensor.formula < SensorData::FORMULA_CELL);
+    precDisplayed = (sensor.formula < SensorData::FORMULA_CELL || sensor.formula == SensorData::FORMULA_HISTORY);
     gpsFieldsDisplayed = (sensor.formula == SensorData::FORMULA_DIST);
     cellsFieldsDisplayed = (sensor.formula == SensorData::FORMULA_CELL);
     consFieldsDisplayed = (sensor.formula == SensorData::FORMULA_CONSUMPTION);
+    historyFieldsDisplayed = (sensor.formula == SensorData::FORMULA_HISTORY);
     sources12FieldsDisplayed = (sensor.formula <= SensorData::FORMULA_MULTIPLY);
     sources34FieldsDisplayed = (sensor.formula < SensorData::FORMULA_MULTIPLY);
     updateSourcesComboBox(ui->source1, true);
@@ -549,6 +563,7 @@ void TelemetrySensorPanel::update()
     updateSourcesComboBox(ui->altSensor, false);
     updateSourcesComboBox(ui->ampsSensor, false);
     updateSourcesComboBox(ui->cellsSensor, false);
+    updateSourcesComboBox(ui->historySensor, false);
   }
   else {
     ui->idLabel->show();
@@ -577,6 +592,11 @@ void TelemetrySensorPanel::update()
   ui->cellsSensorLabel->setVisible(cellsFieldsDisplayed);
   ui->cellsSensor->setVisible(cellsFieldsDisplayed);
   ui->cellsIndex->setVisible(cellsFieldsDisplayed);
+  ui->historySensorLabel->setVisible(historyFieldsDisplayed);
+  ui->historySensor->setVisible(historyFieldsDisplayed);
+  ui->historyStat->setVisible(historyFieldsDisplayed);
+  ui->historyScale->setVisible(historyFieldsDisplayed);
+  ui->historyPercent->setVisible(historyFieldsDisplayed && sensor.stat == SensorData::HISTORY_PERCENTILE);
   ui->source1->setVisible(sources12FieldsDisplayed);
   ui->source2->setVisible(sources12FieldsDisplayed);
   ui->source3->setVisible(sources34FieldsDisplayed);
@@ -628,6 +648,10 @@ void TelemetrySensorPanel::on_formula_currentIndexChanged(int index)
 {
   if (!lock) {
     sensor.formula = index;
+    if (sensor.formula == SensorData::FORMULA_HISTORY) {
+      sensor.percent = 50;
+      ui->historyPercent->updateValue();
+    }
     update();
     emit modified();
   }
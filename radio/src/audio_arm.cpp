@@ -605,13 +605,29 @@ int WavContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
 #endif
 
 const unsigned int toneVolumes[] = { 10, 8, 6, 4, 2 };
-inline float evalVolumeRatio(int freq, int volume)
+inline uint16_t evalVolumeScale(int freq, int volume)
 {
-  float result = toneVolumes[2+volume];
-  if (freq < 330) {
-    result = (result * freq * freq) / (330 * 330);
-  }
-  return result;
+  // 4096 / ratio, where ratio = toneVolumes[2+volume] * min(freq, 330)^2 / 330^2
+  uint32_t result;
+  if (freq == 0)
+    return 0;
+  else if (freq < 330)
+    result = (4096 * 330 * 330) / (toneVolumes[2+volume] * freq * freq);
+  else
+    result = 4096 / toneVolumes[2+volume];
+  return min<uint32_t>(result, (32767 * 4096) / 16000);
+}
+
+#define SINE_TABLE_BITS  10
+#define TONE_PHASE_SHIFT (32 - SINE_TABLE_BITS)
+
+// the phase indexes sineValues[] with its SINE_TABLE_BITS upper bits
+// (a negative array size, as static_assert is not available in C++98)
+typedef char sineTableSizeCheck[DIM(sineValues) == (1 << SINE_TABLE_BITS) ? 1 : -1];
+
+inline uint32_t toneFreqToPhaseIncr(uint16_t freq)
+{
+  return (uint64_t(freq) << 32) / AUDIO_SAMPLE_RATE;
 }
 
 int ToneContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
@@ -622,7 +638,9 @@ int ToneContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
   int remainingDuration = fragment.tone.duration - state.duration;
   if (remainingDuration > 0) {
     int points;
-    double toneIdx = state.idx;
+    uint32_t phase = state.phase;
+    uint32_t phaseIncr = state.phaseIncr;
+    int32_t phaseIncrStep = 0;
 
     if (fragment.tone.reset) {
       fragment.tone.reset = 0;
@@ -630,42 +648,54 @@ int ToneContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
       state.pause = 0;
     }
 
+    if (remainingDuration > AUDIO_BUFFER_DURATION) {
+      duration = AUDIO_BUFFER_DURATION;
+      points = AUDIO_BUFFER_SIZE;
+    }
+    else {
+      duration = remainingDuration;
+      points = (duration * AUDIO_BUFFER_SIZE) / AUDIO_BUFFER_DURATION;
+    }
+
     if (fragment.tone.freq != state.freq) {
+      uint32_t target = toneFreqToPhaseIncr(fragment.tone.freq);
+      if (state.freq == 0 || remainingDuration <= AUDIO_BUFFER_DURATION) {
+        phaseIncr = target;
+      }
+      else {
+        // glide to the new frequency along the buffer instead of jumping
+        phaseIncrStep = (int32_t(target) - int32_t(phaseIncr)) / AUDIO_BUFFER_SIZE;
+      }
       state.freq = fragment.tone.freq;
-      state.step = double(DIM(sineValues)*fragment.tone.freq) / AUDIO_SAMPLE_RATE;
-      state.volume = evalVolumeRatio(fragment.tone.freq, volume);
+      state.phaseIncr = target;
+      state.volume = evalVolumeScale(fragment.tone.freq, volume);
     }
 
     if (fragment.tone.freqIncr) {
       fragment.tone.freq += AUDIO_BUFFER_DURATION * fragment.tone.freqIncr;
     }
 
-    if (remainingDuration > AUDIO_BUFFER_DURATION) {
-      duration = AUDIO_BUFFER_DURATION;
-      points = AUDIO_BUFFER_SIZE;
-    }
-    else {
-      duration = remainingDuration;
-      points = (duration * AUDIO_BUFFER_SIZE) / AUDIO_BUFFER_DURATION;
-      unsigned int end = toneIdx + (state.step * points);
-      if (end > DIM(sineValues))
-        end -= (end % DIM(sineValues));
+    if (remainingDuration <= AUDIO_BUFFER_DURATION && phaseIncr) {
+      // end the tone on a whole sine period
+      uint64_t end = phase + uint64_t(phaseIncr) * points;
+      if (end > (uint64_t(1) << 32))
+        end &= ~uint64_t(0xFFFFFFFF);
       else
-        end = DIM(sineValues);
-      points = (double(end) - toneIdx) / state.step;
+        end = uint64_t(1) << 32;
+      points = min<uint64_t>((end - phase) / phaseIncr, AUDIO_BUFFER_SIZE);
     }
 
+    uint16_t * samples = buffer->data;
+    int32_t scale = state.volume;
     for (int i=0; i<points; i++) {
-      int16_t sample = sineValues[int(toneIdx)] / state.volume;
-      mixSample(&buffer->data[i], sample, fade);
-      toneIdx += state.step;
-      if ((unsigned int)toneIdx >= DIM(sineValues))
-        toneIdx -= DIM(sineValues);
+      mixSample(samples++, (sineValues[phase >> TONE_PHASE_SHIFT] * scale) >> 12, fade);
+      phase += phaseIncr;
+      phaseIncr += phaseIncrStep;
     }
 
     if (remainingDuration > AUDIO_BUFFER_DURATION) {
       state.duration += AUDIO_BUFFER_DURATION;
-      state.idx = toneIdx;
+      state.phase = phase;
       return AUDIO_BUFFER_SIZE;
     }
     else {
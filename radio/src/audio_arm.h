@@ -91,14 +91,16 @@ struct AudioFragment {
   }
 };
 
+extern const int16_t sineValues[];
+
 class ToneContext {
   public:
     AudioFragment fragment;
 
     struct {
-      double step;
-      double idx;
-      float  volume;
+      uint32_t phase;      // sine table position, 1024 entries in 32 bits
+      uint32_t phaseIncr;  // phase step per sample
+      uint16_t volume;     // sample scale, 4096 = 1.0
       uint16_t freq;
       uint16_t duration;
       uint16_t pause;
@@ -0,0 +1,177 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <string.h>
+#include "benchmarks.h"
+
+// Each benchmark is run for at least this duration
+#define BENCHMARK_MIN_DURATION_NS  200000000LL
+#define BENCHMARK_MAX_ITEMS        4
+
+static Benchmark * benchmarks = NULL;
+static Benchmark ** benchmarksTail = &benchmarks;
+
+static struct {
+  const char * unit;
+  uint32_t count;
+} benchmarkItemsList[BENCHMARK_MAX_ITEMS];
+static int benchmarkItemsCount = 0;
+
+void benchmarkItems(const char * unit, uint32_t count)
+{
+  for (int i=0; i<benchmarkItemsCount; i++) {
+    if (!strcmp(benchmarkItemsList[i].unit, unit)) {
+      benchmarkItemsList[i].count = count;
+      return;
+    }
+  }
+  if (benchmarkItemsCount < BENCHMARK_MAX_ITEMS) {
+    benchmarkItemsList[benchmarkItemsCount].unit = unit;
+    benchmarkItemsList[benchmarkItemsCount].count = count;
+    benchmarkItemsCount++;
+  }
+}
+
+Benchmark::Benchmark(const char * group, const char * name, void (*setup)(), void (*run)()):
+  group(group),
+  name(name),
+  setup(setup),
+  run(run),
+  next(NULL)
+{
+  *benchmarksTail = this;
+  benchmarksTail = &next;
+}
+
+int32_t lastAct = 0;
+uint16_t anaInValues[NUM_STICKS+NUM_POTS] = { 0 };
+uint16_t anaIn(uint8_t chan)
+{
+  if (chan < NUM_STICKS+NUM_POTS)
+    return anaInValues[chan];
+  else
+    return 0;
+}
+
+// The heap allocations are counted by wrapping the C library allocator (new
+// uses it too), nothing in the 10ms cycle is expected to allocate
+#if defined(__GLIBC__)
+extern "C" void * __libc_malloc(size_t size);
+extern "C" void * __libc_calloc(size_t count, size_t size);
+extern "C" void * __libc_realloc(void * ptr, size_t size);
+
+static uint32_t benchmarkAllocations = 0;
+
+extern "C" void * malloc(size_t size)
+{
+  benchmarkAllocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void * calloc(size_t count, size_t size)
+{
+  benchmarkAllocations++;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void * realloc(void * ptr, size_t size)
+{
+  benchmarkAllocations++;
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+static int64_t getTimeNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t runBenchmark(Benchmark * benchmark, uint32_t iterations, uint32_t & allocations)
+{
+  if (benchmark->setup) {
+    benchmark->setup();
+  }
+#if defined(__GLIBC__)
+  uint32_t allocationsStart = benchmarkAllocations;
+#endif
+  int64_t start = getTimeNs();
+  for (uint32_t i=0; i<iterations; i++) {
+    benchmark->run();
+  }
+  int64_t duration = getTimeNs() - start;
+#if defined(__GLIBC__)
+  allocations = benchmarkAllocations - allocationsStart;
+#else
+  allocations = 0;
+#endif
+  return duration;
+}
+
+// Output is one line per benchmark: "<group>.<name> <iterations> <ns/op>
+// allocs/op=<allocations>", followed by "<unit>/s=<rate>" for each
+// benchmarkItems() declared. allocs/op is always 0 without glibc.
+int main(int argc, char **argv)
+{
+  const char * filter = (argc > 1 ? argv[1] : NULL);
+
+  g_menuStackPtr = 0;
+  g_menuStack[0] = menuMainView;
+
+  for (Benchmark * benchmark=benchmarks; benchmark; benchmark=benchmark->next) {
+    char fullname[64];
+    snprintf(fullname, sizeof(fullname), "%s.%s", benchmark->group, benchmark->name);
+    if (filter && !strstr(fullname, filter)) {
+      continue;
+    }
+    uint32_t iterations = 1;
+    uint32_t allocations;
+    int64_t duration;
+    benchmarkItemsCount = 0;
+    while ((duration = runBenchmark(benchmark, iterations, allocations)) < BENCHMARK_MIN_DURATION_NS && iterations < 0x40000000) {
+      iterations *= (duration < BENCHMARK_MIN_DURATION_NS / 100 ? 10 : 2);
+    }
+    printf("%s %u %.1f allocs/op=%g", fullname, iterations, (double)duration / iterations, (double)allocations / iterations);
+    for (int i=0; i<benchmarkItemsCount; i++) {
+      printf(" %s/s=%.0f", benchmarkItemsList[i].unit, (double)benchmarkItemsList[i].count * iterations * 1e9 / duration);
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+
+  return 0;
+}
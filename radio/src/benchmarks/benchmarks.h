@@ -0,0 +1,71 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef __BENCHMARKS_H
+#define __BENCHMARKS_H
+
+#include <stdio.h>
+#include <time.h>
+
+#define SWAP_DEFINED
+#include "opentx.h"
+
+struct Benchmark
+{
+  const char * group;
+  const char * name;
+  void (*setup)();
+  void (*run)();
+  Benchmark * next;
+
+  Benchmark(const char * group, const char * name, void (*setup)(), void (*run)());
+};
+
+extern uint16_t anaInValues[NUM_STICKS+NUM_POTS];
+
+// benchmarkItems(unit, count), called from setup, declares that one operation
+// processes count items (bytes, packets...), they are reported as unit/s.
+void benchmarkItems(const char * unit, uint32_t count);
+
+// BENCHMARK(group, name, setup) { ... } declares the operation to be timed,
+// it is run in a loop and reported in ns/op. setup (may be NULL) is called
+// once before each timed loop.
+#define BENCHMARK(group, name, setup) \
+  static void benchmark_run_##group##_##name(); \
+  static Benchmark benchmark_##group##_##name(#group, #name, setup, benchmark_run_##group##_##name); \
+  static void benchmark_run_##group##_##name()
+
+#endif
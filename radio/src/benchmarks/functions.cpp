@@ -0,0 +1,67 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "benchmarks.h"
+
+#if defined(CPUARM)
+
+// A competition model: every function slot used, most of them on logical
+// switches which are off, a few on the switch used for the launch mode.
+static void functionsSetup()
+{
+  memclear(&g_model, sizeof(g_model));
+  customFunctionsReset();
+  for (uint8_t i=0; i<NUM_CFN; i++) {
+    CustomFunctionData * cfn = &g_model.customFn[i];
+    if (i % 8 == 0) {
+      CFN_SWITCH(cfn) = SWSRC_ON;
+      CFN_FUNC(cfn) = FUNC_BACKLIGHT;
+    }
+    else {
+      CFN_SWITCH(cfn) = SWSRC_FIRST_LOGICAL_SWITCH + (i % NUM_LOGICAL_SWITCH);
+      CFN_FUNC(cfn) = (i % 2 ? FUNC_RESET : FUNC_TRAINER);
+      CFN_ACTIVE(cfn) = 1;
+    }
+  }
+  benchmarkItems("functions", NUM_CFN);
+}
+
+// One 10ms cycle with the model functions
+BENCHMARK(functions, eval, functionsSetup)
+{
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+}
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "benchmarks.h"
+
+static void lcdSetup()
+{
+  lcd_clear();
+}
+
+BENCHMARK(lcd, putsStdSize, lcdSetup)
+{
+  lcd_putsAtt(0, 0, "The quick brown fox", 0);
+}
+
+BENCHMARK(lcd, putsInvers, lcdSetup)
+{
+  lcd_putsAtt(0, FH, "The quick brown fox", INVERS);
+}
+
+BENCHMARK(lcd, putsCondensed, lcdSetup)
+{
+  lcd_putsAtt(0, 2*FH+3, "ABCDEFGHIJKLMNOP", CONDENSED);
+}
+
+#if defined(CPUARM)
+BENCHMARK(lcd, putsSmlSize, lcdSetup)
+{
+  lcd_putsAtt(0, 3*FH, "The quick brown fox", SMLSIZE);
+}
+
+BENCHMARK(lcd, putsMidSize, lcdSetup)
+{
+  lcd_putsAtt(0, 4*FH, "12:34.5", MIDSIZE|INVERS);
+}
+
+BENCHMARK(lcd, putsDblSize, lcdSetup)
+{
+  lcd_putsAtt(0, 5*FH+1, "ABC123", DBLSIZE);
+}
+
+BENCHMARK(lcd, outdezXxlSize, lcdSetup)
+{
+  lcd_outdezAtt(LCD_W, 2*FH, 1234, XXLSIZE);
+}
+#endif
+
+BENCHMARK(lcd, outdezPrec1, lcdSetup)
+{
+  lcd_outdezAtt(LCD_W/2, 6*FH, -1234, PREC1);
+}
+
+BENCHMARK(lcd, filledRectSolid, lcdSetup)
+{
+  lcd_filled_rect(0, FH, LCD_W, FH);
+}
+
+BENCHMARK(lcd, filledRectDotted, lcdSetup)
+{
+  lcd_filled_rect(10, 2*FH+1, LCD_W-20, 3*FH, DOTTED);
+}
+
+BENCHMARK(lcd, hline, lcdSetup)
+{
+  lcd_hline(0, 5*FH+3, LCD_W);
+}
+
+BENCHMARK(lcd, vline, lcdSetup)
+{
+  lcd_vline(LCD_W/2, 0, LCD_H);
+}
+
+#if defined(PCBTARANIS)
+BENCHMARK(lcd, titleBar, lcdSetup)
+{
+  lcd_filled_rect(0, 0, LCD_W, FH, SOLID, FILL_WHITE|GREY_DEFAULT);
+}
+
+BENCHMARK(lcd, gauge, lcdSetup)
+{
+  lcd_filled_rect(50, 6*FH, 80, 6, SOLID, FORCE|GREY(12)|ROUND);
+}
+#endif
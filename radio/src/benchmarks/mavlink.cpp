@@ -0,0 +1,133 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#include "benchmarks.h"
+
+#if defined(MAVLINK)
+
+extern void MAVLINK_rxhandler(uint8_t byte);
+
+static uint8_t * mavlinkStream = NULL;
+static uint32_t mavlinkStreamLen = 0;
+static uint32_t mavlinkStreamFrames = 0;
+
+static void mavlinkAppend(const mavlink_message_t & msg)
+{
+  mavlinkStreamLen += mavlink_msg_to_send_buffer(&mavlinkStream[mavlinkStreamLen], &msg);
+}
+
+// 10s of an ArduCopter stream with the usual rates (SR0_* parameters)
+static void mavlinkBuildStream()
+{
+  mavlinkStream = (uint8_t *)malloc(64*1024);
+  mavlink_message_t msg;
+  for (int tick=0; tick<100; tick++) {
+    mavlink_msg_attitude_pack(1, 1, &msg, tick*100, 0.1, -0.2, 1.5, 0.01, 0.02, 0.03);
+    mavlinkAppend(msg);
+    if (tick % 2 == 0) {
+      mavlink_msg_gps_raw_int_pack(1, 1, &msg, tick*100000, 3, 457000000+tick, 67000000-tick, 512000, 150, 200, 1234, 9000, 11);
+      mavlinkAppend(msg);
+      mavlink_msg_vfr_hud_pack(1, 1, &msg, 10.0, 12.0, 270, 50, 123.0, 0.5);
+      mavlinkAppend(msg);
+      mavlink_msg_rc_channels_raw_pack(1, 1, &msg, tick*100, 0, 1500, 1500, 1100, 1500, 1900, 1000, 1500, 1500, 200);
+      mavlinkAppend(msg);
+      mavlink_msg_nav_controller_output_pack(1, 1, &msg, 0.1, 0.2, 270, 280, 100, 1.0, 0.5, 0.0);
+      mavlinkAppend(msg);
+    }
+    if (tick % 5 == 0) {
+      mavlink_msg_sys_status_pack(1, 1, &msg, 0, 0, 0, 500, 12600, 1530, 87, 0, 0, 0, 0, 0, 0);
+      mavlinkAppend(msg);
+    }
+    if (tick % 10 == 0) {
+      mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_MODE_FLAG_SAFETY_ARMED, 5, MAV_STATE_ACTIVE);
+      mavlinkAppend(msg);
+      mavlink_msg_radio_status_pack(51, 68, &msg, 200, 190, 100, 20, 25, 3, 1);
+      mavlinkAppend(msg);
+    }
+  }
+}
+
+// A capture can be replayed instead, MAVLINK_CAPTURE=file (raw stream or
+// .tlog, the timestamps in front of the frames are skipped by the parser)
+static void mavlinkLoadCapture(const char * filename)
+{
+  FILE * file = fopen(filename, "rb");
+  if (!file) {
+    fprintf(stderr, "Cannot open %s\n", filename);
+    exit(1);
+  }
+  fseek(file, 0, SEEK_END);
+  mavlinkStreamLen = ftell(file);
+  rewind(file);
+  mavlinkStream = (uint8_t *)malloc(mavlinkStreamLen);
+  if (fread(mavlinkStream, 1, mavlinkStreamLen, file) != mavlinkStreamLen) {
+    exit(1);
+  }
+  fclose(file);
+}
+
+static void mavlinkSetup()
+{
+  if (!mavlinkStream) {
+    const char * capture = getenv("MAVLINK_CAPTURE");
+    if (capture)
+      mavlinkLoadCapture(capture);
+    else
+      mavlinkBuildStream();
+    MAVLINK_Init();
+    MAVLINK_parse(mavlinkStream, mavlinkStreamLen);
+    mavlinkStreamFrames = mavlinkStats.frames;
+  }
+  MAVLINK_Init();
+  benchmarkItems("bytes", mavlinkStreamLen);
+  benchmarkItems("frames", mavlinkStreamFrames);
+}
+
+// Whole stream at once
+BENCHMARK(mavlink, parseStream, mavlinkSetup)
+{
+  MAVLINK_parse(mavlinkStream, mavlinkStreamLen);
+}
+
+// One byte at a time, as from the serial interrupt
+BENCHMARK(mavlink, parseBytes, mavlinkSetup)
+{
+  for (uint32_t i=0; i<mavlinkStreamLen; i++) {
+    MAVLINK_rxhandler(mavlinkStream[i]);
+  }
+}
+#endif
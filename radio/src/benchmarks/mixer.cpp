@@ -0,0 +1,389 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+#include "benchmarks.h"
+
+#if defined(CPUARM)
+
+#if defined(PCBTARANIS)
+  #define BENCHMARK_SWITCHES  NUM_SW_SRCRAW
+#else
+  #define BENCHMARK_SWITCHES  NUM_SWITCHES
+#endif
+
+static volatile int32_t mixerSink;
+static uint16_t mixerTick;
+
+static void mixerSetCurves()
+{
+#if defined(PCBTARANIS)
+  // 15 points standard curves and 8 points custom ones, 464 of the NUM_POINTS
+  for (uint8_t c=0; c<MAX_CURVES; c++) {
+    CurveInfo & curve = g_model.curves[c];
+    curve.type = (c & 1 ? CURVE_TYPE_CUSTOM : CURVE_TYPE_STANDARD);
+    curve.smooth = (c & 2 ? 1 : 0);
+    curve.points = (c & 1 ? 8 : 15) - 5;
+  }
+  loadCurves();
+  for (uint8_t c=0; c<MAX_CURVES; c++) {
+    int8_t * points = curveAddress(c);
+    int count = 5 + g_model.curves[c].points;
+    for (int i=0; i<count; i++) {
+      points[i] = (i * 37 + c * 11) % 201 - 100;
+    }
+    if (g_model.curves[c].type == CURVE_TYPE_CUSTOM) {
+      for (int i=1; i<count-1; i++) {
+        points[count+i-1] = -100 + 200 * i / (count - 1);
+      }
+    }
+  }
+#else
+  for (uint8_t c=0; c<MAX_CURVES; c++) {
+    int8_t * points = curveAddress(c);
+    for (int i=0; i<5; i++) {
+      points[i] = (i * 37 + c * 11) % 201 - 100;
+    }
+  }
+#endif
+}
+
+static void mixerSetInputs()
+{
+#if defined(PCBTARANIS)
+  // two lines per input, the first one on a logical switch
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * expo = expoAddress(i);
+    uint8_t input = i / 2;
+    expo->srcRaw = MIXSRC_Rud + input % (NUM_STICKS+NUM_POTS);
+    expo->chn = input;
+    expo->mode = 3;
+    expo->weight = (i & 1 ? 100 : 70);
+    expo->offset = (i % 3) - 1;
+    if (!(i & 1)) {
+      expo->swtch = SWSRC_FIRST_LOGICAL_SWITCH + input % NUM_LOGICAL_SWITCH;
+    }
+    expo->curve.type = i % 4;
+    expo->curve.value = (expo->curve.type == CURVE_REF_FUNC ? 1 + i % (CURVE_BASE-1) : (expo->curve.type == CURVE_REF_CUSTOM ? 1 + i % MAX_CURVES : 30));
+  }
+#else
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * expo = expoAddress(i);
+    expo->chn = (i * NUM_STICKS) / MAX_EXPOS;
+    expo->mode = 3;
+    expo->weight = (i & 1 ? 100 : 70);
+    if (!(i & 1)) {
+      expo->swtch = SWSRC_FIRST_LOGICAL_SWITCH + i % NUM_LOGICAL_SWITCH;
+    }
+    expo->curveMode = i % 2;
+    expo->curveParam = (expo->curveMode ? CURVE_BASE + i % MAX_CURVES : 30);
+  }
+#endif
+}
+
+static void mixerSetMixes()
+{
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * mix = mixAddress(i);
+    mix->destCh = (i * NUM_CHNOUT) / MAX_MIXERS;
+    if (i % 4 == 3) {
+      mix->srcRaw = MIXSRC_CH1 + (mix->destCh + 1) % NUM_CHNOUT; // the next channel, one more pass
+    }
+    else if (i % 8 == 6) {
+      mix->srcRaw = MIXSRC_MAX;
+    }
+    else {
+#if defined(PCBTARANIS)
+      mix->srcRaw = MIXSRC_FIRST_INPUT + i % MAX_INPUTS;
+#else
+      mix->srcRaw = MIXSRC_Rud + i % (NUM_STICKS+NUM_POTS);
+#endif
+    }
+    mix->weight = 50 + i % 51;
+    mix->offset = (i % 5) - 2;
+    mix->mltpx = (i % 5 == 4 ? MLTPX_MUL : MLTPX_ADD);
+    mix->flightModes = (i % 7 == 0 ? 0x02 : 0);
+    if (i & 1) {
+      mix->swtch = SWSRC_FIRST_LOGICAL_SWITCH + i % NUM_LOGICAL_SWITCH;
+    }
+    if (i % 3 == 0) {
+      mix->delayUp = mix->delayDown = 5;
+      mix->speedUp = mix->speedDown = 20;
+    }
+#if defined(PCBTARANIS)
+    mix->curve.type = CURVE_REF_CUSTOM;
+    mix->curve.value = 1 + i % MAX_CURVES;
+#else
+    mix->curveMode = MODE_CURVE;
+    mix->curveParam = CURVE_BASE + i % MAX_CURVES;
+#endif
+  }
+}
+
+static void mixerSetLogicalSwitches()
+{
+  static const uint8_t functions[] = {
+    LS_FUNC_VPOS, LS_FUNC_VNEG, LS_FUNC_APOS, LS_FUNC_AND, LS_FUNC_OR, LS_FUNC_XOR,
+    LS_FUNC_EDGE, LS_FUNC_GREATER, LS_FUNC_DIFFEGREATER, LS_FUNC_TIMER, LS_FUNC_STICKY
+  };
+
+  for (uint8_t i=0; i<NUM_LOGICAL_SWITCH; i++) {
+    LogicalSwitchData * ls = lswAddress(i);
+    ls->func = functions[i % DIM(functions)];
+    switch (lswFamily(ls->func)) {
+      case LS_FAMILY_BOOL:
+      case LS_FAMILY_STICKY:
+      case LS_FAMILY_EDGE:
+        ls->v1 = SWSRC_FIRST_SWITCH + i % (SWSRC_LAST_SWITCH-SWSRC_FIRST_SWITCH+1);
+        ls->v2 = SWSRC_FIRST_SWITCH + (i * 7) % (SWSRC_LAST_SWITCH-SWSRC_FIRST_SWITCH+1);
+        break;
+      case LS_FAMILY_TIMER:
+        ls->v1 = ls->v2 = i % 5;
+        break;
+      case LS_FAMILY_COMP:
+        ls->v1 = MIXSRC_Rud + i % NUM_STICKS;
+        ls->v2 = MIXSRC_Rud + (i + 1) % NUM_STICKS;
+        break;
+      default:
+        ls->v1 = MIXSRC_Rud + i % (NUM_STICKS+NUM_POTS);
+        ls->v2 = (i * 13) % 100 - 50;
+        break;
+    }
+    if (i > 0 && i % 4 == 0) {
+      ls->andsw = SWSRC_FIRST_LOGICAL_SWITCH + i - 1;
+    }
+    if (i % 6 == 0) {
+      ls->delay = 2;
+      ls->duration = 5;
+    }
+  }
+}
+
+// The sticks, pots and switches keep moving, the flight modes change every
+// 50 ticks with 25s fades so that several of them are always fading
+static void mixerMoveInputs()
+{
+  mixerTick++;
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    int16_t p = (mixerTick * (7 + i)) % 4096;
+    anaInValues[i] = (p < 2048 ? p : 4096 - p) - 1024;
+  }
+  if (mixerTick % 50 == 0) {
+    for (uint8_t i=0; i<BENCHMARK_SWITCHES; i++) {
+      simuSetSwitch(i, (mixerTick / 50 + i) % 3 - 1);
+    }
+  }
+}
+
+// The worst case model: every mix, input, curve and logical switch slot
+// used, and all the flight modes with the longest fades
+static void mixerSetup()
+{
+  memclear(&g_model, sizeof(g_model));
+  mixerSetCurves();
+  mixerSetInputs();
+  mixerSetMixes();
+  mixerSetLogicalSwitches();
+
+  for (uint8_t p=1; p<MAX_FLIGHT_MODES; p++) {
+    FlightModeData * fm = flightModeAddress(p);
+    fm->swtch = SWSRC_FIRST_SWITCH + 2*p;
+    fm->fadeIn = fm->fadeOut = 250;
+  }
+
+  for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+    LimitData * limit = limitAddress(ch);
+    limit->offset = (ch * 37) % 201 - 100;
+    limit->min = -(ch % 20);
+    limit->max = ch % 20;
+    limit->ppmCenter = ch % 50 - 25;
+    limit->symetrical = ch & 1;
+    limit->revert = (ch % 3 == 0);
+#if defined(PCBTARANIS)
+    limit->curve = (ch % 4 == 0 ? 1 + ch % MAX_CURVES : 0);
+#endif
+  }
+
+  memclear(act, sizeof(act));
+  memclear(swOn, sizeof(swOn));
+  mixerCurrentFlightMode = 0;
+  lastFlightMode = 255;
+  logicalSwitchesReset();
+  INVALIDATE_MODEL_CACHES();
+
+  // the first cycles build the caches and start the fades
+  mixerTick = 0;
+  for (int i=0; i<100; i++) {
+    mixerMoveInputs();
+    g_tmr10ms++;
+    doMixerCalculations();
+  }
+}
+
+// One 10ms cycle
+BENCHMARK(mixer, doMixerCalculations, mixerSetup)
+{
+  mixerMoveInputs();
+  g_tmr10ms++;
+  doMixerCalculations();
+}
+
+BENCHMARK(mixer, evalFlightModeMixes, mixerSetup)
+{
+  mixerMoveInputs();
+  evalFlightModeMixes(mixerTick % MAX_FLIGHT_MODES, 1);
+}
+
+BENCHMARK(mixer, applyExpos, mixerSetup)
+{
+  mixerMoveInputs();
+  applyExpos(anas, e_perout_mode_normal);
+}
+
+#define GETVALUE_BENCHMARK(name, first, last) \
+  static void getValueSetup_##name() \
+  { \
+    mixerSetup(); \
+    benchmarkItems("sources", (last)-(first)+1); \
+  } \
+  BENCHMARK(getValue, name, getValueSetup_##name) \
+  { \
+    for (int i=(first); i<=(last); i++) { \
+      mixerSink += getValue(i); \
+    } \
+  }
+
+#if defined(PCBTARANIS)
+GETVALUE_BENCHMARK(inputs, MIXSRC_FIRST_INPUT, MIXSRC_LAST_INPUT)
+GETVALUE_BENCHMARK(scripts, MIXSRC_FIRST_LUA, MIXSRC_LAST_LUA)
+#endif
+GETVALUE_BENCHMARK(sticks, MIXSRC_Rud, MIXSRC_LAST_POT)
+GETVALUE_BENCHMARK(max, MIXSRC_MAX, MIXSRC_MAX)
+GETVALUE_BENCHMARK(trims, MIXSRC_TrimRud, MIXSRC_TrimAil)
+GETVALUE_BENCHMARK(switches, MIXSRC_TrimAil+1, MIXSRC_FIRST_LOGICAL_SWITCH-1)
+GETVALUE_BENCHMARK(logicalSwitches, MIXSRC_FIRST_LOGICAL_SWITCH, MIXSRC_LAST_LOGICAL_SWITCH)
+GETVALUE_BENCHMARK(trainer, MIXSRC_FIRST_TRAINER, MIXSRC_LAST_TRAINER)
+GETVALUE_BENCHMARK(channels, MIXSRC_CH1, MIXSRC_LAST_CH)
+#if defined(GVARS)
+GETVALUE_BENCHMARK(gvars, MIXSRC_FIRST_GVAR, MIXSRC_LAST_GVAR)
+#endif
+GETVALUE_BENCHMARK(timers, MIXSRC_FIRST_TIMER, MIXSRC_LAST_TIMER)
+GETVALUE_BENCHMARK(telemetry, MIXSRC_FIRST_TELEM, MIXSRC_LAST_TELEM)
+
+static void switchesSetup()
+{
+  mixerSetup();
+  benchmarkItems("switches", SWSRC_LAST - SWSRC_FIRST + 1);
+}
+
+// Every switch source, in both directions
+BENCHMARK(switches, getSwitch, switchesSetup)
+{
+  for (int i=SWSRC_FIRST; i<=SWSRC_LAST; i++) {
+    mixerSink += getSwitch(mixerTick & 1 ? i : -i);
+  }
+  mixerTick++;
+}
+
+static void logicalSwitchesSetup()
+{
+  mixerSetup();
+  benchmarkItems("switches", NUM_LOGICAL_SWITCH);
+}
+
+BENCHMARK(switches, evalLogicalSwitches, logicalSwitchesSetup)
+{
+  mixerMoveInputs();
+  evalLogicalSwitches();
+}
+
+#if defined(PCBTARANIS)
+static CurveRef curveRef;
+
+#define CURVE_BENCHMARK(name, refType, count) \
+  static void curvesSetup_##name() \
+  { \
+    mixerSetup(); \
+    curveRef.type = refType; \
+    benchmarkItems("points", count); \
+  } \
+  BENCHMARK(curves, name, curvesSetup_##name) \
+  { \
+    for (int i=0; i<(count); i++) { \
+      curveRef.value = (refType == CURVE_REF_CUSTOM ? 1 + i % MAX_CURVES : (refType == CURVE_REF_FUNC ? 1 + i % (CURVE_BASE-1) : 1 + i % 100)); \
+      mixerSink += applyCurve(i * 2048 / (count) - 1024, curveRef); \
+    } \
+  }
+
+CURVE_BENCHMARK(diff, CURVE_REF_DIFF, 64)
+CURVE_BENCHMARK(expo, CURVE_REF_EXPO, 64)
+CURVE_BENCHMARK(func, CURVE_REF_FUNC, 64)
+CURVE_BENCHMARK(custom, CURVE_REF_CUSTOM, 64)
+#else
+static void curvesSetup()
+{
+  mixerSetup();
+  benchmarkItems("points", 64);
+}
+
+BENCHMARK(curves, custom, curvesSetup)
+{
+  for (int i=0; i<64; i++) {
+    mixerSink += applyCurve(i * 32 - 1024, CURVE_BASE + i % MAX_CURVES);
+  }
+}
+#endif
+
+static void limitsSetup()
+{
+  mixerSetup();
+  benchmarkItems("channels", NUM_CHNOUT);
+}
+
+// The channel limits, as computed from the model and as compiled
+BENCHMARK(limits, applyLimits, limitsSetup)
+{
+  for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+    mixerSink += applyLimits(ch, chans[ch]);
+  }
+}
+
+BENCHMARK(limits, applyOutputStage, limitsSetup)
+{
+  for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+    mixerSink += applyOutputStage(ch, chans[ch]);
+  }
+}
+
+#endif
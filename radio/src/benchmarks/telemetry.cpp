@@ -0,0 +1,292 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#include "benchmarks.h"
+
+#if defined(CPUARM) && defined(FRSKY_SPORT)
+
+extern uint8_t telemetryProtocol;
+
+// A dense S.Port sensor chain, one packet every 12ms as polled by the receiver
+struct SportSample {
+  uint8_t  physicalId;
+  uint16_t appId;
+  uint32_t data;
+};
+
+#define CELLS(count, index, v1, v2)  ((uint32_t)(index) | ((uint32_t)(count)<<4) | (((uint32_t)(v1)*5)<<8) | (((uint32_t)(v2)*5)<<20))
+
+static const SportSample sportChain[] = {
+  { 0x98, RSSI_ID, 87 },
+  { 0xA1, CELLS_FIRST_ID, CELLS(6, 0, 412, 407) },
+  { 0xA1, CELLS_FIRST_ID, CELLS(6, 2, 398, 410) },
+  { 0xA1, CELLS_FIRST_ID, CELLS(6, 4, 405, 409) },
+  { 0x22, VFAS_FIRST_ID, 2431 },
+  { 0x22, CURR_FIRST_ID, 125 },
+  { 0x00, ALT_FIRST_ID, 12345 },
+  { 0x00, VARIO_FIRST_ID, 126 },
+  { 0x83, RPM_FIRST_ID, 0x7E7E },
+  { 0x83, T1_FIRST_ID, 45 },
+  { 0x83, T2_FIRST_ID, 52 },
+  { 0x83, FUEL_FIRST_ID, 75 },
+  { 0x67, ACCX_FIRST_ID, 12 },
+  { 0x67, ACCY_FIRST_ID, 0x7D },
+  { 0x67, ACCZ_FIRST_ID, 980 },
+  { 0x83, GPS_ALT_FIRST_ID, 12500 },
+  { 0x83, GPS_SPEED_FIRST_ID, 23000 },
+};
+
+#define SPORT_CHAIN_PERIOD       12 /*ms*/
+#define SPORT_CAPTURE_CYCLES     50
+
+static uint8_t sportPackets[DIM(sportChain)][FRSKY_SPORT_PACKET_SIZE];
+static FILE * sportCapture = NULL;
+static uint32_t sportCaptureBytes = 0;
+
+static void sportBuildPacket(uint8_t * packet, const SportSample & sample)
+{
+  packet[0] = sample.physicalId;
+  packet[1] = DATA_FRAME;
+  packet[2] = sample.appId & 0xFF;
+  packet[3] = sample.appId >> 8;
+  for (int i=0; i<4; i++) {
+    packet[4+i] = sample.data >> (8*i);
+  }
+  uint16_t crc = 0;
+  for (int i=1; i<FRSKY_SPORT_PACKET_SIZE-1; i++) {
+    crc += packet[i];
+    crc += crc >> 8;
+    crc &= 0x00ff;
+  }
+  packet[FRSKY_SPORT_PACKET_SIZE-1] = 0xFF - crc;
+}
+
+// The capture is written in the SPORT_FILE_LOG format and replayed from a temporary file
+static void sportCaptureCreate()
+{
+  if (sportCapture)
+    return;
+
+  sportCapture = tmpfile();
+  for (unsigned int i=0; i<DIM(sportChain); i++) {
+    sportBuildPacket(sportPackets[i], sportChain[i]);
+  }
+
+  uint32_t time = 0;
+  for (int cycle=0; cycle<SPORT_CAPTURE_CYCLES; cycle++) {
+    for (unsigned int i=0; i<DIM(sportChain); i++) {
+      fprintf(sportCapture, "\r\n2014-09-21,%02d:%02d:%02d.%03d: 7E", 12, time/60000, (time/1000)%60, time%1000);
+      sportCaptureBytes++;
+      for (int j=0; j<FRSKY_SPORT_PACKET_SIZE; j++) {
+        uint8_t byte = sportPackets[i][j];
+        if (j > 0 && (byte == START_STOP || byte == BYTESTUFF)) {
+          fprintf(sportCapture, " %02X", BYTESTUFF);
+          byte ^= STUFF_MASK;
+          sportCaptureBytes++;
+        }
+        fprintf(sportCapture, " %02X", byte);
+        sportCaptureBytes++;
+      }
+      time += SPORT_CHAIN_PERIOD;
+    }
+  }
+  fflush(sportCapture);
+}
+
+static int findSensor(uint16_t id)
+{
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    if (g_model.telemetrySensors[i].type == TELEM_TYPE_CUSTOM && g_model.telemetrySensors[i].id == id)
+      return i;
+  }
+  return -1;
+}
+
+static int addCalculatedSensor(uint8_t formula, int8_t source1, int8_t source2, uint8_t cellIndex=0)
+{
+  int index = availableTelemetryIndex();
+  if (index < 0)
+    return 0;
+  TelemetrySensor & sensor = g_model.telemetrySensors[index];
+  sensor.init("CALC");
+  sensor.type = TELEM_TYPE_CALCULATED;
+  sensor.formula = formula;
+  if (formula == TELEM_FORMULA_CELL) {
+    sensor.cell.source = source1;
+    sensor.cell.index = cellIndex;
+  }
+  else {
+    sensor.calc.sources[0] = source1;
+    sensor.calc.sources[1] = source2;
+  }
+  return index + 1;
+}
+
+// Sensors discovered from the capture, plus calculated sensors on top of them
+static void telemetrySetup()
+{
+  sportCaptureCreate();
+  memclear(&g_model, sizeof(g_model));
+  telemetryReset();
+  telemetryProtocol = MODEL_TELEMETRY_PROTOCOL();
+
+  for (unsigned int i=0; i<DIM(sportChain); i++) {
+    processSportPacket(sportPackets[i]);
+  }
+
+  int cells = findSensor(CELLS_FIRST_ID) + 1;
+  int vfas = findSensor(VFAS_FIRST_ID) + 1;
+  int curr = findSensor(CURR_FIRST_ID) + 1;
+  int t1 = findSensor(T1_FIRST_ID) + 1;
+  int t2 = findSensor(T2_FIRST_ID) + 1;
+  int lowest = addCalculatedSensor(TELEM_FORMULA_CELL, cells, 0, TELEM_CELL_INDEX_LOWEST);
+  int highest = addCalculatedSensor(TELEM_FORMULA_CELL, cells, 0, TELEM_CELL_INDEX_HIGHEST);
+  addCalculatedSensor(TELEM_FORMULA_CELL, cells, 0, TELEM_CELL_INDEX_DELTA);
+  addCalculatedSensor(TELEM_FORMULA_MULTIPLY, vfas, curr);
+  addCalculatedSensor(TELEM_FORMULA_AVERAGE, t1, t2);
+  addCalculatedSensor(TELEM_FORMULA_MAX, t1, t2);
+  addCalculatedSensor(TELEM_FORMULA_ADD, lowest, highest);
+  invalidateCalculatedSensors();
+  evalCalculatedSensors();
+}
+
+static void telemetryReplaySetup()
+{
+  telemetrySetup();
+  benchmarkItems("bytes", sportCaptureBytes);
+  benchmarkItems("packets", SPORT_CAPTURE_CYCLES*DIM(sportChain));
+}
+
+// The whole capture through the replay engine, the frame parser,
+// the sensors and the calculated sensors
+BENCHMARK(telemetry, replay, telemetryReplaySetup)
+{
+  rewind(sportCapture);
+  telemetryReplayStart(sportCapture, 0);
+  while (isTelemetryReplayRunning()) {
+    telemetryReplayWakeup();
+    telemetryWakeup();
+  }
+}
+
+BENCHMARK(telemetry, processSportPacket, telemetrySetup)
+{
+  static unsigned int index = 0;
+  processSportPacket(sportPackets[index]);
+  if (++index == DIM(sportChain))
+    index = 0;
+}
+
+BENCHMARK(telemetry, setTelemetryValue, telemetrySetup)
+{
+  static int32_t value = 0;
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 0x22 & 0x1F, 2400 + (++value & 0x3F), UNIT_VOLTS, 2);
+}
+
+BENCHMARK(telemetry, calculatedSensors, telemetrySetup)
+{
+  static unsigned int index = 1;
+  processSportPacket(sportPackets[index]);
+  evalCalculatedSensors();
+  if (++index == 4)
+    index = 1;
+}
+
+// Two 6S FLVSS sensors with their lowest / highest / delta / sag cell sensors,
+// one cells frame and one evaluation of the calculated sensors per item
+#define CELLS_SENSORS_COUNT  2
+
+static int32_t cellsFrame(uint8_t index, uint16_t cell1, uint16_t cell2)
+{
+  return (6 << 4) + index + ((cell1 * 5) << 8) + ((cell2 * 5) << 20);
+}
+
+static void cellsSetup()
+{
+  memclear(&g_model, sizeof(g_model));
+  telemetryReset();
+  for (int i=0; i<CELLS_SENSORS_COUNT; i++) {
+    for (int j=0; j<6; j+=2) {
+      setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, CELLS_FIRST_ID, i, cellsFrame(j, 410, 410), UNIT_CELLS, 2);
+    }
+  }
+  for (int i=0; i<CELLS_SENSORS_COUNT; i++) {
+    for (int index=TELEM_CELL_INDEX_LOWEST; index<=TELEM_CELL_INDEX_SAG; index++) {
+      if (index < TELEM_CELL_INDEX_1 || index > TELEM_CELL_INDEX_6)
+        addCalculatedSensor(TELEM_FORMULA_CELL, i+1, 0, index);
+    }
+  }
+  invalidateCalculatedSensors();
+  evalCalculatedSensors();
+  benchmarkItems("frames", 1);
+}
+
+BENCHMARK(telemetry, cells, cellsSetup)
+{
+  static unsigned int count = 0;
+  uint8_t index = (count % 3) * 2;
+  uint16_t sag = (count >> 3) & 0x1F;
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, CELLS_FIRST_ID, (count / 3) % CELLS_SENSORS_COUNT, cellsFrame(index, 400 - sag + index, 405 - sag), UNIT_CELLS, 2);
+  evalCalculatedSensors();
+  count++;
+}
+
+// One altitude sensor with average / slope / percentile history sensors,
+// a new altitude every 10ms
+static void historySetup()
+{
+  memclear(&g_model, sizeof(g_model));
+  telemetryReset();
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, ALT_FIRST_ID, 0, 0, UNIT_METERS, 2);
+  int alt = findSensor(ALT_FIRST_ID) + 1;
+  for (int stat=0; stat<=TELEM_HISTORY_STAT_MAX; stat++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[addCalculatedSensor(TELEM_FORMULA_HISTORY, alt, 0) - 1];
+    sensor.history.stat = stat;
+    sensor.history.percent = 90;
+  }
+  invalidateCalculatedSensors();
+  evalCalculatedSensors();
+  benchmarkItems("values", 1);
+}
+
+BENCHMARK(telemetry, history, historySetup)
+{
+  g_tmr10ms++;
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, ALT_FIRST_ID, 0, (g_tmr10ms * 7) & 0x3FF, UNIT_METERS, 2);
+  evalCalculatedSensors();
+}
+#endif
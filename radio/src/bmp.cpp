@@ -36,7 +36,7 @@
 
 #include "opentx.h"
 
-const pm_char * bmpLoad(uint8_t *bmp, const char *filename, const unsigned int width, const unsigned int height)
+static const pm_char * bmpDecode(uint8_t *bmp, const char *filename, const unsigned int width, const unsigned int height)
 {
   FIL bmpFile;
   UINT read;
@@ -214,3 +214,120 @@ const pm_char * bmpLoad(uint8_t *bmp, const char *filename, const unsigned int w
   f_close(&bmpFile);
   return 0;
 }
+
+/*
+ * Decoded bitmaps cache
+ *
+ * The last decoded bitmaps are kept in a fixed pool, each entry being the file path followed
+ * by the bitmap. Entries are stored contiguously in the order of the entries table, the least
+ * recently used ones are evicted when a new bitmap doesn't fit. The cache is flushed when the
+ * SD card is (re)mounted.
+ */
+struct BmpCacheEntry {
+  uint16_t offset;    // in bmpCache.pool
+  uint16_t size;      // path + bitmap
+  uint8_t  width;     // bmpLoad() bounds
+  uint8_t  height;
+  uint16_t lastUse;
+};
+
+struct {
+  uint8_t pool[BMP_CACHE_SIZE];
+  BmpCacheEntry entries[BMP_CACHE_ENTRIES];
+  uint8_t count;
+  uint16_t mountId;
+  uint16_t useCounter;
+} bmpCache;
+
+BmpCacheStats bmpCacheStats;
+
+void bmpFlushCache()
+{
+  bmpCache.count = 0;
+}
+
+static void bmpCacheEvict(uint8_t index)
+{
+  BmpCacheEntry & entry = bmpCache.entries[index];
+  uint16_t end = bmpCache.count > 0 ? bmpCache.entries[bmpCache.count-1].offset + bmpCache.entries[bmpCache.count-1].size : 0;
+  uint16_t next = entry.offset + entry.size;
+  uint16_t size = entry.size;
+  memmove(&bmpCache.pool[entry.offset], &bmpCache.pool[next], end - next);
+  for (uint8_t i=index+1; i<bmpCache.count; i++) {
+    bmpCache.entries[i-1] = bmpCache.entries[i];
+    bmpCache.entries[i-1].offset -= size;
+  }
+  bmpCache.count--;
+}
+
+static void bmpCacheInsert(const char *filename, uint8_t width, uint8_t height, const uint8_t *bmp)
+{
+  unsigned int pathSize = strlen(filename) + 1;
+  unsigned int size = pathSize + BITMAP_BUFFER_SIZE(bmp[0], bmp[1]);
+  if (size > BMP_CACHE_SIZE) {
+    return;
+  }
+
+  while (1) {
+    uint16_t end = bmpCache.count > 0 ? bmpCache.entries[bmpCache.count-1].offset + bmpCache.entries[bmpCache.count-1].size : 0;
+    if (bmpCache.count < BMP_CACHE_ENTRIES && end + size <= BMP_CACHE_SIZE) {
+      BmpCacheEntry & entry = bmpCache.entries[bmpCache.count++];
+      entry.offset = end;
+      entry.size = size;
+      entry.width = width;
+      entry.height = height;
+      entry.lastUse = ++bmpCache.useCounter;
+      memcpy(&bmpCache.pool[end], filename, pathSize);
+      memcpy(&bmpCache.pool[end+pathSize], bmp, size-pathSize);
+      return;
+    }
+    uint8_t lru = 0;
+    for (uint8_t i=1; i<bmpCache.count; i++) {
+      if ((int16_t)(bmpCache.entries[i].lastUse - bmpCache.entries[lru].lastUse) < 0) {
+        lru = i;
+      }
+    }
+    bmpCacheEvict(lru);
+    bmpCacheStats.evictions++;
+  }
+}
+
+static const uint8_t * bmpCacheFind(const char *filename, uint8_t width, uint8_t height)
+{
+  for (uint8_t i=0; i<bmpCache.count; i++) {
+    BmpCacheEntry & entry = bmpCache.entries[i];
+    const char * path = (const char *)&bmpCache.pool[entry.offset];
+    if (entry.width == width && entry.height == height && !strcmp(path, filename)) {
+      entry.lastUse = ++bmpCache.useCounter;
+      return (const uint8_t *)path + strlen(path) + 1;
+    }
+  }
+  return NULL;
+}
+
+const pm_char * bmpLoad(uint8_t *bmp, const char *filename, const unsigned int width, const unsigned int height)
+{
+  if (width > LCD_W || height > 0xFF) {
+    return STR_INCOMPATIBLE;
+  }
+
+  uint16_t mountId = sdMountId();
+  if (mountId != bmpCache.mountId) {
+    bmpFlushCache();
+    bmpCache.mountId = mountId;
+  }
+
+  const uint8_t * cached = bmpCacheFind(filename, width, height);
+  if (cached) {
+    memcpy(bmp, cached, BITMAP_BUFFER_SIZE(cached[0], cached[1]));
+    bmpCacheStats.hits++;
+    return 0;
+  }
+
+  bmpCacheStats.misses++;
+  const pm_char * result = bmpDecode(bmp, filename, width, height);
+  if (!result) {
+    bmpCacheInsert(filename, width, height, bmp);
+  }
+  return result;
+}
@@ -42,11 +42,27 @@
 uint8_t   s_eeDirtyMsk;
 tmr10ms_t s_eeDirtyTime10ms;
 
+#if defined(CPUARM)
+void eeDirtyCaches(uint8_t msk, uint32_t caches)
+{
+  s_eeDirtyMsk |= msk;
+  s_eeDirtyTime10ms = get_tmr10ms() ;
+  invalidateModelCaches(caches);
+}
+
+void eeDirty(uint8_t msk)
+{
+  uint32_t caches = ((msk & EE_MODEL) ? MODEL_CACHES_MODEL : 0) | ((msk & EE_GENERAL) ? MODEL_CACHES_GENERAL : 0);
+  eeDirtyCaches(msk, caches);
+  __atomic_fetch_or(&modelCachesPending, caches, __ATOMIC_RELAXED);
+}
+#else
 void eeDirty(uint8_t msk)
 {
   s_eeDirtyMsk |= msk;
   s_eeDirtyTime10ms = get_tmr10ms() ;
 }
+#endif
 
 #if defined(CPUARM)
 ModelHeader modelHeaders[MAX_MODELS];
@@ -52,6 +52,9 @@ extern uint8_t   s_eeDirtyMsk;
 extern tmr10ms_t s_eeDirtyTime10ms;
 
 void eeDirty(uint8_t msk);
+#if defined(CPUARM)
+void eeDirtyCaches(uint8_t msk, uint32_t caches); // eeDirty() which only invalidates these caches
+#endif
 void eeCheck(bool immediately);
 void eeReadAll();
 bool eeModelExists(uint8_t id);
@@ -395,12 +395,9 @@ void eeLoadModel(uint8_t id)
     }
 
     customFunctionsReset();
+    INVALIDATE_MODEL_CACHES();
 
-    for (uint8_t i=0; i<MAX_TIMERS; i++) {
-      if (g_model.timers[i].persistent) {
-        timersStates[i].val = g_model.timers[i].value;
-      }
-    }
+    restoreTimers();
 
     resumeMixerCalculations();
     // TODO pulses should be started after mixer calculations ...
@@ -984,13 +984,10 @@ void eeLoadModel(uint8_t id)
     }
 
     customFunctionsReset();
+    INVALIDATE_MODEL_CACHES();
 
 #if !defined(PCBSTD)
-    for (uint8_t i=0; i<MAX_TIMERS; i++) {
-      if (g_model.timers[i].persistent) {
-        timersStates[i].val = g_model.timers[i].value;
-      }
-    }
+    restoreTimers();
 #endif
 
 #if defined(CPUARM)
@@ -37,45 +37,148 @@
 #ifndef fifo_h
 #define fifo_h
 
+// Single producer / single consumer ring buffer, typically an interrupt
+// (or DMA) on one side and a task on the other side.
+// The producer only writes widx, the consumer only writes ridx. Both are
+// free-running and wrap at 2^32, so N must be a power of 2 and the whole
+// buffer is usable. Indices are published with release semantics and read
+// with acquire semantics, which gives the needed DMB on Cortex-M and the
+// needed fences between the simulator threads.
 template <int N>
 class Fifo
 {
   public:
     Fifo():
       widx(0),
-      ridx(0)
+      ridx(0),
+      overflows(0)
     {
     }
 
-    void push(uint8_t byte) {
-      uint32_t next = (widx+1) & (N-1);
-      if (next != ridx) {
-        fifo[widx] = byte;
-        widx = next;
+    // Producer side
+
+    bool push(uint8_t byte) {
+      uint32_t w = widx;
+      if (w - acquire(ridx) >= N) {
+        overflows++;
+        return false;
       }
+      fifo[w & (N-1)] = byte;
+      release(widx, w+1);
+      return true;
+    }
+
+    // pushes up to len bytes at once, returns the number of bytes written,
+    // the remaining bytes are dropped and counted as overflows
+    int push(const uint8_t * data, int len) {
+      uint32_t w = widx;
+      int count = N - (w - acquire(ridx));
+      if (count > len)
+        count = len;
+      int chunk = N - (w & (N-1));
+      if (chunk > count)
+        chunk = count;
+      memcpy(&fifo[w & (N-1)], data, chunk);
+      memcpy(&fifo[0], &data[chunk], count - chunk);
+      release(widx, w+count);
+      overflows += len - count;
+      return count;
+    }
+
+    // contiguous free space, to be filled directly (e.g. by DMA) then committed
+    int writeSpan(uint8_t * & data) {
+      uint32_t w = widx;
+      int count = N - (w - acquire(ridx));
+      int chunk = N - (w & (N-1));
+      data = &fifo[w & (N-1)];
+      return chunk < count ? chunk : count;
+    }
+
+    void commit(int count) {
+      release(widx, widx+count);
+    }
+
+    // waits until the consumer has emptied the fifo
+    void flush() {
+      while (!empty()) {};
     }
 
+    // Consumer side
+
     bool pop(uint8_t & byte) {
-      if (empty()) {
+      uint32_t r = ridx;
+      if (acquire(widx) == r) {
         return false;
       }
-      else {
-        byte = fifo[ridx];
-        ridx = (ridx+1) & (N-1);
-        return true;
-      }
+      byte = fifo[r & (N-1)];
+      release(ridx, r+1);
+      return true;
+    }
+
+    // pops up to len bytes at once, returns the number of bytes read
+    int pop(uint8_t * data, int len) {
+      uint32_t r = ridx;
+      int count = acquire(widx) - r;
+      if (count > len)
+        count = len;
+      int chunk = N - (r & (N-1));
+      if (chunk > count)
+        chunk = count;
+      memcpy(data, &fifo[r & (N-1)], chunk);
+      memcpy(&data[chunk], &fifo[0], count - chunk);
+      release(ridx, r+count);
+      return count;
+    }
+
+    // contiguous received bytes, to be parsed in place then consumed
+    int readSpan(const uint8_t * & data) {
+      uint32_t r = ridx;
+      int count = acquire(widx) - r;
+      int chunk = N - (r & (N-1));
+      data = &fifo[r & (N-1)];
+      return chunk < count ? chunk : count;
     }
+
+    void consume(int count) {
+      release(ridx, ridx+count);
+    }
+
+    // drops everything received so far
+    void clear() {
+      release(ridx, acquire(widx));
+    }
+
+    // Both sides
+
+    int size() {
+      return acquire(widx) - acquire(ridx);
+    }
+
     bool empty() {
-      return (ridx == widx);
+      return acquire(widx) == acquire(ridx);
     }
-    void flush() {
-      while (!empty()) {};
+
+    bool full() {
+      return size() >= N;
+    }
+
+    uint32_t getOverflows() {
+      return overflows;
     }
 
   protected:
+    static inline uint32_t acquire(const uint32_t & index) {
+      return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+    }
+
+    static inline void release(uint32_t & index, uint32_t value) {
+      __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+    }
+
     uint8_t fifo[N];
-    volatile uint32_t widx;
-    volatile uint32_t ridx;
+    uint32_t widx;
+    uint32_t ridx;
+    uint32_t overflows;
 };
 
 #endif
@@ -246,6 +246,37 @@ getvalue_t requiredSpeakerVolumeRawLast = 1024 + 1; //initial value must be outs
 #endif
 
 #if defined(CPUARM)
+void compileFunctionsTriggers(const CustomFunctionData * functions, CustomFunctionsContext & functionsContext)
+{
+  uint8_t count = 0;
+
+  for (uint8_t i=0; i<NUM_CFN; i++) {
+    const CustomFunctionData *cfn = &functions[i];
+    int8_t swtch = CFN_SWITCH(cfn);
+    uint8_t trigger = CFN_TRIGGER_NONE;
+    if (swtch && (!HAS_ENABLE_PARAM(CFN_FUNC(cfn)) || CFN_ACTIVE(cfn))) {
+      uint8_t flags = (IS_PLAY_FUNC(CFN_FUNC(cfn)) ? GETSWITCH_MIDPOS_DELAY : 0);
+      for (trigger=0; trigger<count; trigger++) {
+        if (functionsContext.triggerSwitch[trigger] == swtch && functionsContext.triggerFlags[trigger] == flags)
+          break;
+      }
+      if (trigger == count) {
+        functionsContext.triggerSwitch[count] = swtch;
+        functionsContext.triggerFlags[count] = flags;
+        count++;
+      }
+    }
+    else {
+      // never active, evalFunctions() won't visit it anymore
+      functionsContext.lastFunctionTime[i] = 0;
+    }
+    functionsContext.functionTrigger[i] = trigger;
+  }
+
+  functionsContext.triggersCount = count;
+  functionsContext.triggersVersion = MODEL_CACHE_VERSION(MODEL_CACHE_FUNCTIONS);
+}
+
 void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext & functionsContext)
 #else
 #define functions g_model.customFn
@@ -272,21 +303,41 @@ void evalFunctions()
   }
 #endif
 
+#if defined(CPUARM)
+  // functions which were not active and whose switch is still off are skipped
+  MASK_CFN_TYPE visitedFunctions = functionsContext.activeSwitches;
+  if (functionsContext.triggersVersion != MODEL_CACHE_VERSION(MODEL_CACHE_FUNCTIONS)) {
+    compileFunctionsTriggers(functions, functionsContext);
+    visitedFunctions = (MASK_CFN_TYPE)-1;
+  }
+
+  MASK_CFN_TYPE triggersStates = 0;
+  for (uint8_t i=0; i<functionsContext.triggersCount; i++) {
+    if (getSwitch(functionsContext.triggerSwitch[i], functionsContext.triggerFlags[i])) {
+      triggersStates |= ((MASK_CFN_TYPE)1 << i);
+    }
+  }
+#endif
+
   for (uint8_t i=0; i<NUM_CFN; i++) {
     const CustomFunctionData *cfn = &functions[i];
+#if defined(CPUARM)
+    uint8_t trigger = functionsContext.functionTrigger[i];
+    if (trigger != CFN_TRIGGER_NONE) {
+      MASK_CFN_TYPE  switch_mask = ((MASK_CFN_TYPE)1 << i);
+      bool active = (triggersStates & ((MASK_CFN_TYPE)1 << trigger));
+      if (!active && !(visitedFunctions & switch_mask)) {
+        continue;
+      }
+#else
     int8_t swtch = CFN_SWITCH(cfn);
     if (swtch) {
       MASK_CFN_TYPE  switch_mask = ((MASK_CFN_TYPE)1 << i);
-
-#if defined(CPUARM)
-      bool active = getSwitch(swtch, IS_PLAY_FUNC(CFN_FUNC(cfn)) ? GETSWITCH_MIDPOS_DELAY : 0);
-#else
       bool active = getSwitch(swtch);
-#endif
-
       if (HAS_ENABLE_PARAM(CFN_FUNC(cfn))) {
         active &= (bool)CFN_ACTIVE(cfn);
       }
+#endif
 
       if (active || IS_PLAY_BOTH_FUNC(CFN_FUNC(cfn))) {
 
@@ -355,13 +406,9 @@ void evalFunctions()
 
 #if defined(CPUARM)
           case FUNC_SET_TIMER:
-          {
-            TimerState & timerState = timersStates[CFN_TIMER_INDEX(cfn)];
-            timerState.state = TMR_OFF; // is changed to RUNNING dep from mode
-            timerState.val = CFN_PARAM(cfn);
-            timerState.val_10ms = 0 ;
+            timerReset(CFN_TIMER_INDEX(cfn));
+            timerSet(CFN_TIMER_INDEX(cfn), CFN_PARAM(cfn));
             break;
-          }
 #endif
 
 #if defined(DANGEROUS_MODULE_FUNCTIONS)
@@ -486,7 +533,7 @@ void evalFunctions()
               else {
 #if defined(GVARS)
                 if (CFN_FUNC(cfn) == FUNC_PLAY_TRACK && param > 250)
-                  param = GVAR_VALUE(param-251, getGVarFlightPhase(mixerCurrentFlightMode, param-251));
+                  param = GVAR_RESOLVED_VALUE(param-251, mixerCurrentFlightMode);
 #endif
                 PUSH_CUSTOM_PROMPT(active ? param : param+1, i+1);
               }
@@ -0,0 +1,289 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "golden.h"
+
+#if defined(SDCARD)
+
+namespace simu {
+#include <dirent.h>
+}
+
+extern uint16_t anaInValues[NUM_STICKS+NUM_POTS];
+void doMixerCalculations();
+
+static int64_t getTimeNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int compareNames(const void * a, const void * b)
+{
+  return strcmp((const char *)a, (const char *)b);
+}
+
+const char * goldenListModels(const char * path, char names[GOLDEN_MAX_MODELS][64], int & count)
+{
+  count = 0;
+
+  char models[256];
+  snprintf(models, sizeof(models), "%s" MODELS_PATH, path);
+  simu::DIR * dir = simu::opendir(models);
+  if (!dir) {
+    return "cannot open the corpus directory";
+  }
+
+  simu::dirent * entry;
+  while ((entry = simu::readdir(dir)) && count < GOLDEN_MAX_MODELS) {
+    const char * ext = strrchr(entry->d_name, '.');
+    if (ext && !strcmp(ext, MODELS_EXT) && strlen(entry->d_name) < 64) {
+      strcpy(names[count++], entry->d_name);
+    }
+  }
+  simu::closedir(dir);
+
+  qsort(names, count, 64, compareNames);
+  return NULL;
+}
+
+// The backup goes through eeRestoreModel() into the simulated EEPROM, the
+// same way as on the radio (older eeprom versions are converted), and the
+// model is read back from there. It must come from the same build options.
+const char * goldenLoadModel(const char * path, const char * name)
+{
+  char filename[256];
+  snprintf(filename, sizeof(filename), "%s" MODELS_PATH "/%s", path, name);
+  FILE * f = fopen(filename, "rb");
+  if (!f) {
+    return "cannot open the model";
+  }
+
+  uint8_t header[8];
+  size_t size = fread(header, 1, sizeof(header), f);
+  fclose(f);
+  if (size != sizeof(header) || *(uint32_t *)&header[0] != O9X_FOURCC || header[5] != 'M') {
+    return "not a model backup";
+  }
+  if (header[4] < FIRST_CONV_EEPROM_VER || header[4] > EEPROM_VER) {
+    return "other eeprom version";
+  }
+#if defined(PCBSKY9X)
+  // the backup is the raw model
+  if (header[4] == EEPROM_VER && *(uint16_t *)&header[6] != sizeof(g_model)) {
+    return GOLDEN_OTHER_OPTIONS;
+  }
+#endif
+
+  char modelName[64];
+  strncpy(modelName, name, sizeof(modelName)-1);
+  modelName[sizeof(modelName)-1] = '\0';
+  char * ext = strrchr(modelName, '.');
+  if (ext) *ext = '\0';
+
+  // the corpus directory is the SD card
+  char sdDirectory[sizeof(simuSdDirectory)];
+  strcpy(sdDirectory, simuSdDirectory);
+  strncpy(simuSdDirectory, path, sizeof(simuSdDirectory)-1);
+#if !defined(PCBSKY9X)
+  EeFsFormat();
+#endif
+  const char * error = eeRestoreModel(GOLDEN_EEPROM_SLOT, modelName);
+  strcpy(simuSdDirectory, sdDirectory);
+  if (error) {
+    return error;
+  }
+
+#if defined(PCBSKY9X)
+  loadModel(GOLDEN_EEPROM_SLOT);
+#else
+  memclear(&g_model, sizeof(g_model));
+  theFile.openRlc(FILE_MODEL(GOLDEN_EEPROM_SLOT));
+  uint8_t more;
+  if (theFile.readRlc((uint8_t *)&g_model, sizeof(g_model)) != sizeof(g_model) || theFile.readRlc(&more, 1)) {
+    return GOLDEN_OTHER_OPTIONS;
+  }
+#endif
+
+  // default radio settings, mode 1
+  generalDefault();
+  stickMode = g_eeGeneral.stickMode;
+
+  // the mixer state is reset like after eeLoadModel()
+  memclear(anaInValues, sizeof(anaInValues));
+  memclear(channelOutputs, sizeof(channelOutputs));
+  memclear(chans, sizeof(chans));
+  memclear(ex_chans, sizeof(ex_chans));
+  memclear(act, sizeof(act));
+  memclear(swOn, sizeof(swOn));
+  mixerCurrentFlightMode = 0;
+  lastFlightMode = 255;
+  flightReset();
+  logicalSwitchesReset();
+  customFunctionsReset();
+  INVALIDATE_MODEL_CACHES();
+  LOAD_MODEL_CURVES();
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    timerSet(i, g_model.timers[i].persistent ? g_model.timers[i].value : 0);
+  }
+
+  return NULL;
+}
+
+static int16_t triangle(int32_t t, int32_t period, int16_t amplitude)
+{
+  int32_t p = t % period;
+  if (p < period/2)
+    return -amplitude + 4*amplitude*p/period;
+  else
+    return 3*amplitude - 4*amplitude*p/period;
+}
+
+// The sweep, the same for all models: sticks and pots triangles with
+// different periods, switches moving through their positions and trims
+// stepped on the current flight mode
+static void goldenSetInputs(uint16_t tick)
+{
+  for (uint8_t i=0; i<NUM_STICKS; i++) {
+    anaInValues[i] = triangle(tick + 37*i, 200 + 70*i, RESX);
+  }
+
+  for (uint8_t i=0; i<NUM_POTS; i++) {
+    anaInValues[NUM_STICKS+i] = triangle(tick, 500 + 100*i, RESX);
+  }
+
+  for (uint8_t i=0; i<GOLDEN_SWITCHES; i++) {
+    simuSetSwitch(i, (tick / (97 + 31*i) + i) % 3 - 1);
+  }
+
+  if (tick % 50 == 0) {
+    uint8_t idx = (tick / 50) % NUM_STICKS;
+    setTrimValue(getTrimFlightPhase(mixerCurrentFlightMode, idx), idx, (tick / 50) * 37 % 201 - 100);
+  }
+}
+
+void goldenRun(GoldenRecord & record)
+{
+  record.ticks = GOLDEN_TICKS;
+  record.channels = 0;
+  record.duration = 0;
+
+  for (uint16_t tick=0; tick<GOLDEN_TICKS; tick++) {
+    goldenSetInputs(tick);
+    g_tmr10ms++;
+    int64_t start = getTimeNs();
+    doMixerCalculations();
+    record.duration += getTimeNs() - start;
+    for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+      record.outputs[tick][ch] = channelOutputs[ch];
+      if (channelOutputs[ch] && ch >= record.channels) {
+        record.channels = ch + 1;
+      }
+    }
+  }
+}
+
+// One line per tick with the outputs of the channels
+const char * goldenWrite(const char * filename, const GoldenRecord & record)
+{
+  FILE * f = fopen(filename, "w");
+  if (!f) {
+    return "cannot create the golden file";
+  }
+
+  fprintf(f, "golden ticks=%d channels=%d\n", record.ticks, record.channels);
+  for (uint16_t tick=0; tick<record.ticks; tick++) {
+    for (uint8_t ch=0; ch<record.channels; ch++) {
+      fprintf(f, ch ? " %d" : "%d", record.outputs[tick][ch]);
+    }
+    fprintf(f, "\n");
+  }
+
+  fclose(f);
+  return NULL;
+}
+
+const char * goldenCompare(const char * filename, const GoldenRecord & record, int tolerance, GoldenDiff & diff)
+{
+  memclear(&diff, sizeof(diff));
+  diff.tick = -1;
+
+  FILE * f = fopen(filename, "r");
+  if (!f) {
+    return "no golden file";
+  }
+
+  int ticks, channels;
+  if (fscanf(f, "golden ticks=%d channels=%d", &ticks, &channels) != 2 || channels < 0 || channels > NUM_CHNOUT) {
+    fclose(f);
+    return "not a golden file";
+  }
+  if (ticks != record.ticks) {
+    fclose(f);
+    return "other ticks count";
+  }
+
+  for (int tick=0; tick<ticks; tick++) {
+    for (int ch=0; ch<NUM_CHNOUT; ch++) {
+      int expected = 0;
+      if (ch < channels && fscanf(f, "%d", &expected) != 1) {
+        fclose(f);
+        return "truncated golden file";
+      }
+      int actual = record.outputs[tick][ch];
+      int delta = abs(actual - expected);
+      if (delta > diff.maxDiff) {
+        diff.maxDiff = delta;
+      }
+      if (delta > tolerance && diff.count++ == 0) {
+        diff.tick = tick;
+        diff.channel = ch;
+        diff.expected = expected;
+        diff.actual = actual;
+      }
+    }
+  }
+
+  fclose(f);
+  return NULL;
+}
+
+#endif // SDCARD
@@ -0,0 +1,99 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef __GOLDEN_H
+#define __GOLDEN_H
+
+#define SWAP_DEFINED
+#include "opentx.h"
+
+// The mixer golden outputs harness. A corpus directory is laid out like the
+// SD card: each model backup made on the radio (MODELS/*.bin) is driven
+// through the same scripted sweep of sticks, pots, switches and trims, the
+// flight modes following the model switches, and channelOutputs is recorded
+// at each 10ms tick. The records are kept as <model>.golden text files at the
+// corpus root, so that a mixer change can be checked against them.
+// The models must match the build options, GOLDEN_CORPUS_OPTIONS tells how
+// the corpus of the board was recorded (with "goldencheck -r").
+
+#if defined(SDCARD)
+
+#if defined(PCBTARANIS)
+  #define GOLDEN_CORPUS_PATH  "golden/models/taranis"
+  #define GOLDEN_CORPUS_OPTIONS "make goldencheck PCB=TARANIS, default options"
+  #define GOLDEN_SWITCHES     NUM_SW_SRCRAW
+#elif defined(PCBSKY9X)
+  #define GOLDEN_CORPUS_PATH  "golden/models/sky9x"
+  #define GOLDEN_SWITCHES     NUM_SWITCHES
+#else
+  #define GOLDEN_CORPUS_PATH  "golden/models/9x"
+  #define GOLDEN_SWITCHES     NUM_SWITCHES
+#endif
+
+#define GOLDEN_EXT          ".golden"
+#define GOLDEN_TICKS        1000  // 10s
+#define GOLDEN_MAX_MODELS   64
+#define GOLDEN_EEPROM_SLOT  0     // where the models are restored
+
+struct GoldenRecord {
+  uint16_t ticks;
+  uint8_t  channels;   // the last channels which stayed at 0 are not kept
+  int16_t  outputs[GOLDEN_TICKS][NUM_CHNOUT];
+  int64_t  duration;   // ns spent in doMixerCalculations()
+};
+
+struct GoldenDiff {
+  int      maxDiff;
+  uint32_t count;      // outputs out of the tolerance
+  int      tick;       // the first one
+  int      channel;
+  int      expected;
+  int      actual;
+};
+
+// goldenLoadModel() error for a model saved with other build options
+#define GOLDEN_OTHER_OPTIONS "other model size (build options?)"
+
+// All functions return NULL on success, or an error message
+const char * goldenListModels(const char * path, char names[GOLDEN_MAX_MODELS][64], int & count);
+const char * goldenLoadModel(const char * path, const char * name);
+void goldenRun(GoldenRecord & record);
+const char * goldenWrite(const char * filename, const GoldenRecord & record);
+const char * goldenCompare(const char * filename, const GoldenRecord & record, int tolerance, GoldenDiff & diff);
+
+#endif // SDCARD
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "golden.h"
+
+// Usage: goldencheck [-r] [-t tolerance] [corpus directory]
+//  -r  records the golden files instead of checking them
+//  -t  the difference allowed on each output, 0 by default
+//
+// Output is one line per model: "<model> <ticks> <ns/tick> <status>", status
+// being OK, RECORDED, FAIL (followed by "maxdiff=<n> diffs=<n>
+// first=<tick>:<channel>:<expected>:<actual>") or ERROR <message>.
+// The exit code is 1 as soon as one model is not OK.
+
+uint16_t anaInValues[NUM_STICKS+NUM_POTS] = { 0 };
+uint16_t anaIn(uint8_t chan)
+{
+  if (chan < NUM_STICKS+NUM_POTS)
+    return anaInValues[chan];
+  else
+    return 0;
+}
+
+#if defined(SDCARD)
+static GoldenRecord record;
+static char names[GOLDEN_MAX_MODELS][64];
+
+int main(int argc, char **argv)
+{
+  bool recording = false;
+  int tolerance = 0;
+  const char * path = GOLDEN_CORPUS_PATH;
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp(argv[i], "-r"))
+      recording = true;
+    else if (!strcmp(argv[i], "-t") && i+1 < argc)
+      tolerance = atoi(argv[++i]);
+    else
+      path = argv[i];
+  }
+
+  StartEepromThread(NULL); // in memory, the models are restored there
+  g_menuStackPtr = 0;
+  g_menuStack[0] = menuMainView;
+
+  int count;
+  const char * error = goldenListModels(path, names, count);
+  if (error) {
+    fprintf(stderr, "%s: %s\n", path, error);
+    return 1;
+  }
+
+  int result = 0;
+  for (int i=0; i<count; i++) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s/%s", path, names[i]);
+
+    error = goldenLoadModel(path, names[i]);
+    if (!error) {
+      goldenRun(record);
+      printf("%s %d %.1f", names[i], record.ticks, (double)record.duration / record.ticks);
+      strcpy(strrchr(filename, '.'), GOLDEN_EXT);
+      if (recording) {
+        error = goldenWrite(filename, record);
+        if (!error) {
+          printf(" RECORDED\n");
+        }
+      }
+      else {
+        GoldenDiff diff;
+        error = goldenCompare(filename, record, tolerance, diff);
+        if (!error && diff.count) {
+          printf(" FAIL maxdiff=%d diffs=%u first=%d:%d:%d:%d\n", diff.maxDiff, diff.count, diff.tick, diff.channel, diff.expected, diff.actual);
+          result = 1;
+        }
+        else if (!error) {
+          printf(" OK\n");
+        }
+      }
+    }
+    else {
+      printf("%s", names[i]);
+    }
+
+    if (error) {
+      printf(" ERROR %s\n", error);
+      result = 1;
+    }
+    fflush(stdout);
+  }
+
+  return result;
+}
+#else
+int main(int argc, char **argv)
+{
+  fprintf(stderr, "no model backups on this board\n");
+  return 1;
+}
+#endif
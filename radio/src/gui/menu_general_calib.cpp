@@ -136,6 +136,9 @@ void menuCommonCalib(uint8_t event)
           g_eeGeneral.calib[i].spanPos = v - v/STICK_TOLERANCE;
         }
       }
+#if defined(CPUARM)
+      invalidateInputsCalibration();
+#endif
       break;
 
     case 3:
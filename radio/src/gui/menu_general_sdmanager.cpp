@@ -36,24 +36,54 @@
 
 #include "../opentx.h"
 
+#if defined(CPUARM)
+#if LCD_W >= 212
+  #define SD_STATS_COL  (10*FW)
+#else
+  #define SD_STATS_COL  (5*FW+2)
+#endif
+
+void menuGeneralSdManagerStatsLine(coord_t y, const pm_char * label, uint32_t sectors, uint32_t time, uint32_t maxTime)
+{
+  lcd_putsLeft(y, label);
+  // sectors of 512 bytes, time in 0.5us
+  lcd_outdezAtt(SD_STATS_COL, y, time ? (uint64_t)sectors * 1000000 / time : 0, LEFT);
+  lcd_puts(lcdLastPos, y, "kB/s");
+  lcd_outdezAtt(LCD_W-2*FW, y, maxTime / 200, PREC1);
+  lcd_puts(LCD_W-2*FW, y, "ms");
+}
+#endif
+
 void menuGeneralSdManagerInfo(uint8_t event)
 {
   SIMPLE_SUBMENU(STR_SD_INFO_TITLE, 1);
 
-  lcd_putsLeft(2*FH, STR_SD_TYPE);
-  lcd_puts(10*FW, 2*FH, SD_IS_HC() ? STR_SDHC_CARD : STR_SD_CARD);
+  lcd_putsLeft(1*FH, STR_SD_TYPE);
+  lcd_puts(10*FW, 1*FH, SD_IS_HC() ? STR_SDHC_CARD : STR_SD_CARD);
+
+  lcd_putsLeft(2*FH, STR_SD_SIZE);
+  lcd_outdezAtt(10*FW, 2*FH, SD_GET_SIZE_MB(), LEFT);
+  lcd_putc(lcdLastPos, 2*FH, 'M');
 
-  lcd_putsLeft(3*FH, STR_SD_SIZE);
-  lcd_outdezAtt(10*FW, 3*FH, SD_GET_SIZE_MB(), LEFT);
-  lcd_putc(lcdLastPos, 3*FH, 'M');
+  lcd_putsLeft(3*FH, STR_SD_SECTORS);
+  lcd_outdezAtt(10*FW, 3*FH, SD_GET_BLOCKNR()/1000, LEFT);
+  lcd_putc(lcdLastPos, 3*FH, 'k');
 
-  lcd_putsLeft(4*FH, STR_SD_SECTORS);
-  lcd_outdezAtt(10*FW, 4*FH, SD_GET_BLOCKNR()/1000, LEFT);
-  lcd_putc(lcdLastPos, 4*FH, 'k');
+  lcd_putsLeft(4*FH, STR_SD_SPEED);
+  lcd_outdezAtt(10*FW, 4*FH, SD_GET_SPEED()/1000, LEFT);
+  lcd_puts(lcdLastPos, 4*FH, "kb/s");
 
-  lcd_putsLeft(5*FH, STR_SD_SPEED);
-  lcd_outdezAtt(10*FW, 5*FH, SD_GET_SPEED()/1000, LEFT);
-  lcd_puts(lcdLastPos, 5*FH, "kb/s");
+#if defined(CPUARM)
+  // measured by the disk driver since the start, with the longest access
+  menuGeneralSdManagerStatsLine(5*FH, STR_SD_READ, sdStats.readSectors, sdStats.readTime, sdStats.readMaxTime);
+  menuGeneralSdManagerStatsLine(6*FH, STR_SD_WRITE, sdStats.writeSectors, sdStats.writeTime, sdStats.writeMaxTime);
+
+  lcd_putsLeft(7*FH, STR_SD_CACHE);
+  uint32_t accesses = sdStats.cacheHits + sdStats.cacheMisses;
+  lcd_outdezAtt(SD_STATS_COL, 7*FH, accesses ? (uint64_t)sdStats.cacheHits * 100 / accesses : 0, LEFT);
+  lcd_putc(lcdLastPos, 7*FH, '%');
+  lcd_outdezAtt(LCD_W, 7*FH, accesses, 0);
+#endif
 }
 
 inline bool isFilenameGreater(bool isfile, const char * fn, const char * line)
@@ -130,6 +160,9 @@ void onSdManagerMenu(const char *result)
     strcat_P(lfn, PSTR("/"));
     strcat(lfn, reusableBuffer.sdmanager.lines[index]);
     f_unlink(lfn);
+#if defined(PCBTARANIS)
+    bmpFlushCache();
+#endif
     strncpy(statusLineMsg, reusableBuffer.sdmanager.lines[index], 13);
     strcpy_P(statusLineMsg+min((uint8_t)strlen(statusLineMsg), (uint8_t)13), STR_REMOVED);
     showStatusLine();
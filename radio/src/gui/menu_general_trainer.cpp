@@ -42,6 +42,36 @@
   #define TRAINER_CALIB_POS 8
 #endif
 
+#if defined(PCBTARANIS)
+#define SBUS_STATS_COL  (26*FW)
+
+void menuGeneralTrainerSbusStats()
+{
+  if (g_model.trainerMode != TRAINER_MODE_MASTER_SBUS_EXTERNAL_MODULE &&
+      (g_model.trainerMode != TRAINER_MODE_MASTER_BATTERY_COMPARTMENT || g_eeGeneral.uart3Mode != UART_MODE_SBUS_TRAINER)) {
+    return;
+  }
+
+  coord_t y = MENU_TITLE_HEIGHT + 1;
+  lcd_puts(SBUS_STATS_COL, y, STR_SBUS);
+  lcd_outdezAtt(LCD_W-2*FW, y, sbusStats.rate, 0);
+  lcd_puts(LCD_W-2*FW, y, STR_HZ);
+  y += FH;
+  lcd_puts(SBUS_STATS_COL, y, STR_SBUS_ERRORS);
+  lcd_outdezAtt(LCD_W, y, sbusStats.errors, 0);
+  y += FH;
+  lcd_puts(SBUS_STATS_COL, y, STR_SBUS_LOST);
+  lcd_outdezAtt(LCD_W, y, sbusStats.lostFrames, 0);
+  y += FH;
+  lcd_puts(SBUS_STATS_COL, y, STR_SBUS_FAILSAFES);
+  lcd_outdezAtt(LCD_W, y, sbusStats.failsafes, 0);
+  y += FH;
+  lcd_puts(SBUS_STATS_COL, y, STR_SBUS_LATENCY);
+  lcd_outdezAtt(LCD_W-2*FW, y, sbusStats.latency / 100, PREC1);
+  lcd_puts(LCD_W-2*FW, y, STR_MS);
+}
+#endif
+
 void menuGeneralTrainer(uint8_t event)
 {
   uint8_t y;
@@ -58,6 +88,10 @@ void menuGeneralTrainer(uint8_t event)
 
     lcd_puts(3*FW, MENU_TITLE_HEIGHT+1, STR_MODESRC);
 
+#if defined(PCBTARANIS)
+    menuGeneralTrainerSbusStats();
+#endif
+
     y = MENU_TITLE_HEIGHT + 1 + FH;
 
     for (uint8_t i=1; i<=NUM_STICKS; i++) {
@@ -291,12 +291,12 @@ bool isSensorAvailable(int sensor)
 #define SENSOR_2ND_COLUMN (12*FW)
 #define SENSOR_3RD_COLUMN (18*FW)
 
-#define SENSOR_UNIT_ROWS   (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula >= TELEM_FORMULA_CELL) ? HIDDEN_ROW : ((sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME || sensor->unit == UNIT_CELLS) ? HIDDEN_ROW : (uint8_t)0)
-#define SENSOR_PREC_ROWS   (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula >= TELEM_FORMULA_CELL) ? HIDDEN_ROW : ((sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME) ? HIDDEN_ROW : (uint8_t)0)
+#define SENSOR_UNIT_ROWS   (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula >= TELEM_FORMULA_CELL && sensor->formula <= TELEM_FORMULA_DIST) ? HIDDEN_ROW : ((sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME || sensor->unit == UNIT_CELLS) ? HIDDEN_ROW : (uint8_t)0)
+#define SENSOR_PREC_ROWS   (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula >= TELEM_FORMULA_CELL && sensor->formula <= TELEM_FORMULA_DIST) ? HIDDEN_ROW : ((sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME) ? HIDDEN_ROW : (uint8_t)0)
 #define SENSOR_PARAM1_ROWS (sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME || sensor->unit == UNIT_CELLS) ? HIDDEN_ROW : (uint8_t)0
 #define SENSOR_PARAM2_ROWS (sensor->unit == UNIT_GPS || sensor->unit == UNIT_DATETIME || sensor->unit == UNIT_CELLS || (sensor->type==TELEM_TYPE_CALCULATED && sensor->formula==TELEM_FORMULA_CONSUMPTION)) ? HIDDEN_ROW : (uint8_t)0
-#define SENSOR_PARAM3_ROWS (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula < TELEM_FORMULA_MULTIPLY) ? (uint8_t)0 : HIDDEN_ROW
-#define SENSOR_PARAM4_ROWS (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula < TELEM_FORMULA_MULTIPLY) ? (uint8_t)0 : HIDDEN_ROW
+#define SENSOR_PARAM3_ROWS (sensor->type == TELEM_TYPE_CALCULATED && (sensor->formula < TELEM_FORMULA_MULTIPLY || sensor->formula == TELEM_FORMULA_HISTORY)) ? (uint8_t)0 : HIDDEN_ROW
+#define SENSOR_PARAM4_ROWS (sensor->type == TELEM_TYPE_CALCULATED && (sensor->formula < TELEM_FORMULA_MULTIPLY || (sensor->formula == TELEM_FORMULA_HISTORY && sensor->history.stat == TELEM_HISTORY_PERCENTILE))) ? (uint8_t)0 : HIDDEN_ROW
 
 void menuModelSensor(uint8_t event)
 {
@@ -355,7 +355,7 @@ void menuModelSensor(uint8_t event)
           }
         }
         else {
-          sensor->formula = selectMenuItem(SENSOR_2ND_COLUMN, y, "Formula", "\010Add\0    Average\0Min\0    Max\0    MultiplyCell\0   ConsumptDistance", sensor->formula, 0, TELEM_FORMULA_DIST, attr, event);
+          sensor->formula = selectMenuItem(SENSOR_2ND_COLUMN, y, "Formula", "\010Add\0    Average\0Min\0    Max\0    MultiplyCell\0   ConsumptDistanceHistory\0", sensor->formula, 0, TELEM_FORMULA_HISTORY, attr, event);
           if (attr && checkIncDec_Ret) {
             sensor->param = 0;
             if (sensor->formula == TELEM_FORMULA_CELL) {
@@ -370,6 +370,9 @@ void menuModelSensor(uint8_t event)
               sensor->unit = UNIT_MAH;
               sensor->prec = 0;
             }
+            else if (sensor->formula == TELEM_FORMULA_HISTORY) {
+              sensor->history.percent = 50;
+            }
           }
         }
         break;
@@ -403,6 +406,20 @@ void menuModelSensor(uint8_t event)
             }
             break;
           }
+          else if (sensor->formula == TELEM_FORMULA_HISTORY) {
+            lcd_putsLeft(y, "Source");
+            putsMixerSource(SENSOR_2ND_COLUMN, y, sensor->history.source ? MIXSRC_FIRST_TELEM+3*(sensor->history.source-1) : 0, attr);
+            if (attr) {
+              sensor->history.source = checkIncDec(event, sensor->history.source, 0, TELEM_VALUES_MAX, EE_MODEL|NO_INCDEC_MARKS, isSensorAvailable);
+              if (checkIncDec_Ret && sensor->history.source) {
+                TelemetrySensor & source = g_model.telemetrySensors[sensor->history.source-1];
+                sensor->unit = source.unit;
+                sensor->prec = source.prec;
+                telemetryItems[s_currIdx].clear();
+              }
+            }
+            break;
+          }
           else if (sensor->formula == TELEM_FORMULA_DIST) {
             lcd_putsLeft(y, "GPS sensor");
             putsMixerSource(SENSOR_2ND_COLUMN, y, sensor->dist.gps ? MIXSRC_FIRST_TELEM+3*(sensor->dist.gps-1) : 0, attr);
@@ -434,7 +451,11 @@ void menuModelSensor(uint8_t event)
       case SENSOR_FIELD_PARAM2:
         if (sensor->type == TELEM_TYPE_CALCULATED) {
           if (sensor->formula == TELEM_FORMULA_CELL) {
-            sensor->cell.index = selectMenuItem(SENSOR_2ND_COLUMN, y, "Cell index", "\007Lowest\0001\0     2\0     3\0     4\0     5\0     6\0     HighestDelta\0", sensor->cell.index, 0, 8, attr, event);
+            sensor->cell.index = selectMenuItem(SENSOR_2ND_COLUMN, y, "Cell index", "\007Lowest\0001\0     2\0     3\0     4\0     5\0     6\0     HighestDelta\0 Sag\0   ", sensor->cell.index, 0, TELEM_CELL_INDEX_SAG, attr, event);
+            break;
+          }
+          else if (sensor->formula == TELEM_FORMULA_HISTORY) {
+            sensor->history.stat = selectMenuItem(SENSOR_2ND_COLUMN, y, "Value", "\012Average\0  Slope/s\0  Percentile", sensor->history.stat, 0, TELEM_HISTORY_STAT_MAX, attr, event);
             break;
           }
           else if (sensor->formula == TELEM_FORMULA_DIST) {
@@ -456,10 +477,21 @@ void menuModelSensor(uint8_t event)
         // no break
 
       case SENSOR_FIELD_PARAM3:
+        if (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula == TELEM_FORMULA_HISTORY) {
+          sensor->history.scale = selectMenuItem(SENSOR_2ND_COLUMN, y, "Window", "\0053.2s\0""32s\0 ""320s\0", sensor->history.scale, 0, TELEMETRY_HISTORY_SCALES-1, attr, event);
+          break;
+        }
         // no break
 
       case SENSOR_FIELD_PARAM4:
       {
+        if (sensor->type == TELEM_TYPE_CALCULATED && sensor->formula == TELEM_FORMULA_HISTORY) {
+          lcd_putsLeft(y, "Percent");
+          lcd_outdezAtt(SENSOR_2ND_COLUMN, y, sensor->history.percent, LEFT|attr);
+          lcd_putc(lcdLastPos, y, '%');
+          if (attr) CHECK_INCDEC_MODELVAR_ZERO(event, sensor->history.percent, 100);
+          break;
+        }
         putsStrIdx(0, y, "Source", k-SENSOR_FIELD_PARAM1+1);
         int8_t & source = sensor->calc.sources[k-SENSOR_FIELD_PARAM1];
         if (attr) {
@@ -485,6 +517,11 @@ void menuModelSensor(uint8_t event)
 
     }
   }
+
+  if (checkIncDec_Ret) {
+    // type, formula or sources may have changed
+    invalidateCalculatedSensors();
+  }
 }
 
 void onSensorMenu(const char *result)
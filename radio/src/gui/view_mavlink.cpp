@@ -266,6 +266,16 @@ void menuTelemetryMavlinkInfos(void) {
 */
 		
 	}
+
+	y = 5 * FH;
+	lcd_puts(x1, y, PSTR("RX"));
+	lcd_outdezAtt(xnum, y, mavlinkStats.frames, 0);
+	y += FH;
+	lcd_puts(x1, y, PSTR("CRC"));
+	lcd_outdezAtt(xnum, y, mavlinkStats.crcErrors, 0);
+	y += FH;
+	lcd_puts(x1, y, PSTR("LOST"));
+	lcd_outdezAtt(xnum, y, mavlinkStats.lost, 0);
 }
 
 /*!	\brief Flight mode menu
@@ -262,9 +262,48 @@ void displayAfterFlightScreen()
 }
 #endif
 
+#if defined(PCBTARANIS)
+#define TELEMETRY_BACKGROUND_Y        FH
+#define TELEMETRY_BACKGROUND_H        (6*FH)
+#define TELEMETRY_BACKGROUND_INVALID  0xFF
+
+// The labels and frames of the custom screens only depend on the model setup, they are
+// rendered once into an offscreen surface which is copied on each refresh
+void displayTelemetryBackground(FrSkyScreenData & screen, void (*draw)(FrSkyScreenData & screen))
+{
+  uint8_t * background = reusableBuffer.telemetry.background;
+  if (reusableBuffer.telemetry.view != s_frsky_view) {
+    lcdSurfaceBegin(background, 0, TELEMETRY_BACKGROUND_Y, LCD_W, TELEMETRY_BACKGROUND_H);
+    draw(screen);
+    lcdSurfaceEnd();
+    reusableBuffer.telemetry.view = s_frsky_view;
+  }
+  lcd_bmp(0, TELEMETRY_BACKGROUND_Y, background);
+}
+
+void displayGaugesTelemetryBackground(FrSkyScreenData & screen)
+{
+  uint8_t barHeight = 5;
+  for (int8_t i=3; i>=0; i--) {
+    FrSkyBarData & bar = screen.bars[i];
+    if (bar.source && bar.barMax > bar.barMin) {
+      uint8_t y = barHeight+6+i*(barHeight+6);
+      putsMixerSource(0, y+barHeight-5, bar.source, 0);
+      lcd_rect(BAR_LEFT, y, BAR_WIDTH+1, barHeight+2);
+    }
+    else {
+      barHeight += 2;
+    }
+  }
+}
+#endif
+
 bool displayGaugesTelemetryScreen(FrSkyScreenData & screen)
 {
   // Custom Screen with gauges
+#if defined(PCBTARANIS)
+  displayTelemetryBackground(screen, displayGaugesTelemetryBackground);
+#endif
   uint8_t barHeight = 5;
   for (int8_t i=3; i>=0; i--) {
     FrSkyBarData & bar = screen.bars[i];
@@ -278,12 +317,15 @@ bool displayGaugesTelemetryScreen(FrSkyScreenData & screen)
 #endif
     if (source && barMax > barMin) {
       uint8_t y = barHeight+6+i*(barHeight+6);
-#if defined(CPUARM)
+#if defined(PCBTARANIS)
+      // label and frame are in the background
+#elif defined(CPUARM)
       putsMixerSource(0, y+barHeight-5, source, 0);
+      lcd_rect(BAR_LEFT, y, BAR_WIDTH+1, barHeight+2);
 #else
       lcd_putsiAtt(0, y+barHeight-5, STR_VTELEMCHNS, source, 0);
-#endif
       lcd_rect(BAR_LEFT, y, BAR_WIDTH+1, barHeight+2);
+#endif
 #if defined(CPUARM)
       getvalue_t value = getValue(source);
 #else
@@ -352,9 +394,51 @@ bool displayGaugesTelemetryScreen(FrSkyScreenData & screen)
 }
 
 #if defined(CPUARM)
+#if LCD_W >= 212
+  const coord_t numbersScreenPos[] = {0, 71, 143, 214};
+#else
+  const coord_t numbersScreenPos[] = {0, 65, 130};
+#endif
+
+#define IS_GPS_FIELD(field) (field >= MIXSRC_FIRST_TELEM && isGPSSensor(1+(field-MIXSRC_FIRST_TELEM)/3))
+
+void displayNumbersTelemetryLabel(uint8_t line, uint8_t item, source_t field)
+{
+  coord_t x = numbersScreenPos[item];
+  coord_t y = 1+FH+2*FH*line;
+  if (field >= MIXSRC_FIRST_TIMER && field <= MIXSRC_LAST_TIMER && line!=3) {
+    // there is not enough space on LCD for displaying "Tmr1" or "Tmr2" and still see the - sign, we write "T1" or "T2" instead
+    putsStrIdx(x, y, "T", field-MIXSRC_FIRST_TIMER+1, 0);
+  }
+  else if (IS_GPS_FIELD(field) && telemetryItems[(field-MIXSRC_FIRST_TELEM)/3].isAvailable()) {
+    // we don't display GPS name, no space for it
+  }
+  else {
+    putsMixerSource(x, y, field, 0);
+  }
+}
+
+#if defined(PCBTARANIS)
+// The last line and the GPS labels depend on the telemetry state and stay out of the background
+void displayNumbersTelemetryBackground(FrSkyScreenData & screen)
+{
+  for (uint8_t i=0; i<3; i++) {
+    for (uint8_t j=0; j<NUM_LINE_ITEMS; j++) {
+      source_t field = screen.lines[i].sources[j];
+      if (field && !IS_GPS_FIELD(field)) {
+        displayNumbersTelemetryLabel(i, j, field);
+      }
+    }
+  }
+}
+#endif
+
 bool displayNumbersTelemetryScreen(FrSkyScreenData & screen)
 {
   // Custom Screen with numbers
+#if defined(PCBTARANIS)
+  displayTelemetryBackground(screen, displayNumbersTelemetryBackground);
+#endif
   uint8_t fields_count = 0;
   for (uint8_t i=0; i<4; i++) {
     for (uint8_t j=0; j<NUM_LINE_ITEMS; j++) {
@@ -377,23 +461,12 @@ bool displayNumbersTelemetryScreen(FrSkyScreenData & screen)
       }
       if (field) {
         LcdFlags att = (i==3 ? NO_UNIT : DBLSIZE|NO_UNIT);
-#if LCD_W >= 212
-        coord_t pos[] = {0, 71, 143, 214};
-#else
-        coord_t pos[] = {0, 65, 130};
+
+#if defined(PCBTARANIS)
+        if (i==3 || IS_GPS_FIELD(field))
 #endif
+        displayNumbersTelemetryLabel(i, j, field);
 
-        if (field >= MIXSRC_FIRST_TIMER && field <= MIXSRC_LAST_TIMER && i!=3) {
-          // there is not enough space on LCD for displaying "Tmr1" or "Tmr2" and still see the - sign, we write "T1" or "T2" instead
-          putsStrIdx(pos[j], 1+FH+2*FH*i, "T", field-MIXSRC_FIRST_TIMER+1, 0);
-        }
-        else if (field >= MIXSRC_FIRST_TELEM && isGPSSensor(1+(field-MIXSRC_FIRST_TELEM)/3) && telemetryItems[(field-MIXSRC_FIRST_TELEM)/3].isAvailable()) {
-          // we don't display GPS name, no space for it
-        }
-        else {
-          putsMixerSource(pos[j], 1+FH+2*FH*i, field, 0);
-        }
-        
         if (field >= MIXSRC_FIRST_TELEM) {
           TelemetryItem & telemetryItem = telemetryItems[(field-MIXSRC_FIRST_TELEM)/3]; // TODO macro to convert a source to a telemetry index
           if (!telemetryItem.isAvailable()) {
@@ -404,7 +477,7 @@ bool displayNumbersTelemetryScreen(FrSkyScreenData & screen)
           }
         }
 
-        putsChannel(pos[j+1]-2, (i==3 ? 1+FH+2*FH*i:FH+2*FH*i), field, att);
+        putsChannel(numbersScreenPos[j+1]-2, (i==3 ? 1+FH+2*FH*i:FH+2*FH*i), field, att);
 
       }
     }
@@ -569,6 +642,13 @@ void menuTelemetryFrsky(uint8_t event)
 #endif
 
   switch (event) {
+#if defined(PCBTARANIS)
+    case EVT_ENTRY:
+    case EVT_ENTRY_UP:
+      reusableBuffer.telemetry.view = TELEMETRY_BACKGROUND_INVALID;
+      break;
+#endif
+
     case EVT_KEY_FIRST(KEY_EXIT):
       killEvents(event);
       chainMenu(menuMainView);
@@ -293,6 +293,11 @@ void lcd_img(coord_t x, coord_t y, const pm_uchar * img, uint8_t idx, LcdFlags a
 #if defined(PCBTARANIS)
   void lcd_bmp(coord_t x, coord_t y, const uint8_t * img, coord_t offset=0, coord_t width=0);
   #define LCD_ICON(x, y, icon) lcd_bmp(x, y, icons, icon)
+  // Offscreen surfaces use the lcd_bmp() format and are drawn with lcd_bmp(), which
+  // writes whole rows (the line below a surface of odd height is cleared)
+  #define LCD_SURFACE_SIZE(w, h) (2 + (w) * (((h)+1)/2))
+  void lcdSurfaceBegin(uint8_t * surface, coord_t x, coord_t y, coord_t w, coord_t h);
+  void lcdSurfaceEnd();
 #endif
 
 void lcdSetRefVolt(unsigned char val);
@@ -317,6 +322,18 @@ void lcdSetContrast();
 
 #if defined(PCBTARANIS)
   const pm_char * bmpLoad(uint8_t *dest, const char *filename, const unsigned int width, const unsigned int height);
+  // bmpLoad() keeps the last decoded bitmaps in RAM, keyed by path and size
+  #if !defined(BMP_CACHE_SIZE)
+    #define BMP_CACHE_SIZE      8192
+  #endif
+  #define BMP_CACHE_ENTRIES     8
+  void bmpFlushCache();
+  struct BmpCacheStats {
+    uint16_t hits;
+    uint16_t misses;
+    uint16_t evictions;
+  };
+  extern BmpCacheStats bmpCacheStats;
 #endif
 
 #if defined(BOOT)
@@ -54,7 +54,55 @@ coord_t lcdLastPos;
 coord_t lcdNextPos;
 
 #if defined(CPUARM)
-void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+#if defined(PCBTARANIS)
+  #define LCD_LINES_PER_BYTE  2
+#else
+  #define LCD_LINES_PER_BYTE  8
+#endif
+
+// Moves a column mask (bit 0 = the line above the glyph) to screen lines
+// (bit n = line n), the lines outside the screen are dropped
+#if LCD_H != 64
+  #error "the glyph columns are blitted through a uint64_t mask of the screen lines"
+#endif
+inline uint64_t lcdGlyphToScreen(uint64_t bits, int y)
+{
+  int shift = y - 1;
+  if (shift >= 0)
+    return (shift < 64 ? bits << shift : 0);
+  else
+    return (-shift < 64 ? bits >> -shift : 0);
+}
+
+// Writes the lines selected by mask in one column of displayBuf, starting at
+// the byte row 'row'. mask and value are already shifted to this byte row.
+inline void lcdBlitColumn(coord_t x, unsigned int row, unsigned int count, uint64_t mask, uint64_t value)
+{
+#if defined(PCBTARANIS)
+  static const uint8_t nibbles[4] = { 0x00, 0x0F, 0xF0, 0xFF };
+  if (x < 0) return;
+  uint8_t * p = &displayBuf[row * LCD_W + x];
+  while (count--) {
+    ASSERT_IN_DISPLAY(p);
+    *p = (*p & ~nibbles[mask & 0x03]) | nibbles[value & 0x03];
+    mask >>= 2;
+    value >>= 2;
+    p += LCD_W;
+  }
+#else
+  uint8_t * p = &displayBuf[row * LCD_W + x];
+  while (count--) {
+    ASSERT_IN_DISPLAY(p);
+    *p = (*p & ~(uint8_t)mask) | (uint8_t)value;
+    mask >>= 8;
+    value >>= 8;
+    p += LCD_W;
+  }
+#endif
+}
+
+template<unsigned int LINES>
+void lcdPutGlyph(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
 {
   bool blink = false;
   bool inv = false;
@@ -71,12 +119,34 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
     inv = true;
   }
 
-  uint8_t lines = (height+7)/8;
-  assert(lines <= 5);
+  // The lines written in each column are the same for the whole glyph:
+  // bit 0 is the line above the glyph (only when INVERS), then the glyph
+  // lines and the line below the glyph (fonts under 12 lines and SMLSIZE)
+  uint64_t rows = (((uint64_t)1 << height) - 1) << 1;
+  uint64_t font = rows;
+  if (FONTSIZE(flags) == SMLSIZE) {
+    rows |= (uint64_t)1 << (height+1);
+    font = rows;
+  }
+  else if (height < 12) {
+    rows |= (uint64_t)1 << (height+1);
+  }
+  if (height < 12 && inv) {
+    rows |= 1;
+  }
+
+  // Clipping against the screen lines is done once for the glyph
+  uint64_t screenRows = lcdGlyphToScreen(rows, y);
+  unsigned int first = 0, count = 0;
+  if (screenRows) {
+    first = __builtin_ctzll(screenRows) / LCD_LINES_PER_BYTE;
+    count = (63 - __builtin_clzll(screenRows)) / LCD_LINES_PER_BYTE + 1 - first;
+    screenRows >>= first * LCD_LINES_PER_BYTE;
+  }
 
   for (int8_t i=0; i<width+2; i++) {
     if (x<LCD_W) {
-      uint8_t b[5] = { 0 };
+      uint64_t b = 0;
       if (i==0) {
         if (x==0 || !inv) {
           lcdNextPos++;
@@ -88,18 +158,12 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
         }
       }
       else if (i<=width) {
-        uint8_t skip = true;
-        for (uint8_t j=0; j<lines; j++) {
-          b[j] = pgm_read_byte(pattern++); /*top byte*/
-          if (b[j] != 0xff) {
-            skip = false;
-          }
+        for (unsigned int j=0; j<LINES; j++) {
+          b |= (uint64_t)pgm_read_byte(pattern++) << (8*j);
         }
-        if (skip) {
+        if (b == ((uint64_t)1 << (8*LINES)) - 1) {
           if (flags & FIXEDWIDTH) {
-            for (uint8_t j=0; j<lines; j++) {
-              b[j] = 0;
-            }
+            b = 0;
           }
           else {
             continue;
@@ -111,25 +175,19 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
         }
       }
 
-      for (int8_t j=-1; j<=height; j++) {
-        bool plot;
-        if (j < 0 || ((j == height) && !(FONTSIZE(flags) == SMLSIZE))) {
-          plot = false;
-          if (height >= 12) continue;
-          if (j<0 && !inv) continue;
-          if (y+j < 0) continue;
-        }
-        else {
-          uint8_t line = (j / 8);
-          uint8_t pixel = (j % 8);
-          plot = b[line] & (1 << pixel);
+      if (!blink) {
+        uint64_t value = (b << 1) & font;
+        if (inv) value ^= rows;
+        if (flags & VERTICAL) {
+          for (int8_t j=-1; j<=height; j++) {
+            if ((rows & ((uint64_t)1 << (j+1))) && y+j >= 0) {
+              lcd_plot(y+j, LCD_H-x, (value & ((uint64_t)1 << (j+1))) ? FORCE : ERASE);
+            }
+          }
         }
-        if (inv) plot = !plot;
-        if (!blink) {
-          if (flags & VERTICAL)
-            lcd_plot(y+j, LCD_H-x, plot ? FORCE : ERASE);
-          else
-            lcd_plot(x, y+j, plot ? FORCE : ERASE);
+        else if (count) {
+          value = lcdGlyphToScreen(value, y) >> (first * LCD_LINES_PER_BYTE);
+          lcdBlitColumn(x, first, count, screenRows, value);
         }
       }
     }
@@ -139,6 +197,19 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
   }
 }
 
+void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+{
+  uint8_t lines = (height+7)/8;
+  assert(lines == 1 || lines == 2 || lines == 5);
+
+  if (lines == 1)
+    lcdPutGlyph<1>(x, y, pattern, width, height, flags);
+  else if (lines == 2)
+    lcdPutGlyph<2>(x, y, pattern, width, height, flags);
+  else
+    lcdPutGlyph<5>(x, y, pattern, width, height, flags);
+}
+
 void lcd_putcAtt(coord_t x, coord_t y, const unsigned char c, LcdFlags flags)
 {
   const pm_uchar * q;
@@ -579,6 +650,7 @@ void lcd_rect(coord_t x, coord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags
 }
 
 #if !defined(BOOT)
+#if !defined(PCBTARANIS)
 void lcd_filled_rect(coord_t x, scoord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags att)
 {
 #if defined(CPUM64)
@@ -596,6 +668,7 @@ void lcd_filled_rect(coord_t x, scoord_t y, coord_t w, coord_t h, uint8_t pat, L
   }
 #endif
 }
+#endif
 
 #if defined(PCBTARANIS)
 void lcdDrawTelemetryTopBar()
@@ -72,31 +72,129 @@ void lcd_plot(coord_t x, coord_t y, LcdFlags att)
   }
 }
 
-void lcd_hlineStip(coord_t x, coord_t y, coord_t w, uint8_t pat, LcdFlags att)
+typedef uint32_t __attribute__((__may_alias__)) lcd_word_t;
+
+// The nibbles of value which are not 0 (lit pixels)
+inline uint8_t lcdLitNibbles(uint8_t value)
 {
-  if (y >= LCD_H) return;
-  if (x+w > LCD_W) { 
-    if (x >= LCD_W ) return;
-    w = LCD_W - x; 
+  return ((value & 0x0F) ? 0x0F : 0) | ((value & 0xF0) ? 0xF0 : 0);
+}
+
+inline uint32_t lcdLitNibbles(uint32_t value)
+{
+  uint32_t lit = ((((value & 0x77777777) + 0x77777777) | value) & 0x88888888) >> 3;
+  return (lit << 4) - lit;
+}
+
+// Same as lcd_mask() on a value, OP being att & (FORCE|ERASE|FILL_WHITE)
+template<LcdFlags OP, class T>
+inline T lcdMaskValue(T value, T mask)
+{
+  if (OP & FILL_WHITE)
+    mask &= ~lcdLitNibbles(value);
+  if (OP & FORCE)
+    return value | mask;
+  else if (OP & ERASE)
+    return value & ~mask;
+  else
+    return value ^ mask;
+}
+
+// Applies masks to w consecutive bytes, masks[i] being used for the bytes
+// where offset % 8 == i (masks[8..15] are a copy of masks[0..7]).
+// The middle of the span is done with 32 bits words.
+template<LcdFlags OP>
+void lcdMaskSpan(uint8_t * p, coord_t w, const uint8_t * masks)
+{
+  uint8_t * end = p + w;
+  unsigned int phase = 0;
+
+  while (p < end && ((uintptr_t)p & 3)) {
+    *p = lcdMaskValue<OP, uint8_t>(*p, masks[phase]);
+    p++;
+    phase = (phase + 1) & 7;
   }
 
-  uint8_t *p  = &displayBuf[ y / 2 * LCD_W + x ];
-  uint8_t mask = PIXEL_GREY_MASK(y, att);
-  while (w--) {
-    if (pat&1) {
-      lcd_mask(p, mask, att);
-      pat = (pat >> 1) | 0x80;
-    }
-    else {
-      pat = pat >> 1;
-    }
+  uint32_t mask0, mask1;
+  memcpy(&mask0, &masks[phase], sizeof(mask0));
+  memcpy(&mask1, &masks[phase+4], sizeof(mask1));
+  lcd_word_t * q = (lcd_word_t *)p;
+  while (end - (uint8_t *)q >= 8) {
+    q[0] = lcdMaskValue<OP, uint32_t>(q[0], mask0);
+    q[1] = lcdMaskValue<OP, uint32_t>(q[1], mask1);
+    q += 2;
+  }
+
+  p = (uint8_t *)q;
+  while (p < end) {
+    *p = lcdMaskValue<OP, uint8_t>(*p, masks[phase]);
     p++;
+    phase = (phase + 1) & 7;
   }
 }
 
+inline uint8_t lcdRotatePattern(uint8_t pat, unsigned int n)
+{
+  n &= 7;
+  return n ? (pat >> n) | (pat << (8-n)) : pat;
+}
+
+// Draws one byte row (lines 2*row and 2*row+1) between x and x+w-1, patEven
+// and patOdd being the stipple patterns of both lines (0 when not drawn)
+void lcdMaskRow(coord_t x, coord_t row, coord_t w, uint8_t patEven, uint8_t patOdd, LcdFlags att)
+{
+  if (x < 0) {
+    patEven = lcdRotatePattern(patEven, -x);
+    patOdd = lcdRotatePattern(patOdd, -x);
+    w += x;
+    x = 0;
+  }
+  if (x+w > LCD_W) {
+    w = LCD_W - x;
+  }
+  if (w <= 0) return;
+
+  uint8_t maskEven = PIXEL_GREY_MASK(0, att);
+  uint8_t maskOdd = PIXEL_GREY_MASK(1, att);
+  uint8_t masks[16];
+  for (unsigned int i=0; i<16; i++) {
+    masks[i] = ((patEven & (1 << (i & 7))) ? maskEven : 0) | ((patOdd & (1 << (i & 7))) ? maskOdd : 0);
+  }
+
+  uint8_t * p = &displayBuf[row * LCD_W + x];
+  if (att & FORCE) {
+    if (att & FILL_WHITE)
+      lcdMaskSpan<FORCE|FILL_WHITE>(p, w, masks);
+    else
+      lcdMaskSpan<FORCE>(p, w, masks);
+  }
+  else if (att & ERASE) {
+    if (att & FILL_WHITE)
+      lcdMaskSpan<ERASE|FILL_WHITE>(p, w, masks);
+    else
+      lcdMaskSpan<ERASE>(p, w, masks);
+  }
+  else {
+    if (att & FILL_WHITE)
+      lcdMaskSpan<FILL_WHITE>(p, w, masks);
+    else
+      lcdMaskSpan<0>(p, w, masks);
+  }
+}
+
+void lcd_hlineStip(coord_t x, coord_t y, coord_t w, uint8_t pat, LcdFlags att)
+{
+  if (y < 0 || y >= LCD_H) return;
+
+  if (y & 1)
+    lcdMaskRow(x, y / 2, w, 0, pat, att);
+  else
+    lcdMaskRow(x, y / 2, w, pat, 0, att);
+}
+
 void lcd_vlineStip(coord_t x, scoord_t y, scoord_t h, uint8_t pat, LcdFlags att)
 {
-  if (x >= LCD_W) return;
+  if (x < 0 || x >= LCD_W) return;
   if (y >= LCD_H) return;
   if (h<0) { y+=h; h=-h; }
   if (y<0) { h+=y; y=0; if (h<=0) return; }
@@ -106,17 +204,51 @@ void lcd_vlineStip(coord_t x, scoord_t y, scoord_t h, uint8_t pat, LcdFlags att)
     pat = ~pat;
   }
 
-  while (h--) {
-    if (pat & 1) {
-      lcd_plot(x, y, att);
-      pat = (pat >> 1) | 0x80;
+  // both lines of a byte row are done with one mask
+  const uint8_t masks[2] = { (uint8_t)PIXEL_GREY_MASK(0, att), (uint8_t)PIXEL_GREY_MASK(1, att) };
+  uint8_t * p = &displayBuf[y / 2 * LCD_W + x];
+  while (h > 0) {
+    uint8_t mask = 0;
+    do {
+      if (pat & 1) {
+        mask |= masks[y & 1];
+        pat = (pat >> 1) | 0x80;
+      }
+      else {
+        pat = pat >> 1;
+      }
+      y++;
+      h--;
+    } while (h > 0 && (y & 1));
+    if (mask) {
+      lcd_mask(p, mask, att);
+    }
+    p += LCD_W;
+  }
+}
+
+#if !defined(BOOT)
+void lcd_filled_rect(coord_t x, scoord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags att)
+{
+  for (scoord_t i=y; i<y+h; i++) {
+    if ((att&ROUND) && (i==y || i==y+h-1)) {
+      lcd_hlineStip(x+1, i, w-2, pat, att);
+    }
+    else if (!(i & 1) && i+1 < y+h && !((att&ROUND) && i+1==y+h-1)) {
+      // the rectangle covers both lines of this byte row
+      if (i >= 0 && i < LCD_H) {
+        lcdMaskRow(x, i / 2, w, pat, lcdRotatePattern(pat, 1), att);
+      }
+      pat = lcdRotatePattern(pat, 1);
+      i++;
     }
     else {
-      pat = pat >> 1;
+      lcd_hlineStip(x, i, w, pat, att);
     }
-    y++;
+    pat = (pat >> 1) + ((pat & 1) << 7);
   }
 }
+#endif
 
 void lcd_invert_line(int8_t line)
 {
@@ -164,18 +296,97 @@ void lcd_bmp(coord_t x, coord_t y, const uint8_t * img, coord_t offset, coord_t
   for (uint8_t row=0; row<rows; row++) {
     q = img + 2 + row*w + offset;
     uint8_t *p = &displayBuf[(row + (y/2)) * LCD_W + x];
-    for (coord_t i=0; i<width; i++) {
-      if ((p) >= DISPLAY_END) return;
-      uint8_t b = *q++;
-      if (y & 1) {
+    if (y & 1) {
+      for (coord_t i=0; i<width; i++) {
+        if ((p) >= DISPLAY_END) return;
+        uint8_t b = *q++;
         *p = (*p & 0x0f) + ((b & 0x0f) << 4);
-        *(p+LCD_W) = (*(p+LCD_W) & 0xf0) + ((b & 0xf0) >> 4);
+        if (p+LCD_W < DISPLAY_END) {
+          *(p+LCD_W) = (*(p+LCD_W) & 0xf0) + ((b & 0xf0) >> 4);
+        }
+        p++;
       }
-      else {
-        *p = b;
+    }
+    else {
+      if (p >= DISPLAY_END) return;
+      memcpy(p, q, width);
+    }
+  }
+}
+
+/*
+ * Offscreen surfaces
+ *
+ * lcdSurfaceBegin() saves the screen area into the surface and clears it, everything drawn
+ * inside the area until lcdSurfaceEnd() is then moved into the surface and the screen area
+ * gets its previous content back. Only one surface may be rendered at a time.
+ */
+static uint8_t * lcdSurface = NULL;
+static coord_t lcdSurfaceX, lcdSurfaceY;
+
+// Exchanges the surface pixels with the screen area at x, y
+void lcdSurfaceSwap(uint8_t * surface, coord_t x, coord_t y)
+{
+  coord_t w = surface[0];
+  coord_t h = surface[1];
+
+  for (coord_t line=0; line<h; ) {
+    uint8_t * p = &displayBuf[((y+line)/2) * LCD_W + x];
+    uint8_t * q = &surface[2 + (line/2) * w];
+    if (!(y & 1) && line+1 < h) {
+      // whole bytes when the surface rows are aligned with the screen rows
+      for (coord_t i=0; i<w; i++) {
+        uint8_t b = p[i];
+        p[i] = q[i];
+        q[i] = b;
       }
-      p++;
+      line += 2;
     }
+    else {
+      uint8_t ps = ((y+line) & 1) ? 4 : 0;
+      uint8_t qs = (line & 1) ? 4 : 0;
+      for (coord_t i=0; i<w; i++) {
+        uint8_t a = (p[i] >> ps) & 0x0f;
+        uint8_t b = (q[i] >> qs) & 0x0f;
+        p[i] = (p[i] & ~(0x0f << ps)) | (b << ps);
+        q[i] = (q[i] & ~(0x0f << qs)) | (a << qs);
+      }
+      line += 1;
+    }
+  }
+}
+
+void lcdSurfaceBegin(uint8_t * surface, coord_t x, coord_t y, coord_t w, coord_t h)
+{
+  lcdSurfaceEnd();
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x+w > LCD_W) w = LCD_W - x;
+  if (y+h > LCD_H) h = LCD_H - y;
+  if (w <= 0 || h <= 0) w = h = 0;
+
+  surface[0] = w;
+  surface[1] = h;
+  if (h & 1) {
+    // the unused half of the last row, lcd_bmp() writes it on odd lines
+    memset(&surface[2 + (h/2) * w], 0, w);
+  }
+  lcdSurfaceSwap(surface, x, y);
+  if (w > 0) {
+    lcd_filled_rect(x, y, w, h, SOLID, ERASE);
+  }
+
+  lcdSurface = surface;
+  lcdSurfaceX = x;
+  lcdSurfaceY = y;
+}
+
+void lcdSurfaceEnd()
+{
+  if (lcdSurface) {
+    lcdSurfaceSwap(lcdSurface, lcdSurfaceX, lcdSurfaceY);
+    lcdSurface = NULL;
   }
 }
 #endif
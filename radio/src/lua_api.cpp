@@ -129,6 +129,14 @@ static int luaGetDateTime(lua_State *L)
   return 1;
 }
 
+static void luaPushTelemetryValue(const TelemetrySensor & telemetrySensor, int32_t value)
+{
+  if (telemetrySensor.prec > 0)
+    lua_pushnumber(L, float(value)/(telemetrySensor.prec == 2 ? 100.0 : 10.0));
+  else
+    lua_pushinteger(L, value);
+}
+
 static void luaGetValueAndPush(int src)
 {
   getvalue_t value = getValue(src);
@@ -137,11 +145,7 @@ static void luaGetValueAndPush(int src)
     src = (src-MIXSRC_FIRST_TELEM) / 3;
     // telemetry values
     if (TELEMETRY_STREAMING() && telemetryItems[src].isAvailable()) {
-      TelemetrySensor & telemetrySensor = g_model.telemetrySensors[src];
-      if (telemetrySensor.prec > 0)
-        lua_pushnumber(L, float(value)/(telemetrySensor.prec == 2 ? 100.0 : 10.0));
-      else
-        lua_pushinteger(L, value);
+      luaPushTelemetryValue(g_model.telemetrySensors[src], value);
     }
     else {
       // telemetry not working, return zero for telemetry sources
@@ -153,6 +157,69 @@ static void luaGetValueAndPush(int src)
   }
 }
 
+// History of a telemetry source: "avg", "slope" (per second), "p<percent>" (p0..p100)
+// or "samples" (a table, oldest first). nil until samples have been recorded.
+static void luaGetHistoryAndPush(int src, const char * selector, int scale)
+{
+  if (src < MIXSRC_FIRST_TELEM || src > MIXSRC_LAST_TELEM || scale < 0 || scale >= TELEMETRY_HISTORY_SCALES) {
+    lua_pushnil(L);
+    return;
+  }
+
+  uint8_t index = (src-MIXSRC_FIRST_TELEM) / 3;
+  if (!isTelemetryFieldAvailable(index)) {
+    // no history slot is taken for a sensor which doesn't exist
+    lua_pushnil(L);
+    return;
+  }
+
+  TelemetrySensor & telemetrySensor = g_model.telemetrySensors[index];
+  TelemetryHistory * history = getTelemetryHistory(index);
+  if (!history) {
+    lua_pushnil(L);
+    return;
+  }
+
+  if (!strcmp(selector, "samples")) {
+    const TelemetryHistoryRing & ring = history->scales[scale];
+    lua_newtable(L);
+    for (int i=0; i<ring.count; i++) {
+      lua_pushinteger(L, i+1);
+      luaPushTelemetryValue(telemetrySensor, ring.get(ring.count-1-i));
+      lua_settable(L, -3);
+    }
+    return;
+  }
+
+  uint8_t stat, percent = 0;
+  if (!strcmp(selector, "avg")) {
+    stat = TELEM_HISTORY_AVERAGE;
+  }
+  else if (!strcmp(selector, "slope")) {
+    stat = TELEM_HISTORY_SLOPE;
+  }
+  else if (selector[0] == 'p') {
+    char * end;
+    long value = strtol(selector+1, &end, 10);
+    if (end == selector+1 || *end || value < 0 || value > 100) {
+      luaL_error(L, "invalid percentile '%s' (p0..p100)", selector);
+      return;
+    }
+    stat = TELEM_HISTORY_PERCENTILE;
+    percent = value;
+  }
+  else {
+    luaL_error(L, "unknown history selector '%s'", selector);
+    return;
+  }
+
+  int32_t value;
+  if (getTelemetryHistoryValue(index, stat, scale, percent, value))
+    luaPushTelemetryValue(telemetrySensor, value);
+  else
+    lua_pushnil(L);
+}
+
 struct LuaField {
   uint16_t id;
   char desc[50];
@@ -270,7 +337,10 @@ static int luaGetValue(lua_State *L)
       src = field.id;
     }
   }
-  luaGetValueAndPush(src);
+  if (lua_gettop(L) > 1)
+    luaGetHistoryAndPush(src, luaL_checkstring(L, 2), luaL_optinteger(L, 3, 0));
+  else
+    luaGetValueAndPush(src);
   return 1;
 }
 
@@ -475,6 +545,73 @@ static int luaLcdDrawPixmap(lua_State *L)
   return 0;
 }
 
+#define LUA_SURFACE "SURFACE"
+
+// the surface being rendered is referenced, so the GC can't free it before endSurface
+static int luaSurfaceRef = LUA_NOREF;
+
+static uint8_t * luaCheckSurface(lua_State *L, int index)
+{
+  return (uint8_t *)luaL_checkudata(L, index, LUA_SURFACE);
+}
+
+static void luaSurfaceEnd()
+{
+  lcdSurfaceEnd();
+  if (L && luaSurfaceRef != LUA_NOREF) {
+    luaL_unref(L, LUA_REGISTRYINDEX, luaSurfaceRef);
+  }
+  luaSurfaceRef = LUA_NOREF;
+}
+
+static int luaLcdCreateSurface(lua_State *L)
+{
+  int w = luaL_checkinteger(L, 1);
+  int h = luaL_checkinteger(L, 2);
+  luaL_argcheck(L, w > 0 && w <= LCD_W, 1, "invalid width");
+  luaL_argcheck(L, h > 0 && h <= LCD_H, 2, "invalid height");
+  // the requested size is kept in front of the surface, which may be clipped when rendered
+  uint8_t * data = (uint8_t *)lua_newuserdata(L, LCD_SURFACE_SIZE(w, h) + 2);
+  memset(data, 0, LCD_SURFACE_SIZE(w, h) + 2);
+  data[0] = w;
+  data[1] = h;
+  luaL_newmetatable(L, LUA_SURFACE); // created on the first call
+  lua_setmetatable(L, -2);
+  return 1;
+}
+
+static int luaLcdBeginSurface(lua_State *L)
+{
+  uint8_t * data = luaCheckSurface(L, 1);
+  int x = luaL_checkinteger(L, 2);
+  int y = luaL_checkinteger(L, 3);
+  if (!luaLcdAllowed) return 0;
+  luaSurfaceEnd();
+  lua_pushvalue(L, 1);
+  luaSurfaceRef = luaL_ref(L, LUA_REGISTRYINDEX);
+  lcdSurfaceBegin(data+2, x, y, data[0], data[1]);
+  return 0;
+}
+
+static int luaLcdEndSurface(lua_State *L)
+{
+  luaSurfaceEnd();
+  return 0;
+}
+
+static int luaLcdDrawSurface(lua_State *L)
+{
+  if (!luaLcdAllowed) return 0;
+  int x = luaL_checkinteger(L, 1);
+  int y = luaL_checkinteger(L, 2);
+  uint8_t * data = luaCheckSurface(L, 3);
+  if (data[3] > 0) {
+    // nothing to draw until the surface has been rendered once
+    lcd_bmp(x, y, data+2);
+  }
+  return 0;
+}
+
 static int luaLcdDrawRectangle(lua_State *L)
 {
   if (!luaLcdAllowed) return 0;
@@ -647,7 +784,7 @@ static int luaModelSetTimer(lua_State *L)
         timer.start = luaL_checkinteger(L, -1);
       }
       else if (!strcmp(key, "value")) {
-        timersStates[idx].val = luaL_checkinteger(L, -1);
+        timerSet(idx, luaL_checkinteger(L, -1));
       }
       else if (!strcmp(key, "countdownBeep")) {
         timer.countdownBeep = luaL_checkinteger(L, -1);
@@ -1450,11 +1587,17 @@ const luaL_Reg lcdLib[] = {
   { "drawPixmap", luaLcdDrawPixmap },
   { "drawScreenTitle", luaLcdDrawScreenTitle },
   { "drawCombobox", luaLcdDrawCombobox },
+  { "createSurface", luaLcdCreateSurface },
+  { "beginSurface", luaLcdBeginSurface },
+  { "endSurface", luaLcdEndSurface },
+  { "drawSurface", luaLcdDrawSurface },
   { NULL, NULL }  /* sentinel */
 };
 
 void luaDisable()
 {
+  lcdSurfaceEnd();
+  luaSurfaceRef = LUA_NOREF; // the interpreter will be closed
   POPUP_WARNING("Lua disabled!");
   luaState = INTERPRETER_PANIC;
 }
@@ -1989,6 +2132,7 @@ bool luaTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage)
       //todo gc step between scripts
     }
   }
+  luaSurfaceEnd(); // a script may not leave a surface pointing to Lua memory
   luaDoGc();
   return scriptWasRun;
 }
@@ -105,7 +105,11 @@ void perMain()
   checkSpeakerVolume();
   checkEeprom();
   sdMountPoll();
+  checkTimersJournal();
   writeLogs();
+#if defined(TELEMETRY_CAPTURE)
+  telemetryCaptureWakeup();
+#endif
   handleUsbConnection();
   checkTrainerSettings();
   checkBattery();
@@ -184,5 +188,6 @@ void perMain()
     }
     drawStatusLine();
   }
+  COMMIT_MODEL_CACHES(); // the values edited above are now stored
   lcdRefresh();
 }
@@ -68,6 +68,127 @@ int16_t ex_chans[NUM_CHNOUT] = {0}; // Outputs (before LIMITS) of the last perMa
   #endif
 #endif
 
+#if defined(CPUARM)
+// Flight modes fade: the values which don't depend on the flight mode (the raw
+// inputs, the sources and curves of most expos and mixes lines) are computed
+// by the first flight mode evaluated in the cycle, and reused by the others
+#define FADE_VALUE_SHARED   0x01  // the line source doesn't depend on the flight mode
+#define FADE_CURVE_SHARED   0x02  // nor the curve and its input
+#define FADE_VALUE_CACHED   0x04
+#define FADE_CURVE_CACHED   0x08
+
+struct FadeLineCache {
+  uint8_t    flags;
+  getvalue_t value;
+  getvalue_t curve;
+};
+
+struct FadeCache {
+  bool active;
+  FadeLineCache expos[MAX_EXPOS];
+  FadeLineCache mixes[MAX_MIXERS];
+#if defined(PCBTARANIS) && defined(HELI)
+  int16_t heliAnas[4];
+#endif
+};
+
+FadeCache fadeCache;
+
+#define FADE_CACHE_ACTIVE(mode)  (fadeCache.active && (mode) <= e_perout_mode_inactive_flight_mode)
+
+bool isFadeSwitchShared(int8_t swtch)
+{
+  swtch = abs(swtch);
+  return swtch < SWSRC_FIRST_LOGICAL_SWITCH || swtch == SWSRC_ON || swtch == SWSRC_One;
+}
+
+bool isFadeSourceShared(mixsrc_t source, uint32_t sharedInputs)
+{
+#if defined(PCBTARANIS)
+  if (source >= MIXSRC_FIRST_INPUT && source <= MIXSRC_LAST_INPUT)
+    return sharedInputs & ((uint32_t)1 << (source - MIXSRC_FIRST_INPUT));
+#endif
+  if (source >= MIXSRC_CYC1 && source <= MIXSRC_TrimAil)
+    return false; // the swash mixing uses the trims
+  if (source >= MIXSRC_FIRST_LOGICAL_SWITCH && source <= MIXSRC_LAST_LOGICAL_SWITCH)
+    return false;
+  if (source >= MIXSRC_FIRST_CH && source <= MIXSRC_LAST_GVAR)
+    return false;
+  return true;
+}
+
+#if defined(PCBTARANIS)
+bool isFadeCurveShared(const CurveRef & curve)
+{
+  return (curve.type != CURVE_REF_DIFF && curve.type != CURVE_REF_EXPO) || !GV_IS_GV_VALUE(curve.value, -100, 100);
+}
+#endif
+
+// Finds which expos and mixes lines give the same result in all flight modes.
+// Trims, GVars, speeds and channels sources are flight mode dependent.
+void initFadeCache()
+{
+  uint32_t sharedInputs = 0;
+  uint32_t dependentInputs = 0;
+
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break;
+    uint8_t flags = 0;
+#if defined(PCBTARANIS)
+    if (ed->srcRaw > MIXSRC_LAST_INPUT && isFadeSourceShared(ed->srcRaw, 0)) {
+      flags = FADE_VALUE_SHARED;
+      if (isFadeCurveShared(ed->curve))
+        flags |= FADE_CURVE_SHARED;
+    }
+    bool shared = (flags & FADE_CURVE_SHARED) && !GV_IS_GV_VALUE(ed->offset, -100, 100);
+#else
+    flags = FADE_VALUE_SHARED;
+    if (ed->curveMode == MODE_CURVE || !GV_IS_GV_VALUE(ed->curveParam, -100, 100))
+      flags |= FADE_CURVE_SHARED;
+    bool shared = (flags & FADE_CURVE_SHARED);
+#endif
+    fadeCache.expos[i].flags = flags;
+    // an input is shared when the same lines are active in all flight modes, with the same result
+    if (!shared || ed->flightModes || !isFadeSwitchShared(ed->swtch) || GV_IS_GV_VALUE(ed->weight, MIN_EXPO_WEIGHT, 100))
+      dependentInputs |= ((uint32_t)1 << ed->chn);
+    else
+      sharedInputs |= ((uint32_t)1 << ed->chn);
+  }
+
+#if defined(HELI) && !defined(PCBTARANIS)
+  // the swash ring mixes the elevator and aileron inputs together
+  if (g_model.swashR.value && (dependentInputs & (((uint32_t)1 << ELE_STICK) | ((uint32_t)1 << AIL_STICK))))
+    dependentInputs |= ((uint32_t)1 << ELE_STICK) | ((uint32_t)1 << AIL_STICK);
+#endif
+
+  sharedInputs &= ~dependentInputs;
+
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    if (md->srcRaw == 0) break;
+    uint8_t flags = 0;
+    uint8_t stickIndex = md->srcRaw - MIXSRC_Rud;
+#if defined(PCBTARANIS)
+    if (isFadeSourceShared(md->srcRaw, sharedInputs)) {
+      flags = FADE_VALUE_SHARED;
+      bool trims = (md->carryTrim == 0 && (stickIndex < NUM_STICKS || md->srcRaw <= MIXSRC_LAST_INPUT));
+      if (!trims && !md->speedUp && !md->speedDown && isFadeCurveShared(md->curve))
+        flags |= FADE_CURVE_SHARED;
+    }
+#else
+    if (stickIndex < NUM_STICKS ? (md->noExpo || (sharedInputs & ((uint32_t)1 << stickIndex))) : isFadeSourceShared(md->srcRaw, 0)) {
+      flags = FADE_VALUE_SHARED;
+      bool trims = (md->carryTrim < TRIM_ON || (md->carryTrim == TRIM_ON && stickIndex < NUM_STICKS));
+      if (!trims && !md->speedUp && !md->speedDown)
+        flags |= FADE_CURVE_SHARED;
+    }
+#endif
+    fadeCache.mixes[i].flags = flags;
+  }
+}
+#endif
+
 void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
 {
 #if defined(PCBTARANIS)
@@ -92,23 +213,35 @@ void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
       continue;
     if (ed->flightModes & (1<<mixerCurrentFlightMode))
       continue;
+#if defined(CPUARM)
+    uint8_t fadeFlags = (FADE_CACHE_ACTIVE(mode) ? fadeCache.expos[i].flags : 0);
+#endif
     if (getSwitch(ed->swtch)) {
 #if defined(PCBTARANIS)
       int v;
-      if (ed->srcRaw == ovwrIdx)
+      if (ed->srcRaw == ovwrIdx) {
         v = ovwrValue;
+        fadeFlags = 0;
+      }
 #if defined(HELI)
       else if (ed->srcRaw == MIXSRC_Ele)
         v = heliAnasCopy[ELE_STICK];
       else if (ed->srcRaw == MIXSRC_Ail)
         v = heliAnasCopy[AIL_STICK];
 #endif
+      else if (fadeFlags & FADE_VALUE_CACHED) {
+        v = fadeCache.expos[i].value;
+      }
       else {
         v = getValue(ed->srcRaw);
         if (ed->srcRaw >= MIXSRC_FIRST_TELEM && ed->scale > 0) {
           v = (v * 1024) / convertTelemValue(ed->srcRaw-MIXSRC_FIRST_TELEM+1, ed->scale);
         }
         v = limit(-1024, v, 1024);
+        if (fadeFlags & FADE_VALUE_SHARED) {
+          fadeCache.expos[i].value = v;
+          fadeCache.expos[i].flags |= FADE_VALUE_CACHED;
+        }
       }
 #else
       int16_t v = anas2[ed->chn];
@@ -120,19 +253,33 @@ void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
         cur_chn = ed->chn;
 
         //========== CURVE=================
-#if defined(PCBTARANIS)
-        if (ed->curve.value) {
-          v = applyCurve(v, ed->curve);
+#if defined(CPUARM)
+        if (fadeFlags & FADE_CURVE_CACHED) {
+          v = fadeCache.expos[i].curve;
         }
+        else
+#endif
+        {
+#if defined(PCBTARANIS)
+          if (ed->curve.value) {
+            v = applyCurve(v, ed->curve);
+          }
 #else
-        int8_t curveParam = ed->curveParam;
-        if (curveParam) {
-          if (ed->curveMode == MODE_CURVE)
-            v = applyCurve(v, curveParam);
-          else
-            v = expo(v, GET_GVAR(curveParam, -100, 100, mixerCurrentFlightMode));
-        }
+          int8_t curveParam = ed->curveParam;
+          if (curveParam) {
+            if (ed->curveMode == MODE_CURVE)
+              v = applyCurve(v, curveParam);
+            else
+              v = expo(v, GET_GVAR(curveParam, -100, 100, mixerCurrentFlightMode));
+          }
+#endif
+#if defined(CPUARM)
+          if (fadeFlags & FADE_CURVE_SHARED) {
+            fadeCache.expos[i].curve = v;
+            fadeCache.expos[i].flags |= FADE_CURVE_CACHED;
+          }
 #endif
+        }
 
         //========== WEIGHT ===============
         int16_t weight = GET_GVAR(ed->weight, MIN_EXPO_WEIGHT, 100, mixerCurrentFlightMode);
@@ -261,6 +408,113 @@ int16_t applyLimits(uint8_t channel, int32_t value)
   return ofs;
 }
 
+#if defined(CPUARM)
+// The LimitData of each channel compiled to the clamped offset, the limits
+// and the scale on each side, so that the mixer only does a multiply and a
+// clamp per channel. Same results as applyLimits().
+struct OutputStage {
+  int16_t ofs;
+  int16_t min;
+  int16_t max;
+  int16_t scale[2];  // [0] for negative values, [1] for positive values
+  int16_t zero;      // output for a 0 value (channels without mixes)
+#if defined(PCBTARANIS)
+  int8_t  curve;
+#endif
+  uint8_t revert;
+};
+
+OutputStage outputStages[NUM_CHNOUT];
+uint32_t outputStagesVersion = 0;
+uint32_t outputStagesGVarsVersion = 0; // only checked when a limit is a GVar
+bool outputStagesGVars = false;
+uint8_t outputStagesFlightMode = 0;
+
+void compileOutputStages()
+{
+  outputStagesGVars = false;
+
+  for (uint8_t i=0; i<NUM_CHNOUT; i++) {
+    LimitData * lim = limitAddress(i);
+    OutputStage & stage = outputStages[i];
+
+    if (LIMIT_USES_GVARS(lim)) outputStagesGVars = true;
+
+    int16_t ofs   = LIMIT_OFS_RESX(lim);
+    int16_t lim_p = LIMIT_MAX_RESX(lim);
+    int16_t lim_n = LIMIT_MIN_RESX(lim);
+
+    if (ofs > lim_p) ofs = lim_p;
+    if (ofs < lim_n) ofs = lim_n;
+
+    stage.ofs = ofs;
+    stage.min = lim_n;
+    stage.max = lim_p;
+#if defined(PPM_LIMITS_SYMETRICAL)
+    if (lim->symetrical) {
+      stage.scale[0] = -lim_n;
+      stage.scale[1] = lim_p;
+    }
+    else
+#endif
+    {
+      stage.scale[0] = -lim_n + ofs;
+      stage.scale[1] = lim_p - ofs;
+    }
+#if defined(PCBTARANIS)
+    stage.curve = lim->curve;
+#endif
+    stage.revert = lim->revert;
+    stage.zero = (lim->revert ? -ofs : ofs);
+  }
+
+  outputStagesVersion = MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS);
+  outputStagesGVarsVersion = MODEL_CACHE_VERSION(MODEL_CACHE_GVARS);
+  outputStagesFlightMode = mixerCurrentFlightMode;
+}
+
+int16_t applyOutputStage(uint8_t channel, int32_t value)
+{
+  const OutputStage & stage = outputStages[channel];
+  int16_t ofs;
+
+#if defined(PCBTARANIS)
+  if (stage.curve) {
+    if (stage.curve > 0)
+      value = 256 * applyCustomCurve(value/256, stage.curve-1);
+    else
+      value = 256 * applyCustomCurve(-value/256, -stage.curve-1);
+  }
+#endif
+
+  if (!value) {
+    ofs = stage.zero;
+  }
+  else {
+    // the same -RESXl*256..RESXl*256 limit as applyLimits(),
+    // then the result is rounded (half away from 0) instead of being truncated
+    value = limit(int32_t(-RESXl*256), value, int32_t(RESXl*256)) * stage.scale[value > 0];
+    ofs = stage.ofs + ((value + (1 << 17) - (value < 0)) >> 18);
+    if (ofs > stage.max) ofs = stage.max;
+    if (ofs < stage.min) ofs = stage.min;
+    if (stage.revert) ofs = -ofs;
+  }
+
+#if defined(OVERRIDE_CHANNEL_FUNCTION)
+  if (safetyCh[channel] != OVERRIDE_CHANNEL_UNDEFINED) {
+    ofs = calc100toRESX(safetyCh[channel]);
+  }
+#endif
+
+  return ofs;
+}
+#endif
+
+#if defined(PCBTARANIS)
+// the switches state seen by the current mixer cycle, see takeSwitchesSnapshot()
+#define SWITCH_SNAPSHOT_STATE(sw) (switchesSnapshotValid ? SWITCHES_SNAPSHOT_BIT(switchesSnapshot, (sw)-SW_BASE+SWSRC_FIRST_SWITCH) : switchState(sw))
+#endif
+
 // TODO same naming convention than the putsMixerSource
 
 getvalue_t getValue(mixsrc_t i)
@@ -274,7 +528,7 @@ getvalue_t getValue(mixsrc_t i)
 #endif
 
 #if defined(PCBTARANIS)
-  else if (i<MIXSRC_LAST_LUA) {
+  else if (i<=MIXSRC_LAST_LUA) {
 #if defined(LUA_MODEL_SCRIPTS)
     div_t qr = div(i-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
     return scriptInputsOutputs[qr.quot].outputs[qr.rem].value;
@@ -302,37 +556,37 @@ getvalue_t getValue(mixsrc_t i)
   else if (i<=MIXSRC_TrimAil) return calc1000toRESX((int16_t)8 * getTrimValue(mixerCurrentFlightMode, i-MIXSRC_TrimRud));
 
 #if defined(PCBTARANIS)
-  else if (i==MIXSRC_SA) return (switchState(SW_SA0) ? -1024 : (switchState(SW_SA1) ? 0 : 1024));
-  else if (i==MIXSRC_SB) return (switchState(SW_SB0) ? -1024 : (switchState(SW_SB1) ? 0 : 1024));
-  else if (i==MIXSRC_SC) return (switchState(SW_SC0) ? -1024 : (switchState(SW_SC1) ? 0 : 1024));
-  else if (i==MIXSRC_SD) return (switchState(SW_SD0) ? -1024 : (switchState(SW_SD1) ? 0 : 1024));
-  else if (i==MIXSRC_SE) return (switchState(SW_SE0) ? -1024 : (switchState(SW_SE1) ? 0 : 1024));
+  else if (i==MIXSRC_SA) return (SWITCH_SNAPSHOT_STATE(SW_SA0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SA1) ? 0 : 1024));
+  else if (i==MIXSRC_SB) return (SWITCH_SNAPSHOT_STATE(SW_SB0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SB1) ? 0 : 1024));
+  else if (i==MIXSRC_SC) return (SWITCH_SNAPSHOT_STATE(SW_SC0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SC1) ? 0 : 1024));
+  else if (i==MIXSRC_SD) return (SWITCH_SNAPSHOT_STATE(SW_SD0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SD1) ? 0 : 1024));
+  else if (i==MIXSRC_SE) return (SWITCH_SNAPSHOT_STATE(SW_SE0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SE1) ? 0 : 1024));
 #if defined(REV9E)
-  else if (i==MIXSRC_SF) return (switchState(SW_SF0) ? -1024 : (switchState(SW_SF1) ? 0 : 1024));
+  else if (i==MIXSRC_SF) return (SWITCH_SNAPSHOT_STATE(SW_SF0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SF1) ? 0 : 1024));
 #else
-  else if (i==MIXSRC_SF) return (switchState(SW_SF0) ? -1024 : 1024);
+  else if (i==MIXSRC_SF) return (SWITCH_SNAPSHOT_STATE(SW_SF0) ? -1024 : 1024);
 #endif
-  else if (i==MIXSRC_SG) return (switchState(SW_SG0) ? -1024 : (switchState(SW_SG1) ? 0 : 1024));
+  else if (i==MIXSRC_SG) return (SWITCH_SNAPSHOT_STATE(SW_SG0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SG1) ? 0 : 1024));
 #if defined(REV9E)
-  else if (i==MIXSRC_SH) return (switchState(SW_SH0) ? -1024 : (switchState(SW_SH1) ? 0 : 1024));
-  else if (i==MIXSRC_SI) return (switchState(SW_SI0) ? -1024 : (switchState(SW_SI1) ? 0 : 1024));
-  else if (i==MIXSRC_SJ) return (switchState(SW_SJ0) ? -1024 : (switchState(SW_SJ1) ? 0 : 1024));
-  else if (i==MIXSRC_SK) return (switchState(SW_SK0) ? -1024 : (switchState(SW_SK1) ? 0 : 1024));
-  else if (i==MIXSRC_SL) return (switchState(SW_SL0) ? -1024 : (switchState(SW_SL1) ? 0 : 1024));
-  else if (i==MIXSRC_SM) return (switchState(SW_SM0) ? -1024 : (switchState(SW_SM1) ? 0 : 1024));
-  else if (i==MIXSRC_SN) return (switchState(SW_SN0) ? -1024 : (switchState(SW_SN1) ? 0 : 1024));
-  else if (i==MIXSRC_SO) return (switchState(SW_SO0) ? -1024 : (switchState(SW_SO1) ? 0 : 1024));
-  else if (i==MIXSRC_SP) return (switchState(SW_SP0) ? -1024 : (switchState(SW_SP1) ? 0 : 1024));
-  else if (i==MIXSRC_SQ) return (switchState(SW_SQ0) ? -1024 : (switchState(SW_SQ1) ? 0 : 1024));
-  else if (i==MIXSRC_SR) return (switchState(SW_SR0) ? -1024 : (switchState(SW_SR1) ? 0 : 1024));
+  else if (i==MIXSRC_SH) return (SWITCH_SNAPSHOT_STATE(SW_SH0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SH1) ? 0 : 1024));
+  else if (i==MIXSRC_SI) return (SWITCH_SNAPSHOT_STATE(SW_SI0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SI1) ? 0 : 1024));
+  else if (i==MIXSRC_SJ) return (SWITCH_SNAPSHOT_STATE(SW_SJ0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SJ1) ? 0 : 1024));
+  else if (i==MIXSRC_SK) return (SWITCH_SNAPSHOT_STATE(SW_SK0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SK1) ? 0 : 1024));
+  else if (i==MIXSRC_SL) return (SWITCH_SNAPSHOT_STATE(SW_SL0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SL1) ? 0 : 1024));
+  else if (i==MIXSRC_SM) return (SWITCH_SNAPSHOT_STATE(SW_SM0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SM1) ? 0 : 1024));
+  else if (i==MIXSRC_SN) return (SWITCH_SNAPSHOT_STATE(SW_SN0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SN1) ? 0 : 1024));
+  else if (i==MIXSRC_SO) return (SWITCH_SNAPSHOT_STATE(SW_SO0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SO1) ? 0 : 1024));
+  else if (i==MIXSRC_SP) return (SWITCH_SNAPSHOT_STATE(SW_SP0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SP1) ? 0 : 1024));
+  else if (i==MIXSRC_SQ) return (SWITCH_SNAPSHOT_STATE(SW_SQ0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SQ1) ? 0 : 1024));
+  else if (i==MIXSRC_SR) return (SWITCH_SNAPSHOT_STATE(SW_SR0) ? -1024 : (SWITCH_SNAPSHOT_STATE(SW_SR1) ? 0 : 1024));
 #else
-  else if (i==MIXSRC_SH) return (switchState(SW_SH0) ? -1024 : 1024);
-  else if (i==MIXSRC_SI) return (switchState(SW_SI0) ? -1024 : 1024);
-  else if (i==MIXSRC_SJ) return (switchState(SW_SJ0) ? -1024 : 1024);
-  else if (i==MIXSRC_SK) return (switchState(SW_SK0) ? -1024 : 1024);
-  else if (i==MIXSRC_SL) return (switchState(SW_SL0) ? -1024 : 1024);
-  else if (i==MIXSRC_SM) return (switchState(SW_SM0) ? -1024 : 1024);
-  else if (i==MIXSRC_SN) return (switchState(SW_SN0) ? -1024 : 1024);
+  else if (i==MIXSRC_SH) return (SWITCH_SNAPSHOT_STATE(SW_SH0) ? -1024 : 1024);
+  else if (i==MIXSRC_SI) return (SWITCH_SNAPSHOT_STATE(SW_SI0) ? -1024 : 1024);
+  else if (i==MIXSRC_SJ) return (SWITCH_SNAPSHOT_STATE(SW_SJ0) ? -1024 : 1024);
+  else if (i==MIXSRC_SK) return (SWITCH_SNAPSHOT_STATE(SW_SK0) ? -1024 : 1024);
+  else if (i==MIXSRC_SL) return (SWITCH_SNAPSHOT_STATE(SW_SL0) ? -1024 : 1024);
+  else if (i==MIXSRC_SM) return (SWITCH_SNAPSHOT_STATE(SW_SM0) ? -1024 : 1024);
+  else if (i==MIXSRC_SN) return (SWITCH_SNAPSHOT_STATE(SW_SN0) ? -1024 : 1024);
 #endif
 #else
   else if (i==MIXSRC_3POS) return (getSwitch(SW_ID0-SW_BASE+1) ? -1024 : (getSwitch(SW_ID1-SW_BASE+1) ? 0 : 1024));
@@ -348,7 +602,7 @@ getvalue_t getValue(mixsrc_t i)
   else if (i<=MIXSRC_LAST_CH) return ex_chans[i-MIXSRC_CH1];
 
 #if defined(GVARS)
-  else if (i<=MIXSRC_LAST_GVAR) return GVAR_VALUE(i-MIXSRC_GVAR1, getGVarFlightPhase(mixerCurrentFlightMode, i-MIXSRC_GVAR1));
+  else if (i<=MIXSRC_LAST_GVAR) return GVAR_RESOLVED_VALUE(i-MIXSRC_GVAR1, mixerCurrentFlightMode);
 #endif
 
 #if defined(CPUARM)
@@ -418,7 +672,70 @@ getvalue_t getValue(mixsrc_t i)
   else return 0;
 }
 
-void evalInputs(uint8_t mode)
+#if defined(CPUARM)
+// The calibration of the sticks and pots compiled to the mid point and the
+// RESX/span reciprocals, with the stick mode and the pots inversion resolved,
+// so that the analogs are calibrated with a multiply instead of a division.
+// Only radio settings here, the throttle reverse is still applied by the mixer.
+InputsCalibration inputsCalibration;
+
+uint32_t calibrationMultiplier(int16_t span)
+{
+  uint32_t divisor = max<int16_t>(100, span);
+  return (uint32_t)(((1ull << 32) + divisor - 1) / divisor);
+}
+
+void compileInputsCalibration()
+{
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    uint8_t ch = (i < NUM_STICKS ? CONVERT_MODE(i) : i);
+    inputsCalibration.channel[i] = ch;
+
+#if defined(SIMU)
+    // the simulator analogs are already calibrated
+    inputsCalibration.mid[i] = 0;
+    inputsCalibration.mul[0][i] = inputsCalibration.mul[1][i] = calibrationMultiplier(RESX);
+#else
+    if (IS_POT_MULTIPOS(i)) {
+      inputsCalibration.mid[i] = RESX;
+      inputsCalibration.mul[0][i] = inputsCalibration.mul[1][i] = calibrationMultiplier(RESX);
+    }
+    else {
+      CalibData * calib = &g_eeGeneral.calib[i];
+      inputsCalibration.mid[i] = calib->mid;
+      inputsCalibration.mul[0][i] = calibrationMultiplier(calib->spanNeg);
+      inputsCalibration.mul[1][i] = calibrationMultiplier(calib->spanPos);
+    }
+#endif
+
+#if defined(PCBTARANIS)
+    inputsCalibration.invert[i] = (i==POT1 || i==SLIDER1);
+#else
+    inputsCalibration.invert[i] = false;
+#endif
+  }
+
+  inputsCalibration.version = MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION);
+  inputsCalibration.stickMode = stickMode;
+}
+
+void calibrateInputs(int16_t * values)
+{
+  if (inputsCalibration.version != MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION) || inputsCalibration.stickMode != stickMode) {
+    compileInputsCalibration();
+  }
+
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    int32_t v = (int16_t)anaIn(i) - inputsCalibration.mid[i]; // the simulator analogs are -RESX..RESX
+    v = applyCalibration(v, inputsCalibration.mul[v > 0][i]);
+    v = limit<int32_t>(-RESX, v, RESX);
+    values[i] = (inputsCalibration.invert[i] ? -v : v);
+  }
+}
+#endif
+
+// Sticks, pots and trainer, independent of the flight mode
+void evalRawInputs(uint8_t mode)
 {
   BeepANACenter anaCenter = 0;
 
@@ -434,8 +751,26 @@ void evalInputs(uint8_t mode)
   }
 #endif
 
+#if defined(CPUARM)
+  int16_t calibratedAnalogs[NUM_STICKS+NUM_POTS];
+  calibrateInputs(calibratedAnalogs);
+#endif
+
   for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_ROTARY_ENCODERS; i++) {
 
+#if defined(CPUARM)
+    // the sticks and pots are already calibrated and normalized
+    uint8_t ch = (i < NUM_STICKS+NUM_POTS ? inputsCalibration.channel[i] : i);
+#if defined(ROTARY_ENCODERS)
+    int16_t v = ((i < NUM_STICKS+NUM_POTS) ? calibratedAnalogs[i] : limit<int16_t>(-RESX, getRotaryEncoder(i-(NUM_STICKS+NUM_POTS)), RESX));
+#else
+    int16_t v = calibratedAnalogs[i];
+#endif
+
+    if (g_model.throttleReversed && ch==THR_STICK) {
+      v = -v;
+    }
+#else
     // normalization [0..2048] -> [-1024..1024]
     uint8_t ch = (i < NUM_STICKS ? CONVERT_MODE(i) : i);
 
@@ -461,15 +796,10 @@ void evalInputs(uint8_t mode)
     if (v < -RESX) v = -RESX;
     if (v >  RESX) v =  RESX;
 
-#if defined(PCBTARANIS)
-    if (i==POT1 || i==SLIDER1) {
-      v = -v;
-    }
-#endif
-
     if (g_model.throttleReversed && ch==THR_STICK) {
       v = -v;
     }
+#endif
 
 #if defined(EXTRA_3POS)
     if (i == POT1+EXTRA_3POS-1) {
@@ -551,12 +881,6 @@ void evalInputs(uint8_t mode)
     }
   }
 
-  /* EXPOs */
-  applyExpos(anas, mode);
-
-  /* TRIMs */
-  evalTrims(); // when no virtual inputs, the trims need the anas array calculated above (when throttle trim enabled)
-
   if (mode == e_perout_mode_normal) {
 #if !defined(CPUARM)
     anaCenter &= g_model.beepANACenter;
@@ -566,6 +890,32 @@ void evalInputs(uint8_t mode)
   }
 }
 
+void evalInputs(uint8_t mode)
+{
+#if defined(CPUARM)
+  if (FADE_CACHE_ACTIVE(mode)) {
+    // the raw inputs were evaluated once for all the flight modes of the fade
+#if defined(PCBTARANIS)
+#if defined(HELI)
+    memcpy(heliAnas, fadeCache.heliAnas, sizeof(heliAnas));
+#endif
+#else
+    memcpy(anas, rawAnas, sizeof(anas));
+#endif
+  }
+  else
+#endif
+  {
+    evalRawInputs(mode);
+  }
+
+  /* EXPOs */
+  applyExpos(anas, mode);
+
+  /* TRIMs */
+  evalTrims(); // when no virtual inputs, the trims need the anas array calculated above (when throttle trim enabled)
+}
+
 #if defined(PCBTARANIS)
   #define HELI_ANAS_ARRAY(x)  heliAnas[x]
   #define HELI_TRIMS_ARRAY(x) ((heliTrims[x]>=0) ? trims[heliTrims[x]] : 0)
@@ -679,6 +1029,10 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
         chans[md->destCh] = 0;
       }
 
+#if defined(CPUARM)
+      uint8_t fadeFlags = (FADE_CACHE_ACTIVE(mode) ? fadeCache.mixes[i].flags : 0);
+#endif
+
       //========== PHASE && SWITCH =====
       bool mixCondition = (md->flightModes != 0 || md->swtch);
       delayval_t mixEnabled = (!(md->flightModes & (1 << mixerCurrentFlightMode)) && getSwitch(md->swtch)) ? DELAY_POS_MARGIN+1 : 0;
@@ -719,6 +1073,12 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 #endif
       }
       else {
+#if defined(CPUARM)
+        if (fadeFlags & FADE_VALUE_CACHED) {
+          v = fadeCache.mixes[i].value;
+        }
+        else
+#endif
 #if !defined(PCBTARANIS)
         if (stickIndex < NUM_STICKS) {
           v = md->noExpo ? rawAnas[stickIndex] : anas[stickIndex];
@@ -736,6 +1096,12 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
               v = chans[srcRaw] >> 8;
           }
         }
+#if defined(CPUARM)
+        if ((fadeFlags & (FADE_VALUE_SHARED|FADE_VALUE_CACHED)) == FADE_VALUE_SHARED) {
+          fadeCache.mixes[i].value = v;
+          fadeCache.mixes[i].flags |= FADE_VALUE_CACHED;
+        }
+#endif
         if (!mixCondition) {
           mixEnabled = v >> DELAY_POS_SHIFT;
         }
@@ -755,8 +1121,12 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
       }
       if (mode==e_perout_mode_normal && swOn[i].delay > 0) {
         swOn[i].delay = max<int16_t>(0, (int16_t)swOn[i].delay - tick10ms);
-        if (!mixCondition)
+        if (!mixCondition) {
           v = _swPrev << DELAY_POS_SHIFT;
+#if defined(CPUARM)
+          fadeFlags &= ~(FADE_CURVE_SHARED|FADE_CURVE_CACHED);
+#endif
+        }
         else if (mixEnabled)
           continue;
       }
@@ -832,7 +1202,9 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 
       // saves 12 bytes code if done here and not together with weight; unknown reason
       int16_t weight = GET_GVAR(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+#if !defined(CPUARM)
       weight = calc100to256_16Bits(weight);
+#endif
 
       //========== SPEED ===============
       // now its on input side, but without weight compensation. More like other remote controls
@@ -878,16 +1250,37 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
       //========== CURVES ===============
 #if defined(PCBTARANIS)
       if (apply_offset_and_curve && md->curve.value) {
-        v = applyCurve(v, md->curve);
-      }
 #else
       if (apply_offset_and_curve && md->curveParam && md->curveMode == MODE_CURVE) {
-        v = applyCurve(v, md->curveParam);
-      }
 #endif
+#if defined(CPUARM)
+        if (fadeFlags & FADE_CURVE_CACHED) {
+          v = fadeCache.mixes[i].curve;
+        }
+        else
+#endif
+        {
+#if defined(PCBTARANIS)
+          v = applyCurve(v, md->curve);
+#else
+          v = applyCurve(v, md->curveParam);
+#endif
+#if defined(CPUARM)
+          if (fadeFlags & FADE_CURVE_SHARED) {
+            fadeCache.mixes[i].curve = v;
+            fadeCache.mixes[i].flags |= FADE_CURVE_CACHED;
+          }
+#endif
+        }
+      }
 
       //========== WEIGHT ===============
+#if defined(CPUARM)
+      // v * weight * 2.56 with the 2.56 factor in Q24, the weight is not rounded to a 256 basis
+      int32_t dv = ((int64_t)(v * weight) * 42949673 + (1 << 23)) >> 24;
+#else
       int32_t dv = (int32_t) v * weight;
+#endif
 
       //========== OFFSET / AFTER ===============
       if (apply_offset_and_curve) {
@@ -921,10 +1314,15 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
           break;
         case MLTPX_MUL:
           // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
+#if defined(CPUARM)
+          // 64 bits product, no precision lost before the multiplication and no overflow
+          *ptr = ((int64_t)dv * *ptr) >> (8 + RESX_SHIFT);
+#else
           dv >>= 8;
           dv *= *ptr;
           dv >>= RESX_SHIFT;   // same as dv /= RESXl;
           *ptr = dv;
+#endif
           break;
         default: // MLTPX_ADD
           *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
@@ -1012,6 +1410,9 @@ void evalMixes(uint8_t tick10ms)
 #endif
 
     if (lastFlightMode == 255) {
+      // a new model, no fade from the previous one
+      flightModesFade = 0;
+      memclear(fp_act, sizeof(fp_act));
       fp_act[fm] = MAX_ACT;
     }
     else {
@@ -1047,17 +1448,43 @@ void evalMixes(uint8_t tick10ms)
   int32_t weight = 0;
   if (flightModesFade) {
     memclear(sum_chans512, sizeof(sum_chans512));
+#if defined(CPUARM)
+    // the flight modes weights in Q16, the channels are faded with a 64 bits
+    // product instead of being shifted down by 4 bits to prevent overflows
+    uint32_t fadeWeights[MAX_FLIGHT_MODES];
+    for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
+      if (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << p))
+        weight += fp_act[p];
+    }
+    for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
+      fadeWeights[p] = (((uint64_t)fp_act[p] << 16) + weight/2) / weight;
+    }
+    initFadeCache();
+    evalRawInputs(e_perout_mode_normal);
+#if defined(PCBTARANIS) && defined(HELI)
+    memcpy(fadeCache.heliAnas, heliAnas, sizeof(heliAnas));
+#endif
+    fadeCache.active = true;
+#endif
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
       LS_RECURSIVE_EVALUATION_RESET();
       if (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << p)) {
         mixerCurrentFlightMode = p;
         evalFlightModeMixes(p==fm ? e_perout_mode_normal : e_perout_mode_inactive_flight_mode, p==fm ? tick10ms : 0);
+#if defined(CPUARM)
+        for (uint8_t i=0; i<NUM_CHNOUT; i++)
+          sum_chans512[i] += ((int64_t)chans[i] * fadeWeights[p]) >> 16;
+#else
         for (uint8_t i=0; i<NUM_CHNOUT; i++)
           sum_chans512[i] += (chans[i] >> 4) * fp_act[p];
         weight += fp_act[p];
+#endif
       }
       LS_RECURSIVE_EVALUATION_RESET();
     }
+#if defined(CPUARM)
+    fadeCache.active = false;
+#endif
     assert(weight);
     mixerCurrentFlightMode = fm;
   }
@@ -1085,21 +1512,38 @@ void evalMixes(uint8_t tick10ms)
   }
 
   //========== LIMITS ===============
+#if defined(CPUARM)
+  if (outputStagesVersion != MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS) || outputStagesFlightMode != mixerCurrentFlightMode ||
+      (outputStagesGVars && outputStagesGVarsVersion != MODEL_CACHE_VERSION(MODEL_CACHE_GVARS))) {
+    compileOutputStages();
+  }
+#endif
+
   for (uint8_t i=0; i<NUM_CHNOUT; i++) {
     // chans[i] holds data from mixer.   chans[i] = v*weight => 1024*256
     // later we multiply by the limit (up to 100) and then we need to normalize
     // at the end chans[i] = chans[i]/256 =>  -1024..1024
     // interpolate value with min/max so we get smooth motion from center to stop
     // this limits based on v original values and min=-1024, max=1024  RESX=1024
+#if defined(CPUARM)
+    int32_t q = (flightModesFade ? sum_chans512[i] : chans[i]);
+#else
     int32_t q = (flightModesFade ? (sum_chans512[i] / weight) << 4 : chans[i]);
+#endif
 
 #if defined(PCBSTD)
     ex_chans[i] = q >> 8;
+#elif defined(CPUARM)
+    ex_chans[i] = saturate<16>(q / 256);
 #else
     ex_chans[i] = q / 256;
 #endif
 
+#if defined(CPUARM)
+    int16_t value = applyOutputStage(i, q);  // removes the 256 100% basis
+#else
     int16_t value = applyLimits(i, q);  // applyLimits will remove the 256 100% basis
+#endif
 
     cli();
     channelOutputs[i] = value;  // copy consistent word to int-level
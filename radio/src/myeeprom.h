@@ -839,6 +839,7 @@ PACK(typedef struct {
   #define LIMIT_MAX_RESX(lim) calc1000toRESX(LIMIT_MAX(lim))
   #define LIMIT_MIN_RESX(lim) calc1000toRESX(LIMIT_MIN(lim))
   #define LIMIT_OFS_RESX(lim) calc1000toRESX(LIMIT_OFS(lim))
+  #define LIMIT_USES_GVARS(lim) (GV_IS_GV_VALUE(lim->max, -GV_RANGELARGE, GV_RANGELARGE) || GV_IS_GV_VALUE(lim->min, -GV_RANGELARGE, GV_RANGELARGE) || GV_IS_GV_VALUE(lim->offset, -1000, 1000))
 #else
   #define limit_min_max_t     int8_t
   #define LIMIT_EXT_PERCENT   125
@@ -850,6 +851,7 @@ PACK(typedef struct {
   #define LIMIT_MAX_RESX(lim) calc100toRESX(LIMIT_MAX(lim))
   #define LIMIT_MIN_RESX(lim) calc100toRESX(LIMIT_MIN(lim))
   #define LIMIT_OFS_RESX(lim) calc1000toRESX(LIMIT_OFS(lim))
+  #define LIMIT_USES_GVARS(lim) false
 #endif
 
 #if defined(PCBTARANIS)
@@ -1218,6 +1220,7 @@ enum TelemetrySensorFormula
   TELEM_FORMULA_CELL,
   TELEM_FORMULA_CONSUMPTION,
   TELEM_FORMULA_DIST,
+  TELEM_FORMULA_HISTORY,
 };
 
 enum TelemetrySensorInputFlags
@@ -1267,6 +1270,12 @@ PACK(typedef struct {
       uint8_t alt;
       uint16_t spare;
     }) dist;
+    PACK(struct {
+      uint8_t source;
+      uint8_t stat;
+      uint8_t scale;
+      uint8_t percent;
+    }) history;
     uint32_t param;
   };
   void init(const char *label, uint8_t unit=UNIT_RAW, uint8_t prec=0);
@@ -396,6 +396,20 @@ bool isFileAvailable(const char * filename)
 }
 #endif
 
+#if defined(CPUARM)
+uint32_t modelCachesVersions[MODEL_CACHES_COUNT] = { 1, 1, 1, 1, 1 };
+uint32_t modelCachesPending = 0;
+
+void invalidateModelCaches(uint32_t caches)
+{
+  for (uint8_t i=0; i<MODEL_CACHES_COUNT; i++) {
+    if (caches & MODEL_CACHE(i)) {
+      __atomic_add_fetch(&modelCachesVersions[i], 1, __ATOMIC_RELEASE);
+    }
+  }
+}
+#endif
+
 void modelDefault(uint8_t id)
 {
   memset(&g_model, 0, sizeof(g_model));
@@ -430,6 +444,8 @@ void modelDefault(uint8_t id)
   g_model.mavlink.rc_rssi_scale = 15;
   g_model.mavlink.pc_rssi_en = 1;
 #endif
+
+  INVALIDATE_MODEL_CACHES();
 }
 
 #if defined(PCBTARANIS)
@@ -634,6 +650,15 @@ void incRotaryEncoder(uint8_t idx, int8_t inc)
 #if defined(PCBSTD)
   #define SET_GVAR_VALUE(idx, phase, value) \
     (GVAR_VALUE(idx, phase) = value, eeDirty(EE_MODEL))
+#elif defined(CPUARM)
+  // only the caches which read the GVars are rebuilt
+  #define SET_GVAR_VALUE(idx, phase, value) \
+    GVAR_VALUE(idx, phase) = value; \
+    eeDirtyCaches(EE_MODEL, MODEL_CACHE(MODEL_CACHE_GVARS)); \
+    if (g_model.gvars[idx].popup) { \
+      s_gvar_last = idx; \
+      s_gvar_timer = GVAR_DISPLAY_TIME; \
+    }
 #else
   #define SET_GVAR_VALUE(idx, phase, value) \
     GVAR_VALUE(idx, phase) = value; \
@@ -685,6 +710,25 @@ uint8_t getGVarFlightPhase(uint8_t phase, uint8_t idx)
   return 0;
 }
 
+#if defined(CPUARM)
+// GVars values after the flight modes inheritance, one table per flight mode.
+// A table is rebuilt on its first read after a model change.
+int16_t gvarsResolved[MAX_FLIGHT_MODES][MAX_GVARS];
+uint32_t gvarsResolvedVersion[MAX_FLIGHT_MODES];
+
+int16_t getGVarResolvedValue(uint8_t idx, uint8_t phase)
+{
+  uint32_t version = MODEL_CACHE_VERSION(MODEL_CACHE_GVARS);
+  if (gvarsResolvedVersion[phase] != version) {
+    for (uint8_t i=0; i<MAX_GVARS; i++) {
+      gvarsResolved[phase][i] = GVAR_VALUE(i, getGVarFlightPhase(phase, i));
+    }
+    gvarsResolvedVersion[phase] = version;
+  }
+  return gvarsResolved[phase][idx];
+}
+#endif
+
 int16_t getGVarValue(int16_t x, int16_t min, int16_t max, int8_t phase)
 {
   if (GV_IS_GV_VALUE(x, min, max)) {
@@ -696,7 +740,7 @@ int16_t getGVarValue(int16_t x, int16_t min, int16_t max, int8_t phase)
       mul = -1;
     }
 
-    x = GVAR_VALUE(idx, getGVarFlightPhase(phase, idx)) * mul;
+    x = GVAR_RESOLVED_VALUE(idx, phase) * mul;
   }
   return limit(min, x, max);
 }
@@ -1361,6 +1405,10 @@ uint8_t checkTrim(uint8_t event)
 
 #if !defined(SIMU)
 static uint16_t s_anaFilt[NUMBER_ANALOG];
+#if defined(CPUARM)
+static uint32_t s_anaFiltState[NUMBER_ANALOG]; // see filterAnalog(), the samples are in 1/16
+static bool s_anaFiltInitialized = false;
+#endif
 #endif
 
 #if defined(SIMU)
@@ -1418,9 +1466,17 @@ void getADC()
   }
 
   for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
-    uint16_t v = temp[x] >> 3;
+    // temp[x] >> 3 in 1/16, the filter keeps the bits lost by the shift
+    uint16_t sample = temp[x] << 1;
+    if (!s_anaFiltInitialized) {
+      s_anaFiltState[x] = (uint32_t)sample << ANALOG_FILTER_SHIFT;
+    }
+    uint16_t v = filterAnalog(s_anaFiltState[x], sample) >> 4;
 #if defined(PCBTARANIS)
-    if (calibrationState) v = temp[x] >> 1;
+    if (calibrationState) {
+      v = temp[x] >> 1;
+      s_anaFiltState[x] = (uint32_t)v << (4+ANALOG_FILTER_SHIFT);
+    }
     StepsCalibData * calib = (StepsCalibData *) &g_eeGeneral.calib[x];
     if (!calibrationState && IS_POT_MULTIPOS(x) && calib->count>0 && calib->count<XPOTS_MULTIPOS_COUNT) {
       uint8_t vShifted = (v >> 4);
@@ -1436,6 +1492,8 @@ void getADC()
 #endif
     s_anaFilt[x] = v;
   }
+
+  s_anaFiltInitialized = true;
 }
 #else
 
@@ -1582,25 +1640,15 @@ uint8_t trimsDisplayTimer = 0;
 uint8_t trimsDisplayMask = 0;
 #endif
 
-void timerReset(uint8_t idx)
-{
-  TimerState & timerState = timersStates[idx];
-  timerState.state = TMR_OFF; // is changed to RUNNING dep from mode
-  timerState.val = g_model.timers[idx].start;
-  timerState.val_10ms = 0 ;
-}
-
 void flightReset()
 {
   // we don't reset the whole audio here (the tada.wav would be cut, if a prompt is queued before FlightReset, it should be played)
   // TODO check if the vario / background music are stopped correctly if switching to a model which doesn't have these functions enabled
 
-  if (!IS_MANUAL_RESET_TIMER(0)) {
-    timerReset(0);
-  }
-
-  if (!IS_MANUAL_RESET_TIMER(1)) {
-    timerReset(1);
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    if (!IS_MANUAL_RESET_TIMER(i)) {
+      timerReset(i);
+    }
   }
 
 #if defined(FRSKY)
@@ -1614,8 +1662,6 @@ void flightReset()
   RESET_THR_TRACE();
 }
 
-TimerState timersStates[MAX_TIMERS] = { { 0 }, { 0 } };
-
 #if defined(THRTRACE)
 uint8_t  s_traceBuf[MAXTRACE];
 #if LCD_W >= 255
@@ -1680,6 +1726,10 @@ void doMixerCalculations()
 
   getSwitchesPosition(!s_mixer_first_run_done);
 
+#if defined(CPUARM)
+  takeSwitchesSnapshot();
+#endif
+
 #if defined(CPUARM)
   lastTMR = tmr10ms;
 #endif
@@ -1705,13 +1755,6 @@ void doMixerCalculations()
 
   if (tick10ms) {
 
-#if !defined(CPUM64) && !defined(ACCURAT_THROTTLE_TIMER)
-    //  code cost is about 16 bytes for higher throttle accuracy for timer
-    //  would not be noticable anyway, because all version up to this change had only 16 steps;
-    //  now it has already 32  steps; this define would increase to 128 steps
-    #define ACCURAT_THROTTLE_TIMER
-#endif
-
     /* Throttle trace */
     int16_t val;
 
@@ -1759,101 +1802,9 @@ void doMixerCalculations()
 #endif
     }
 
-#if defined(ACCURAT_THROTTLE_TIMER)
-    val >>= (RESX_SHIFT-6); // calibrate it (resolution increased by factor 4)
-#else
-    val >>= (RESX_SHIFT-4); // calibrate it
-#endif
+    evalTimers(val, tick10ms); // the throttle at full resolution
 
-    // Timers start
-    for (uint8_t i=0; i<MAX_TIMERS; i++) {
-      int8_t tm = g_model.timers[i].mode;
-      uint16_t tv = g_model.timers[i].start;
-      TimerState * timerState = &timersStates[i];
-
-      if (tm) {
-        if (timerState->state == TMR_OFF) {
-          timerState->state = TMR_RUNNING;
-          timerState->cnt = 0;
-          timerState->sum = 0;
-        }
-
-        if (tm == TMRMODE_THR_REL) {
-          timerState->cnt++;
-          timerState->sum+=val;
-        }
-
-        if ((timerState->val_10ms += tick10ms) >= 100) {
-          timerState->val_10ms -= 100 ;
-          int16_t newTimerVal = timerState->val;
-          if (tv) newTimerVal = tv - newTimerVal;
-
-          if (tm == TMRMODE_ABS) {
-            newTimerVal++;
-          }
-          else if (tm == TMRMODE_THR) {
-            if (val) newTimerVal++;
-          }
-          else if (tm == TMRMODE_THR_REL) {
-            // @@@ open.20.fsguruh: why so complicated? we have already a s_sum field; use it for the half seconds (not showable) as well
-            // check for s_cnt[i]==0 is not needed because we are shure it is at least 1
-#if defined(ACCURAT_THROTTLE_TIMER)
-            if ((timerState->sum/timerState->cnt) >= 128) {  // throttle was normalized to 0 to 128 value (throttle/64*2 (because - range is added as well)
-              newTimerVal++;  // add second used of throttle
-              timerState->sum -= 128*timerState->cnt;
-            }
-#else
-            if ((timerState->sum/timerState->cnt) >= 32) {  // throttle was normalized to 0 to 32 value (throttle/16*2 (because - range is added as well)
-              newTimerVal++;  // add second used of throttle
-              timerState->sum -= 32*timerState->cnt;
-            }
-#endif
-            timerState->cnt=0;
-          }
-          else if (tm == TMRMODE_THR_TRG) {
-            if (val) {
-              timerState->state = TMR_TRIGGED;
-            }
-            if (timerState->state == TMR_TRIGGED) {
-              newTimerVal++;
-            }
-          }
-          else {
-            if (tm > 0) tm -= (TMRMODE_COUNT-1);
-            if (getSwitch(tm))
-              newTimerVal++;
-          }
-
-          switch (timerState->state) {
-            case TMR_RUNNING:
-              if (tv && newTimerVal>=(int16_t)tv) {
-                AUDIO_TIMER_00(g_model.timers[i].countdownBeep);
-                timerState->state = TMR_NEGATIVE;
-              }
-              break;
-            case TMR_NEGATIVE:
-              if (newTimerVal >= (int16_t)tv + MAX_ALERT_TIME) timerState->state = TMR_STOPPED;
-              break;
-          }
-
-          if (tv) newTimerVal = tv - newTimerVal; // if counting backwards - display backwards
-
-          if (newTimerVal != timerState->val) {
-            timerState->val = newTimerVal;
-            if (timerState->state == TMR_RUNNING) {
-              if (g_model.timers[i].countdownBeep && g_model.timers[i].start) {
-                if (newTimerVal==30) AUDIO_TIMER_30();
-                if (newTimerVal==20) AUDIO_TIMER_20();
-                if (newTimerVal<=10) AUDIO_TIMER_LT10(g_model.timers[i].countdownBeep, newTimerVal);
-              }
-              if (g_model.timers[i].minuteBeep && (newTimerVal % 60)==0) {
-                AUDIO_TIMER_MINUTE(newTimerVal);
-              }
-            }
-          }
-        }
-      }
-    } //endfor timer loop (only two)
+    val >>= THR_TRACE_SHIFT;
 
     static uint8_t  s_cnt_100ms;
     static uint8_t  s_cnt_1s;
@@ -1937,6 +1888,10 @@ void doMixerCalculations()
 #endif
   }
 
+#if defined(CPUARM)
+  releaseSwitchesSnapshot();
+#endif
+
   s_mixer_first_run_done = true;
 }
 
@@ -2015,8 +1970,6 @@ void opentxClose()
   hapticOff();
 #endif
 
-  saveTimers();
-
 #if defined(CPUARM)
   for (int i=0; i<TELEM_VALUES_MAX; i++) {
     TelemetrySensor & sensor = g_model.telemetrySensors[i];
@@ -2025,7 +1978,7 @@ void opentxClose()
         sensor.persistentValue = telemetryItems[i].value;
         eeDirty(EE_MODEL);
       }
-      else if (!sensor.persistent) {
+      else if (!sensor.persistent && sensor.persistentValue) {
         sensor.persistentValue = 0;
         eeDirty(EE_MODEL);
       }
@@ -2049,6 +2002,8 @@ void opentxClose()
   }
 #endif
 
+  closeTimers();
+
   if (s_eeDirtyMsk & EE_MODEL) {
     displayPopup(STR_SAVEMODEL);
   } 
@@ -2509,29 +2464,6 @@ void moveTrimsToOffsets() // copy state of 3 primary to subtrim
   AUDIO_WARNING2();
 }
 
-#if defined(CPUARM) || defined(CPUM2560)
-void saveTimers()
-{
-  for (uint8_t i=0; i<MAX_TIMERS; i++) {
-    if (g_model.timers[i].persistent) {
-      TimerState *timerState = &timersStates[i];
-      if (g_model.timers[i].value != (uint16_t)timerState->val) {
-        g_model.timers[i].value = timerState->val;
-        eeDirty(EE_MODEL);
-      }
-    }
-  }
-
-#if defined(CPUARM) && !defined(REVA)
-  if (sessionTimer > 0) {
-    g_eeGeneral.globalTimer += sessionTimer;
-    eeDirty(EE_GENERAL);
-    sessionTimer = 0;
-  }
-#endif
-}
-#endif
-
 #if defined(ROTARY_ENCODERS)
   volatile rotenc_t g_rotenc[ROTARY_ENCODERS] = {0};
 #elif defined(ROTARY_ENCODER_NAVIGATION)
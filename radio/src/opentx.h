@@ -690,6 +690,12 @@ getvalue_t getValue(mixsrc_t i);
 #if defined(CPUARM)
 #define GETSWITCH_MIDPOS_DELAY   1
 bool getSwitch(int8_t swtch, uint8_t flags=0);
+#define SWITCHES_SNAPSHOT_WORDS  ((SWSRC_FIRST_LOGICAL_SWITCH+31)/32)
+#define SWITCHES_SNAPSHOT_BIT(snapshot, idx) ((snapshot)[(idx)/32] & ((uint32_t)1 << ((idx)%32)))
+extern uint32_t switchesSnapshot[SWITCHES_SNAPSHOT_WORDS];
+extern bool switchesSnapshotValid;
+void takeSwitchesSnapshot();
+#define releaseSwitchesSnapshot() switchesSnapshotValid = false
 #else
 bool getSwitch(int8_t swtch);
 #endif
@@ -769,16 +775,52 @@ void setTrimValue(uint8_t phase, uint8_t idx, int trim);
   #define ROTARY_ENCODER_GRANULARITY (2)
 #endif
 
+#if defined(CPUARM)
+  // The caches built from g_model or g_eeGeneral are rebuilt when their
+  // version changes. The versions are incremented atomically, as the mixer
+  // task (GVars, trims) and the menus task both write them.
+  enum ModelCaches {
+    MODEL_CACHE_GVARS,        // resolved GVars values
+    MODEL_CACHE_OUTPUTS,      // output stages (limits)
+    MODEL_CACHE_FUNCTIONS,    // special and global functions triggers
+    MODEL_CACHE_CALIBRATION,  // inputs calibration (radio settings)
+    MODEL_CACHE_TIMERS,       // timers next events
+    MODEL_CACHES_COUNT
+  };
+  #define MODEL_CACHE(cache)          (1 << (cache))
+  #define MODEL_CACHES_MODEL          (MODEL_CACHE(MODEL_CACHE_GVARS) | MODEL_CACHE(MODEL_CACHE_OUTPUTS) | MODEL_CACHE(MODEL_CACHE_FUNCTIONS) | MODEL_CACHE(MODEL_CACHE_TIMERS))
+  #define MODEL_CACHES_GENERAL        (MODEL_CACHE(MODEL_CACHE_FUNCTIONS) | MODEL_CACHE(MODEL_CACHE_CALIBRATION))
+  #define MODEL_CACHES_ALL            (MODEL_CACHES_MODEL | MODEL_CACHES_GENERAL)
+  extern uint32_t modelCachesVersions[MODEL_CACHES_COUNT];
+  #define MODEL_CACHE_VERSION(cache)  __atomic_load_n(&modelCachesVersions[cache], __ATOMIC_ACQUIRE)
+  void invalidateModelCaches(uint32_t caches);
+  #define INVALIDATE_MODEL_CACHES()   invalidateModelCaches(MODEL_CACHES_ALL)
+  // eeDirty() is called by checkIncDec() before the menu stores the new value,
+  // these caches are invalidated again once the menus are done
+  extern uint32_t modelCachesPending;
+  #define COMMIT_MODEL_CACHES()       invalidateModelCaches(__atomic_exchange_n(&modelCachesPending, 0, __ATOMIC_ACQ_REL))
+#else
+  #define INVALIDATE_MODEL_CACHES()
+  #define COMMIT_MODEL_CACHES()
+#endif
+
 #if defined(GVARS)
   #if defined(PCBSTD)
     int16_t getGVarValue(int16_t x, int16_t min, int16_t max);
     void setGVarValue(uint8_t x, int8_t value);
     #define GET_GVAR(x, min, max, p) getGVarValue(x, min, max)
     #define SET_GVAR(idx, val, p) setGVarValue(idx, val)  
+    #define GVAR_RESOLVED_VALUE(idx, phase) GVAR_VALUE(idx, -1)
   #else
     uint8_t getGVarFlightPhase(uint8_t phase, uint8_t idx);
     int16_t getGVarValue(int16_t x, int16_t min, int16_t max, int8_t phase);
     void setGVarValue(uint8_t x, int16_t value, int8_t phase);  
+    #if defined(CPUARM)
+      int16_t getGVarResolvedValue(uint8_t idx, uint8_t phase);
+      #define GVAR_RESOLVED_VALUE(idx, phase) getGVarResolvedValue(idx, phase)
+    #else
+      #define GVAR_RESOLVED_VALUE(idx, phase) GVAR_VALUE(idx, getGVarFlightPhase(phase, idx))
+    #endif
     #define GET_GVAR(x, min, max, p) getGVarValue(x, min, max, p)
     #define SET_GVAR(idx, val, p) setGVarValue(idx, val, p)      
     #define GVAR_DISPLAY_TIME     100 /*1 second*/;
@@ -828,15 +870,7 @@ extern uint16_t sessionTimer;
 extern uint16_t s_timeCumThr;
 extern uint16_t s_timeCum16ThrP;
 
-struct TimerState {
-  uint16_t cnt;
-  uint16_t sum;
-  uint8_t  state;
-  int16_t  val;
-  uint8_t  val_10ms;
-};
-
-extern TimerState timersStates[MAX_TIMERS];
+#include "timers.h"
 
 #if defined(OVERRIDE_CHANNEL_FUNCTION)
 #if defined(CPUARM)
@@ -856,12 +890,6 @@ extern uint8_t trimsDisplayTimer;
 extern uint8_t trimsDisplayMask;
 #endif
 
-#define TMR_OFF      0
-#define TMR_RUNNING  1
-#define TMR_NEGATIVE 2
-#define TMR_STOPPED  3
-#define TMR_TRIGGED  4
-void timerReset(uint8_t idx);
 void flightReset();
 
 extern uint8_t unexpectedShutdown;
@@ -944,7 +972,33 @@ void checkAll();
   void getADC();
 #endif
 
+#if defined(CPUARM)
+#define ANALOG_FILTER_SHIFT 1     // y += (x - y) / 2
+#define ANALOG_FILTER_JUMP  256   // 16 ADC steps in 1/16, bigger moves are not delayed
+// first order IIR on one analog, the state is the output << ANALOG_FILTER_SHIFT
+// so that no bits are lost and a constant input gives back the exact same value
+inline uint16_t filterAnalog(uint32_t & state, uint16_t sample)
+{
+  if (abs((int32_t)sample - (int32_t)(state >> ANALOG_FILTER_SHIFT)) > ANALOG_FILTER_JUMP)
+    state = (uint32_t)sample << ANALOG_FILTER_SHIFT;
+  else
+    state += sample - (state >> ANALOG_FILTER_SHIFT);
+  return state >> ANALOG_FILTER_SHIFT;
+}
+#endif
+
 #if defined(PCBTARANIS)
+struct SbusStats {
+  uint32_t frames;
+  uint32_t errors;      // bad start / end bytes, truncated frames
+  uint32_t lostFrames;  // frame lost flag set by the receiver
+  uint32_t failsafes;   // failsafe flag set by the receiver, frame ignored
+  uint16_t rate;        // frames/s
+  uint16_t latency;     // us, max over the last second, last byte received -> frame decoded
+};
+extern SbusStats sbusStats;
+extern volatile uint16_t sbusRxTime; // getTmr2MHz() of the last byte received
+void processSbusData(const uint8_t * data, int len);
 void processSbusInput();
 #endif
 
@@ -1007,6 +1061,19 @@ template<class t> FORCEINLINE t min(t a, t b) { return a<b?a:b; }
 template<class t> FORCEINLINE t max(t a, t b) { return a>b?a:b; }
 template<class t> FORCEINLINE t sgn(t a) { return a>0 ? 1 : (a < 0 ? -1 : 0); }
 template<class t> FORCEINLINE t limit(t mi, t x, t ma) { return min(max(mi,x),ma); }
+#if defined(CPUARM)
+// signed saturation of x on bits bits, a single SSAT instruction on Cortex-M3/M4
+template<int bits> FORCEINLINE int32_t saturate(int32_t x)
+{
+#if defined(SIMU)
+  return limit<int32_t>(-(1 << (bits-1)), x, (1 << (bits-1)) - 1);
+#else
+  int32_t result;
+  __asm__ ("ssat %0, %1, %2" : "=r" (result) : "I" (bits), "r" (x));
+  return result;
+#endif
+}
+#endif
 #if !defined(SWAP_DEFINED)
 template<class t> void swap(t & a, t & b) { t tmp = b; b = a; a = tmp; }
 #endif
@@ -1035,12 +1102,6 @@ inline void resumeMixerCalculations()
 #define resumeMixerCalculations()
 #endif
 
-#if defined(CPUARM) || defined(CPUM2560)
-void saveTimers();
-#else
-#define saveTimers()
-#endif
-
 void generalDefault();
 void modelDefault(uint8_t id);
 
@@ -1150,6 +1211,32 @@ void defaultInputs();
 
 void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS_INC);
 int16_t applyLimits(uint8_t channel, int32_t value);
+#if defined(CPUARM)
+void compileOutputStages();
+int16_t applyOutputStage(uint8_t channel, int32_t value);
+
+struct InputsCalibration {
+  int16_t  mid[NUM_STICKS+NUM_POTS];
+  uint32_t mul[2][NUM_STICKS+NUM_POTS];  // RESX/span in Q32, [0] under the mid point, [1] over it
+  uint8_t  channel[NUM_STICKS+NUM_POTS]; // CONVERT_MODE()
+  bool     invert[NUM_STICKS+NUM_POTS];
+  uint32_t version;
+  uint8_t  stickMode;
+};
+
+extern InputsCalibration inputsCalibration;
+uint32_t calibrationMultiplier(int16_t span);
+void compileInputsCalibration();
+void calibrateInputs(int16_t * values);
+#define invalidateInputsCalibration() inputsCalibration.version = 0
+
+// v * RESX / span, truncated like the division, with mul = calibrationMultiplier(span)
+inline int32_t applyCalibration(int32_t v, uint32_t mul)
+{
+  int32_t result = ((uint64_t)((uint32_t)abs(v) << RESX_SHIFT) * mul) >> 32;
+  return (v < 0 ? -result : result);
+}
+#endif
 
 void evalInputs(uint8_t mode);
 uint16_t anaIn(uint8_t chan);
@@ -1293,10 +1380,20 @@ enum FunctionsActive {
 #define VARIO_REPEAT_ZERO      500/*ms*/
 #define VARIO_REPEAT_MAX       80/*ms*/
 
+#define CFN_TRIGGER_NONE 255
+
 typedef struct {
   MASK_FUNC_TYPE activeFunctions;
   MASK_CFN_TYPE  activeSwitches;
   tmr10ms_t lastFunctionTime[NUM_CFN];
+#if defined(CPUARM)
+  // the functions grouped by switch, each distinct switch is read once per cycle
+  uint32_t triggersVersion;
+  uint8_t  triggersCount;
+  int8_t   triggerSwitch[NUM_CFN];
+  uint8_t  triggerFlags[NUM_CFN];
+  uint8_t  functionTrigger[NUM_CFN];
+#endif
 
   inline bool isFuunctionActive(uint8_t func)
   {
@@ -1540,6 +1637,14 @@ union ReusableBuffer
         uint16_t count;
     } sdmanager;
 #endif
+
+#if defined(PCBTARANIS)
+    struct
+    {
+        uint8_t background[LCD_SURFACE_SIZE(LCD_W, 6*FH)]; // labels of the custom telemetry screen
+        uint8_t view; // s_frsky_view the background was rendered for
+    } telemetry;
+#endif
 };
 
 extern union ReusableBuffer reusableBuffer;
@@ -36,59 +36,139 @@
 
 #include "opentx.h"
 
+#define SBUS_FRAME_SIZE         25
+#define SBUS_MIN_FRAME_SIZE     23 // start byte + 16 channels, some receivers don't send the flags
+#define SBUS_START_BYTE         0x0F
+#define SBUS_FLAGS_INDEX        23
+#define SBUS_FLAG_FRAME_LOST    0x04
+#define SBUS_FLAG_FAILSAFE      0x08
+#define SBUS_DELAY              1000 // 500uS, the gap between frames
+
 Fifo<32> sbusFifo;
-uint8_t SbusFrame[28] ;
-uint16_t SbusTimer ;
-uint8_t SbusIndex = 0 ;
+volatile uint16_t sbusRxTime;
+SbusStats sbusStats;
+
+uint8_t SbusFrame[SBUS_FRAME_SIZE];
+uint8_t SbusIndex = 0;
+uint16_t SbusTimer;
+bool SbusFrameStart = false; // the next byte starts a frame (after a gap or a valid frame)
+static tmr10ms_t sbusStatsTime;
+static uint32_t sbusStatsFrames;
+static uint16_t sbusLatencyMax;
 
-void processSbusFrame(uint8_t *sbus, int16_t *pulses, uint32_t size)
+// The end byte is 0x00, or 0x?4 with the S.BUS2 telemetry slots
+static inline bool isSbusEndByte(uint8_t byte)
 {
-  uint32_t inputbitsavailable = 0;
-  uint32_t inputbits = 0;
+  return byte == 0x00 || (byte & 0x0F) == 0x04;
+}
+
+#define SBUS_TO_PPM(value)      (((int32_t)((value) & 0x7FF) - 0x3E0) * 5 / 8)
+
+// 8 channels of 11 bits are packed in 11 bytes
+static inline void sbusUnpackChannels(const uint8_t * data, int16_t * pulses)
+{
+  pulses[0] = SBUS_TO_PPM(data[0] | data[1] << 8);
+  pulses[1] = SBUS_TO_PPM(data[1] >> 3 | data[2] << 5);
+  pulses[2] = SBUS_TO_PPM(data[2] >> 6 | data[3] << 2 | data[4] << 10);
+  pulses[3] = SBUS_TO_PPM(data[4] >> 1 | data[5] << 7);
+  pulses[4] = SBUS_TO_PPM(data[5] >> 4 | data[6] << 4);
+  pulses[5] = SBUS_TO_PPM(data[6] >> 7 | data[7] << 1 | data[8] << 9);
+  pulses[6] = SBUS_TO_PPM(data[8] >> 2 | data[9] << 6);
+  pulses[7] = SBUS_TO_PPM(data[9] >> 5 | data[10] << 3);
+}
 
-  if (*sbus++ != 0x0F) {
+void processSbusFrame(uint8_t * sbus, int16_t * pulses, uint32_t size)
+{
+  if (sbus[0] != SBUS_START_BYTE || size < SBUS_MIN_FRAME_SIZE) {
+    sbusStats.errors++;
     return; // not a valid SBUS frame
   }
 
-  if (size < 23) {
+  uint8_t flags = (size > SBUS_FLAGS_INDEX ? sbus[SBUS_FLAGS_INDEX] : 0);
+  if (flags & SBUS_FLAG_FAILSAFE) {
+    // the receiver outputs its failsafe positions, let the trainer input time out
+    sbusStats.failsafes++;
     return;
   }
-
-  for (uint32_t i=0; i<NUM_TRAINER; i++) {
-    while (inputbitsavailable < 11) {
-      inputbits |= *sbus++ << inputbitsavailable;
-      inputbitsavailable += 8;
-    }
-    *pulses++ = ((int32_t) (inputbits & 0x7FF) - 0x3E0) * 5 / 8;
-    inputbitsavailable -= 11;
-    inputbits >>= 11;
+  if (flags & SBUS_FLAG_FRAME_LOST) {
+    sbusStats.lostFrames++;
   }
 
+  sbusUnpackChannels(&sbus[1], &pulses[0]);
+#if NUM_TRAINER > 8
+  sbusUnpackChannels(&sbus[12], &pulses[8]);
+#endif
+
+  sbusStats.frames++;
   ppmInValid = PPM_IN_VALID_TIMEOUT;
 }
 
-#define SBUS_DELAY 1000 // 500uS
-void processSbusInput()
+// Frames are decoded as soon as their last byte is received. Blocks may be any
+// size, from a single byte from the USART interrupt up to whole frames received
+// by DMA. A frame starts after a gap on the line, or right after a valid frame.
+// Once out of sync the bytes are dropped until the next gap, as the channels
+// data may contain start and end bytes.
+void processSbusData(const uint8_t * data, int len)
 {
-  uint8_t rxchar;
-  uint32_t active = 0;
-  while (sbusFifo.pop(rxchar)) {
-    active = 1;
-    SbusFrame[SbusIndex++] = rxchar;
-    if (SbusIndex > 27) {
-      SbusIndex = 27;
+  for (int i=0; i<len; i++) {
+    uint8_t byte = data[i];
+    if (SbusIndex == 0) {
+      if (!SbusFrameStart) {
+        continue; // out of sync
+      }
+      SbusFrameStart = false;
+      if (byte != SBUS_START_BYTE) {
+        sbusStats.errors++;
+        continue;
+      }
     }
+    SbusFrame[SbusIndex++] = byte;
+    if (SbusIndex == SBUS_FRAME_SIZE) {
+      SbusIndex = 0;
+      if (isSbusEndByte(byte)) {
+        processSbusFrame(SbusFrame, g_ppmIns, SBUS_FRAME_SIZE);
+        uint16_t latency = getTmr2MHz() - sbusRxTime;
+        if (latency > sbusLatencyMax)
+          sbusLatencyMax = latency;
+        SbusFrameStart = true;
+      }
+      else {
+        sbusStats.errors++;
+      }
+    }
+  }
+}
+
+void processSbusInput()
+{
+  const uint8_t * data;
+  int count;
+  bool active = false;
+
+  while ((count = sbusFifo.readSpan(data)) > 0) {
+    processSbusData(data, count);
+    sbusFifo.consume(count);
+    active = true;
   }
+
   if (active) {
     SbusTimer = getTmr2MHz();
-    return;
   }
-  else {
+  else if ((uint16_t)(getTmr2MHz() - SbusTimer) > SBUS_DELAY) {
     if (SbusIndex) {
-      if ((uint16_t) (getTmr2MHz() - SbusTimer) > SBUS_DELAY) {
-        processSbusFrame(SbusFrame, g_ppmIns, SbusIndex);
-        SbusIndex = 0;
-      }
+      // frame shorter than 25 bytes, decoded as before if the channels are there
+      processSbusFrame(SbusFrame, g_ppmIns, SbusIndex);
+      SbusIndex = 0;
     }
+    SbusFrameStart = true;
+  }
+
+  tmr10ms_t now = get_tmr10ms();
+  if ((tmr10ms_t)(now - sbusStatsTime) >= 100) {
+    sbusStatsTime = now;
+    sbusStats.rate = sbusStats.frames - sbusStatsFrames;
+    sbusStatsFrames = sbusStats.frames;
+    sbusStats.latency = sbusLatencyMax / 2;
+    sbusLatencyMax = 0;
   }
 }
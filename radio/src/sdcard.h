@@ -67,6 +67,10 @@
 
 extern FATFS g_FATFS_Obj;
 
+#if defined(CPUARM)
+  #include "targets/common_arm/diskio_cache.h"
+#endif
+
 extern uint8_t logDelay;
 extern const pm_char * openLogs();
 void writeHeader();
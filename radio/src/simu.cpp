@@ -429,6 +429,13 @@ int main(int argc,char **argv)
   StartEepromThread(argc >= 2 ? argv[1] : "eeprom.bin");
   StartMainThread();
 
+#if defined(CPUARM) && defined(FRSKY)
+  // simu [eeprom.bin [sport.cap [speed]]] replays a SPORT_FILE_LOG capture, or an older sport.log
+  if (argc >= 3) {
+    telemetryReplayOpen(argv[2], argc >= 4 ? atoi(argv[3]) : 1);
+  }
+#endif
+
 #if defined(PCBTARANIS)
   simuSetSwitch(0, 0);
   simuSetSwitch(1, 0);
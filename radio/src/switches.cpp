@@ -462,26 +462,12 @@ DurationAndDelayProcessing:
   return result;
 }
 
-#if defined(CPUARM)
-bool getSwitch(int8_t swtch, uint8_t flags)
-#else
-bool getSwitch(int8_t swtch)
-#endif
+// The physical switches, the multipos switches, the trims and the rotary encoders
+static bool getHardwareSwitch(uint8_t cs_idx, uint8_t flags)
 {
-  bool result;
-
-  if (swtch == SWSRC_NONE)
-    return true;
+  bool result = false;
 
-  uint8_t cs_idx = abs(swtch);
-
-  if (cs_idx == SWSRC_One) {
-    result = !s_mixer_first_run_done;
-  }
-  else if (cs_idx == SWSRC_ON) {
-    result = true;
-  }
-  else if (cs_idx <= SWSRC_LAST_SWITCH) {
+  if (cs_idx <= SWSRC_LAST_SWITCH) {
 #if defined(PCBTARANIS)
     if (flags & GETSWITCH_MIDPOS_DELAY)
       result = SWITCH_POSITION(cs_idx-SWSRC_FIRST_SWITCH);
@@ -524,6 +510,76 @@ bool getSwitch(int8_t swtch)
     result = REB_DOWN();
   }
 #endif
+
+  return result;
+}
+
+#if defined(CPUARM)
+uint32_t switchesSnapshot[SWITCHES_SNAPSHOT_WORDS];
+#if defined(PCBTARANIS)
+uint32_t switchesMidposSnapshot[SWITCHES_SNAPSHOT_WORDS];
+#endif
+bool switchesSnapshotValid = false;
+
+// Reads all the hardware switches once, at the start of a mixer cycle, so that
+// the mixer, the logical switches, the functions and the timers see the same
+// switches state during the whole cycle
+void takeSwitchesSnapshot()
+{
+  memclear(switchesSnapshot, sizeof(switchesSnapshot));
+#if defined(PCBTARANIS)
+  memclear(switchesMidposSnapshot, sizeof(switchesMidposSnapshot));
+#endif
+  for (uint8_t i=SWSRC_FIRST_SWITCH; i<SWSRC_FIRST_LOGICAL_SWITCH; i++) {
+    if (getHardwareSwitch(i, 0)) {
+      switchesSnapshot[i/32] |= ((uint32_t)1 << (i%32));
+    }
+#if defined(PCBTARANIS)
+    if (i <= SWSRC_LAST_SWITCH && getHardwareSwitch(i, GETSWITCH_MIDPOS_DELAY)) {
+      switchesMidposSnapshot[i/32] |= ((uint32_t)1 << (i%32));
+    }
+#endif
+  }
+  switchesSnapshotValid = true;
+}
+#endif
+
+#if defined(CPUARM)
+bool getSwitch(int8_t swtch, uint8_t flags)
+#else
+bool getSwitch(int8_t swtch)
+#endif
+{
+  bool result;
+
+  if (swtch == SWSRC_NONE)
+    return true;
+
+  uint8_t cs_idx = abs(swtch);
+
+  if (cs_idx == SWSRC_One) {
+    result = !s_mixer_first_run_done;
+  }
+  else if (cs_idx == SWSRC_ON) {
+    result = true;
+  }
+  else if (cs_idx < SWSRC_FIRST_LOGICAL_SWITCH) {
+#if defined(CPUARM)
+    if (switchesSnapshotValid) {
+#if defined(PCBTARANIS)
+      if (flags & GETSWITCH_MIDPOS_DELAY)
+        result = SWITCHES_SNAPSHOT_BIT(switchesMidposSnapshot, cs_idx);
+      else
+#endif
+      result = SWITCHES_SNAPSHOT_BIT(switchesSnapshot, cs_idx);
+    }
+    else {
+      result = getHardwareSwitch(cs_idx, flags);
+    }
+#else
+    result = getHardwareSwitch(cs_idx, 0);
+#endif
+  }
 #if defined(CPUARM) && defined(FLIGHT_MODES)
   else if (cs_idx >= SWSRC_FIRST_FLIGHT_MODE) {
     uint8_t idx = cs_idx - SWSRC_FIRST_FLIGHT_MODE;
@@ -0,0 +1,144 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "../../opentx.h"
+
+struct SdCacheEntry {
+  uint32_t sector;
+  uint16_t lastUse;
+  bool valid;
+  uint8_t data[512];
+};
+
+static SdCacheEntry sdCache[SD_CACHE_SECTORS];
+static uint16_t sdCacheCounter = 0;
+SdStats sdStats;
+
+static SdCacheEntry * sdCacheFind(uint32_t sector)
+{
+  for (int i=0; i<SD_CACHE_SECTORS; i++) {
+    if (sdCache[i].valid && sdCache[i].sector == sector) {
+      return &sdCache[i];
+    }
+  }
+  return NULL;
+}
+
+bool sdCacheRead(uint8_t * buff, uint32_t sector)
+{
+  SdCacheEntry * entry = sdCacheFind(sector);
+  if (entry) {
+    entry->lastUse = ++sdCacheCounter;
+    memcpy(buff, entry->data, 512);
+    sdStats.cacheHits++;
+    return true;
+  }
+  sdStats.cacheMisses++;
+  return false;
+}
+
+void sdCacheStore(const uint8_t * buff, uint32_t sector)
+{
+  SdCacheEntry * entry = sdCacheFind(sector);
+  if (!entry) {
+    entry = &sdCache[0];
+    for (int i=0; i<SD_CACHE_SECTORS; i++) {
+      if (!sdCache[i].valid) {
+        entry = &sdCache[i];
+        break;
+      }
+      if ((int16_t)(sdCache[i].lastUse - entry->lastUse) < 0) {
+        entry = &sdCache[i];
+      }
+    }
+  }
+  entry->sector = sector;
+  entry->lastUse = ++sdCacheCounter;
+  entry->valid = true;
+  memcpy(entry->data, buff, 512);
+}
+
+// Write-through: the cached copies of the written sectors are kept up to date
+void sdCacheWrite(const uint8_t * buff, uint32_t sector, uint32_t count)
+{
+  for (int i=0; i<SD_CACHE_SECTORS; i++) {
+    if (sdCache[i].valid && sdCache[i].sector >= sector && sdCache[i].sector - sector < count) {
+      memcpy(sdCache[i].data, buff + (sdCache[i].sector - sector) * 512, 512);
+    }
+  }
+}
+
+void sdCacheFlush()
+{
+  for (int i=0; i<SD_CACHE_SECTORS; i++) {
+    sdCache[i].valid = false;
+  }
+}
+
+uint32_t sdStatsTime(uint16_t tmr2MHz)
+{
+  return ((uint32_t)(uint16_t)get_tmr10ms() << 16) + tmr2MHz;
+}
+
+uint32_t sdStatsDuration(uint32_t start, uint32_t end)
+{
+  uint16_t ticks = (end >> 16) - (start >> 16);
+  if (ticks > 2) {
+    // more than 20ms, the 2MHz timer may have wrapped
+    return (uint32_t)ticks * 20000;
+  }
+  else {
+    return (uint16_t)(end - start);
+  }
+}
+
+void sdStatsRead(uint32_t count, uint32_t duration)
+{
+  sdStats.readSectors += count;
+  sdStats.readTime += duration;
+  if (duration > sdStats.readMaxTime) {
+    sdStats.readMaxTime = duration;
+  }
+}
+
+void sdStatsWrite(uint32_t count, uint32_t duration)
+{
+  sdStats.writeSectors += count;
+  sdStats.writeTime += duration;
+  if (duration > sdStats.writeMaxTime) {
+    sdStats.writeMaxTime = duration;
+  }
+}
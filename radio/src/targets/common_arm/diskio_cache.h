@@ -0,0 +1,74 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef diskio_cache_h
+#define diskio_cache_h
+
+#include <inttypes.h>
+
+// FatFs reads the FAT and directory sectors one at a time into its window
+// buffer, the last ones are kept here as they are read again and again when
+// audio, logs and Lua files are accessed at the same time
+#if !defined(SD_CACHE_SECTORS)
+  #define SD_CACHE_SECTORS     4
+#endif
+
+struct SdStats {
+  uint32_t readSectors;
+  uint32_t readTime;           // in 0.5us
+  uint32_t readMaxTime;        // in 0.5us, longest disk_read()
+  uint32_t writeSectors;
+  uint32_t writeTime;          // in 0.5us
+  uint32_t writeMaxTime;       // in 0.5us, longest disk_write()
+  uint32_t cacheHits;
+  uint32_t cacheMisses;
+};
+
+extern SdStats sdStats;
+
+bool sdCacheRead(uint8_t * buff, uint32_t sector);
+void sdCacheStore(const uint8_t * buff, uint32_t sector);
+void sdCacheWrite(const uint8_t * buff, uint32_t sector, uint32_t count);
+void sdCacheFlush();
+
+// the SD timers count at 2MHz on 16 bits and wrap after 32.7ms, the 10ms
+// tick is kept in the upper half to measure the longer accesses
+uint32_t sdStatsTime(uint16_t tmr2MHz);
+uint32_t sdStatsDuration(uint32_t start, uint32_t end);
+void sdStatsRead(uint32_t count, uint32_t duration);
+void sdStatsWrite(uint32_t count, uint32_t duration);
+
+#endif
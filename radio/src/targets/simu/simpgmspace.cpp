@@ -56,7 +56,7 @@ FILE *fp = NULL;
 #if defined(PCBTARANIS)
 uint32_t Peri1_frequency, Peri2_frequency;
 GPIO_TypeDef gpioa, gpiob, gpioc, gpiod, gpioe, gpiof, gpiog;
-TIM_TypeDef tim1, tim2, tim3, tim4, tim8, tim10;
+TIM_TypeDef tim1, tim2, tim3, tim4, tim7, tim8, tim10;
 RCC_TypeDef rcc;
 DMA_Stream_TypeDef dma2_stream2, dma2_stream6;
 DMA_TypeDef dma2;
@@ -231,7 +231,7 @@ void simuSetSwitch(uint8_t swtch, int8_t state)
     SWITCH_CASE(5, ping, 1<<INP_G_Gear)
     SWITCH_CASE(6, pinb, 1<<INP_L_Trainer)
 #else // PCB9X
-#if defined(JETI) || defined(FRSKY) || defined(NMEA) || defined(ARDUPILOT)
+#if defined(JETI) || defined(FRSKY) || defined(NMEA) || defined(ARDUPILOT) || defined(MAVLINK)
     SWITCH_CASE(0, pinc, 1<<INP_C_ThrCt)
     SWITCH_CASE(4, pinc, 1<<INP_C_AileDR)
 #else
@@ -339,6 +339,9 @@ void *main_thread(void *)
     s_current_protocol[0] = 0;
 
     while (main_thread_running) {
+#if defined(CPUARM) && defined(FRSKY)
+      telemetryReplayWakeup();
+#endif
 #if defined(CPUARM)
       doMixerCalculations();
       checkTrims();
@@ -100,7 +100,7 @@ typedef const int8_t pm_int8_t;
 
 #if defined(PCBTARANIS)
 extern GPIO_TypeDef gpioa, gpiob, gpioc, gpiod, gpioe, gpiof, gpiog;
-extern TIM_TypeDef tim1, tim3, tim4, tim8, tim10;
+extern TIM_TypeDef tim1, tim3, tim4, tim7, tim8, tim10;
 extern USART_TypeDef Usart0, Usart1, Usart2, Usart3, Usart4;
 extern RCC_TypeDef rcc;
 extern DMA_Stream_TypeDef dma2_stream2, dma2_stream6;
@@ -122,11 +122,13 @@ extern DMA_TypeDef dma2;
 #undef TIM1
 #undef TIM3
 #undef TIM4
+#undef TIM7
 #undef TIM8
 #undef TIM10
 #define TIM1 (&tim1)
 #define TIM3 (&tim3)
 #define TIM4 (&tim4)
+#define TIM7 (&tim7)
 #define TIM8 (&tim8)
 #define TIM10 (&tim10)
 #undef USART0
@@ -424,6 +426,7 @@ extern char simuSdDirectory[1024];
 #define sdPoll10ms()
 #define sd_card_ready()  (true)
 #define sdMounted()      (true)
+#define sdMountId()      (1)
 #define SD_IS_HC()       (0)
 #define SD_GET_BLOCKNR() (0)
 #define SD_GET_SIZE_MB() (0)
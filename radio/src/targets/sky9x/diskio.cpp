@@ -47,6 +47,10 @@
 #include "../FatFs/diskio.h"
 #include "../FatFs/ff.h"
 #include "../CoOS/kernel/CoOS.h"
+#include "../common_arm/diskio_cache.h"
+
+#define SD_TIMER()      (TC1->TC_CHANNEL[0].TC_CV) /* 2MHz, same as getTmr2MHz() */
+#define SD_READ_TIMEOUT 200000 /* in 0.5us, for a multiple blocks read */
 
 #define CARD_TYPE_bmHC           (1 << 0)   /**< Bit for High-Capacity(Density) */
 #define CARD_TYPE_bmSDMMC        (0x3 << 1) /**< Bits mask for SD/MMC */
@@ -510,6 +514,13 @@ const char * sdCmd7()
                                      | HSMCI_CMDR_TRCMD_START_DATA | HSMCI_CMDR_TRDIR_READ \
                                      | HSMCI_CMDR_TRTYP_SINGLE | HSMCI_CMDR_MAXLAT)
 
+#define SD_READ_MULTIPLE_BLOCK   (18 | HSMCI_CMDR_SPCMD_STD | HSMCI_CMDR_RSPTYP_48_BIT \
+                                     | HSMCI_CMDR_TRCMD_START_DATA | HSMCI_CMDR_TRDIR_READ \
+                                     | HSMCI_CMDR_TRTYP_MULTIPLE | HSMCI_CMDR_MAXLAT)
+
+#define SD_STOP_TRANSMISSION     (12 | HSMCI_CMDR_SPCMD_STD | HSMCI_CMDR_RSPTYP_R1B \
+                                     | HSMCI_CMDR_TRCMD_STOP_DATA | HSMCI_CMDR_MAXLAT)
+
 #define SD_WRITE_SINGLE_BLOCK    (24 | HSMCI_CMDR_SPCMD_STD \
                                      | HSMCI_CMDR_RSPTYP_48_BIT \
                                      | HSMCI_CMDR_TRCMD_START_DATA \
@@ -1160,6 +1171,64 @@ uint32_t sd_read_block(uint32_t block_no, uint32_t *data)
   return 0;
 }
 
+// Reads count blocks with a single CMD18, the PDC transfers them straight into data
+uint32_t sd_read_blocks(uint32_t block_no, uint32_t *data, uint32_t count)
+{
+  unsigned int status = 0;
+
+  if (count == 1) {
+    return sd_read_block(block_no, data);
+  }
+
+  if (sd_card_ready()) {
+
+      // Wait for card to be ready for data transfers
+      do {
+        sdCmd13(&status);
+      }
+      while (((status & STATUS_READY_FOR_DATA) == 0)
+          || ((status & STATUS_STATE) != STATUS_TRAN) );
+
+      // Block size = 512, nblocks = count
+      HSMCI->HSMCI_BLKR = ((512) << 16) | count;
+      HSMCI->HSMCI_MR   = (HSMCI->HSMCI_MR & (~(HSMCI_MR_BLKLEN_Msk|HSMCI_MR_FBYTE))) | (HSMCI_MR_PDCMODE|HSMCI_MR_WRPROOF|HSMCI_MR_RDPROOF) | (512 << 16);
+      HSMCI->HSMCI_ARGR = (Cmd_A41_resp & OCR_SD_CCS ? block_no : (block_no << 9));
+      HSMCI->HSMCI_RPR  = (uint32_t)data;
+      HSMCI->HSMCI_RCR  = count * 512 / 4;
+      HSMCI->HSMCI_PTCR = HSMCI_PTCR_RXTEN;
+      HSMCI->HSMCI_CMDR = SD_READ_MULTIPLE_BLOCK;
+
+      while (!(HSMCI->HSMCI_SR & HSMCI_SR_CMDRDY));
+
+      (void) HSMCI->HSMCI_RSPR[0];
+
+      // a card removed during the transfer would never complete it
+      uint16_t t = SD_TIMER();
+      uint32_t elapsed = 0;
+      while ((HSMCI->HSMCI_SR & (HSMCI_SR_ENDRX|HSMCI_SR_XFRDONE)) != (HSMCI_SR_ENDRX|HSMCI_SR_XFRDONE)) {
+        uint16_t now = SD_TIMER();
+        elapsed += (uint16_t)(now - t);
+        t = now;
+        if (elapsed > SD_READ_TIMEOUT) {
+          break;
+        }
+      }
+
+      /* Disable PDC */
+      HSMCI->HSMCI_MR &= ~(uint32_t)HSMCI_MR_PDCMODE;
+      HSMCI->HSMCI_PTCR = HSMCI_PTCR_RXTDIS | HSMCI_PTCR_TXTDIS;
+
+      if (sdCommand(SD_STOP_TRANSMISSION, 0) || elapsed > SD_READ_TIMEOUT) {
+        return 0;
+      }
+      while (!(HSMCI->HSMCI_SR & HSMCI_SR_NOTBUSY));
+
+      return 1;
+  }
+
+  return 0;
+}
+
 uint32_t sd_write_block( uint32_t block_no, uint32_t *data )
 {
   unsigned int status = 0;
@@ -1248,6 +1317,7 @@ DSTATUS disk_initialize (
 {
   if (drv) return STA_NOINIT;             /* Supports only single drive */
   if ( sd_card_ready() == 0 ) return RES_NOTRDY;
+  sdCacheFlush();
   return RES_OK;
 }
 
@@ -1283,22 +1353,48 @@ DRESULT disk_read (
 
   if ( sd_card_ready() == 0 ) return RES_NOTRDY;
 
-  do {
-    result = sd_read_block(sector, dma_sd_buffer) ;
+  // FAT and directory sectors are read one at a time into the FatFs window
+  bool cached = (count == 1 && buff == g_FATFS_Obj.win);
+  if (cached && sdCacheRead(buff, sector)) {
+    return RES_OK;
+  }
+
+  uint32_t t0 = sdStatsTime(SD_TIMER());
+  BYTE * dest = buff;
+  DWORD first = sector;
+  UINT total = count;
+
+  if (((uint32_t)buff & 3) == 0) {
+    // the PDC writes words, aligned buffers are filled directly
+    result = sd_read_blocks(sector, (uint32_t *)buff, count);
     if (result) {
-      memcpy(buff, dma_sd_buffer, 512);
-      sector += 1 ;
-      buff += 512 ;
-      count -= 1 ;
+      count = 0;
     }
-    else {
-      count = 1 ;             // Flag error
-      break ;
-    }
-  } while ( count ) ;
+  }
+  else {
+    do {
+      result = sd_read_block(sector, dma_sd_buffer) ;
+      if (result) {
+        memcpy(buff, dma_sd_buffer, 512);
+        sector += 1 ;
+        buff += 512 ;
+        count -= 1 ;
+      }
+      else {
+        count = 1 ;             // Flag error
+        break ;
+      }
+    } while ( count ) ;
+  }
 
-  if (!count)
+  sdStatsRead(total, sdStatsDuration(t0, sdStatsTime(SD_TIMER())));
+
+  if (!count) {
+    if (cached) {
+      sdCacheStore(dest, first);
+    }
     return RES_OK;
+  }
 
   if (++sdErrorCount > 3)
     Card_state = SD_ST_ERR;
@@ -1326,13 +1422,21 @@ DRESULT disk_write (
 
   if ( sd_card_ready() == 0 ) return RES_NOTRDY;
 
+  uint32_t t0 = sdStatsTime(SD_TIMER());
+  UINT total = count;
+  sdCacheWrite(buff, sector, count);
+
   do {
 
     while  (1) {
 
-      memcpy(dma_sd_buffer, buff, 512);
-
-      result = sd_write_block(sector, dma_sd_buffer) ;
+      if (((uint32_t)buff & 3) == 0) {
+        result = sd_write_block(sector, (uint32_t *)buff) ;
+      }
+      else {
+        memcpy(dma_sd_buffer, buff, 512);
+        result = sd_write_block(sector, dma_sd_buffer) ;
+      }
 
       sd_read_block(sector, dma_sd_buffer) ;
 
@@ -1356,10 +1460,14 @@ DRESULT disk_write (
     }
   } while ( count ) ;
 
+  sdStatsWrite(total, sdStatsDuration(t0, sdStatsTime(SD_TIMER())));
+
   if (!count) {
     return RES_OK;
   }
 
+  sdCacheFlush(); // the sectors content is unknown after an error
+
   if (++sdErrorCount > 3)
     Card_state = SD_ST_ERR;
 
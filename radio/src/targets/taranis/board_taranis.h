@@ -130,6 +130,7 @@ void delay_01us(uint16_t nb);
   void sdPoll10ms(void);
   #define sdMountPoll()
   uint32_t sdMounted(void);
+  uint16_t sdMountId(void);
   #define SD_CARD_PRESENT()       (~SD_PRESENT_GPIO->IDR & SD_PRESENT_GPIO_Pin)
 #endif
 
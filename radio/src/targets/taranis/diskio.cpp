@@ -42,6 +42,12 @@
 #include "hal.h"
 #include "debug.h"
 
+#if !defined(BOOT)
+#include "../common_arm/diskio_cache.h"
+#define SD_TIMER()      (TIM7->CNT) /* 2MHz, same as getTmr2MHz() */
+extern FATFS g_FATFS_Obj;
+#endif
+
 /* Definitions for MMC/SDC command */
 #define CMD0    (0x40+0)        /* GO_IDLE_STATE */
 #define CMD1    (0x40+1)        /* SEND_OP_COND (MMC) */
@@ -674,6 +680,10 @@ DSTATUS disk_initialize (
   CardType = ty;
   release_spi();
 
+#if !defined(BOOT)
+  sdCacheFlush();
+#endif
+
   if (ty) {                       /* Initialization succeeded */
     Stat &= ~STA_NOINIT;            /* Clear STA_NOINIT */
     interface_speed(INTERFACE_FAST);
@@ -703,6 +713,7 @@ DSTATUS disk_status (
 /* Read Sector(s)                                                        */
 /*-----------------------------------------------------------------------*/
 
+/* Multiple blocks are read with CMD18, each block is transferred by DMA straight into buff */
 int8_t SD_ReadSectors(uint8_t *buff, uint32_t sector, uint32_t count)
 {
   if (!(CardType & CT_BLOCK)) sector *= 512;      /* Convert to byte address if needed */
@@ -746,8 +757,22 @@ DRESULT disk_read (
 {
   if (drv || !count) return RES_PARERR;
   if (Stat & STA_NOINIT) return RES_NOTRDY;
+#if !defined(BOOT)
+  /* FAT and directory sectors are read one at a time into the FatFs window */
+  bool cached = (count == 1 && buff == g_FATFS_Obj.win);
+  if (cached && sdCacheRead(buff, sector)) {
+    return RES_OK;
+  }
+  uint32_t t0 = sdStatsTime(SD_TIMER());
+#endif
   int8_t res = SD_ReadSectors(buff, sector, count);
   TRACE_SD_CARD_EVENT((res != 0), sd_disk_read, (count << 24) + (sector & 0x00FFFFFF));
+#if !defined(BOOT)
+  sdStatsRead(count, sdStatsDuration(t0, sdStatsTime(SD_TIMER())));
+  if (cached && res == 0) {
+    sdCacheStore(buff, sector);
+  }
+#endif
   return (res != 0) ? RES_ERROR : RES_OK;
 }
 
@@ -759,6 +784,11 @@ DRESULT disk_read (
 
 int8_t SD_WriteSectors(const uint8_t *buff, uint32_t sector, uint32_t count)
 {
+#if !defined(BOOT)
+  /* also called by the USB mass storage, the cached sectors are updated here */
+  sdCacheWrite(buff, sector, count);
+#endif
+
   if (!(CardType & CT_BLOCK)) sector *= 512;      /* Convert to byte address if needed */
 
   if (count == 1) {       /* Single block write */
@@ -788,6 +818,12 @@ int8_t SD_WriteSectors(const uint8_t *buff, uint32_t sector, uint32_t count)
   release_spi();
   TRACE_SD_CARD_EVENT((count != 0), sd_SD_WriteSectors, (count << 24) + ((sector/((CardType & CT_BLOCK) ? 1 : 512)) & 0x00FFFFFF));
 
+#if !defined(BOOT)
+  if (count) {
+    sdCacheFlush();  /* the sectors content is unknown after an error */
+  }
+#endif
+
   return count ? -1 : 0;
 }
 
@@ -803,8 +839,14 @@ DRESULT disk_write (
   if (drv || !count) return RES_PARERR;
   if (Stat & STA_NOINIT) return RES_NOTRDY;
   if (Stat & STA_PROTECT) return RES_WRPRT;
+#if !defined(BOOT)
+  uint32_t t0 = sdStatsTime(SD_TIMER());
+#endif
   int8_t res = SD_WriteSectors(buff, sector, count);
   TRACE_SD_CARD_EVENT((res != 0), sd_disk_write, (count << 24) + (sector & 0x00FFFFFF));
+#if !defined(BOOT)
+  sdStatsWrite(count, sdStatsDuration(t0, sdStatsTime(SD_TIMER())));
+#endif
   return (res != 0) ? RES_ERROR : RES_OK;
 }
 #endif /* _READONLY == 0 */
@@ -1009,9 +1051,6 @@ void sdPoll10ms()
 // TODO everything here should not be in the driver layer ...
 
 FATFS g_FATFS_Obj;
-#if defined(SPORT_FILE_LOG)
-FIL g_telemetryFile = {0};
-#endif
 
 #if defined(BOOT)
 void sdInit(void)
@@ -1034,10 +1073,7 @@ void sdInit(void)
     referenceSystemAudioFiles();
     
 #if defined(SPORT_FILE_LOG)
-    f_open(&g_telemetryFile, LOGS_PATH "/sport.log", FA_OPEN_ALWAYS | FA_WRITE);
-    if (f_size(&g_telemetryFile) > 0) {
-      f_lseek(&g_telemetryFile, f_size(&g_telemetryFile)); // append
-    }
+    telemetryCaptureStart(LOGS_PATH "/sport.cap");
 #endif
   }
 }
@@ -1047,7 +1083,7 @@ void sdDone()
   if (sdMounted()) {
     audioQueue.stopSD();
 #if defined(SPORT_FILE_LOG)
-    f_close(&g_telemetryFile);
+    telemetryCaptureStop();
 #endif
     f_mount(NULL, "", 0); // unmount SD
   }
@@ -1059,4 +1095,9 @@ uint32_t sdMounted()
   return g_FATFS_Obj.fs_type != 0;
 }
 
+uint16_t sdMountId()
+{
+  return sdMounted() ? g_FATFS_Obj.id : 0;
+}
+
 
@@ -107,8 +107,13 @@ extern "C" void USART2_IRQHandler()
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     data = SPORT->DR;
 
-    if (!(status & USART_FLAG_ERRORS))
+    if (!(status & USART_FLAG_ERRORS)) {
+#if defined(TELEMETRY_CAPTURE)
+      if (data == START_STOP)
+        telemetryCaptureStamp();
+#endif
       telemetryFifo.push(data);
+    }
 
     status = SPORT->SR;
   }
@@ -266,8 +266,10 @@ extern "C" void USART6_IRQHandler()
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     data = USART6->DR;
 
-    if (!(status & USART_FLAG_ERRORS))
+    if (!(status & USART_FLAG_ERRORS)) {
       sbusFifo.push(data);
+      sbusRxTime = getTmr2MHz();
+    }
 
     status = USART6->SR;
   }
@@ -155,6 +155,7 @@ extern "C" void USART3_IRQHandler(void)
           break;
         case UART_MODE_SBUS_TRAINER:
           sbusFifo.push(data);
+          sbusRxTime = getTmr2MHz();
           break;
       }
     }
@@ -0,0 +1,201 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#include "../opentx.h"
+
+#if defined(TELEMETRY_CAPTURE)
+
+// Frames are stamped by the receive interrupt, queued by telemetryWakeup()
+// in the mixer task, and written to the SD card by the menus task in chunks
+// of TELEMETRY_CAPTURE_WRITE_SIZE bytes.
+
+TelemetryCaptureStamp telemetryCaptureStamps[TELEMETRY_CAPTURE_STAMPS];
+uint32_t telemetryCaptureStampsCount = 0;
+TelemetryCaptureStats telemetryCaptureStats;
+extern uint8_t telemetryProtocol;
+
+struct TelemetryCapture {
+  FIL       file;
+  bool      running;
+  uint32_t  stampsRead;
+  TelemetryCaptureStamp last;
+  bool      lastFine;     // last has a valid fine time
+  uint32_t  time;         // us since the header
+  uint32_t  frameTime;
+  tmr10ms_t lastWrite;
+};
+
+static TelemetryCapture telemetryCapture;
+static Fifo<TELEMETRY_CAPTURE_BUFFER> telemetryCaptureFifo;
+
+static void putCaptureValue(uint8_t * dest, uint32_t value, uint8_t size)
+{
+  for (uint8_t i=0; i<size; i++) {
+    dest[i] = value >> (8*i);
+  }
+}
+
+bool telemetryCaptureStart(const char * path)
+{
+  telemetryCaptureStop();
+
+  if (f_open(&telemetryCapture.file, path, FA_OPEN_ALWAYS | FA_WRITE) != FR_OK) {
+    return false;
+  }
+  if (f_size(&telemetryCapture.file) > 0) {
+    f_lseek(&telemetryCapture.file, f_size(&telemetryCapture.file)); // append
+  }
+
+  uint8_t header[TELEMETRY_CAPTURE_RECORD_SIZE + TELEMETRY_CAPTURE_HEADER_SIZE];
+  putCaptureValue(&header[0], TELEMETRY_CAPTURE_SESSION, 4);
+  header[4] = TELEMETRY_CAPTURE_HEADER_SIZE;
+  memcpy(&header[5], TELEMETRY_CAPTURE_MAGIC, 4);
+  header[9] = TELEMETRY_CAPTURE_VERSION;
+  header[10] = telemetryProtocol;
+  putCaptureValue(&header[11], 0, 2);
+#if defined(RTCLOCK)
+  putCaptureValue(&header[13], g_rtcTime, 4);
+#else
+  putCaptureValue(&header[13], 0, 4);
+#endif
+
+  telemetryCaptureFifo.clear();
+  telemetryCaptureFifo.push(header, sizeof(header));
+  memclear(&telemetryCaptureStats, sizeof(telemetryCaptureStats));
+  telemetryCapture.stampsRead = __atomic_load_n(&telemetryCaptureStampsCount, __ATOMIC_ACQUIRE);
+  telemetryCapture.last.coarse = get_tmr10ms();
+  telemetryCapture.lastFine = false;
+  telemetryCapture.time = 0;
+  telemetryCapture.frameTime = 0;
+  telemetryCapture.lastWrite = get_tmr10ms();
+  telemetryCapture.running = true;
+  return true;
+}
+
+void telemetryCaptureStop()
+{
+  if (telemetryCapture.running) {
+    telemetryCapture.running = false;
+    telemetryCaptureWakeup(true);
+    f_close(&telemetryCapture.file);
+  }
+}
+
+bool isTelemetryCaptureRunning()
+{
+  return telemetryCapture.running;
+}
+
+// Called for each START_STOP found in the received data, in the same order
+// as the receive interrupt stamped them. The 16 bits fine time wraps every
+// 32.768ms, the coarse time tells how many times it wrapped.
+void telemetryCaptureFrameStart()
+{
+  if (!telemetryCapture.running)
+    return;
+
+  TelemetryCaptureStamp stamp;
+  bool fine = false;
+  uint32_t count = __atomic_load_n(&telemetryCaptureStampsCount, __ATOMIC_ACQUIRE);
+  if (count - telemetryCapture.stampsRead > TELEMETRY_CAPTURE_STAMPS) {
+    // stamps were overwritten, the frames times will be those of the next ones
+    telemetryCapture.stampsRead = count - TELEMETRY_CAPTURE_STAMPS;
+  }
+  if (telemetryCapture.stampsRead != count) {
+    stamp = telemetryCaptureStamps[telemetryCapture.stampsRead++ % TELEMETRY_CAPTURE_STAMPS];
+    fine = true;
+  }
+  else {
+    stamp.coarse = get_tmr10ms();
+    stamp.fine = 0;
+  }
+
+  uint32_t delta = (tmr10ms_t)(stamp.coarse - telemetryCapture.last.coarse) * 10000;
+  if (fine && telemetryCapture.lastFine) {
+    uint32_t fineDelta = (uint16_t)(stamp.fine - telemetryCapture.last.fine) / 2;
+    uint32_t wraps = (delta + 16384 > fineDelta ? (delta + 16384 - fineDelta) / 32768 : 0);
+    delta = fineDelta + wraps * 32768;
+  }
+
+  telemetryCapture.time += delta;
+  telemetryCapture.frameTime = telemetryCapture.time;
+  telemetryCapture.last = stamp;
+  telemetryCapture.lastFine = fine;
+}
+
+void telemetryCaptureFrame(const uint8_t * data, uint8_t length)
+{
+  if (!telemetryCapture.running)
+    return;
+
+  if (TELEMETRY_CAPTURE_BUFFER - telemetryCaptureFifo.size() < TELEMETRY_CAPTURE_RECORD_SIZE + length) {
+    telemetryCaptureStats.dropped++;
+    return;
+  }
+
+  uint8_t record[TELEMETRY_CAPTURE_RECORD_SIZE];
+  putCaptureValue(record, telemetryCapture.frameTime, 4);
+  record[4] = length;
+  telemetryCaptureFifo.push(record, sizeof(record));
+  telemetryCaptureFifo.push(data, length);
+  telemetryCaptureStats.frames++;
+}
+
+// Called by the menus task. Full chunks only, unless flush is set or nothing
+// was written for 2s.
+void telemetryCaptureWakeup(bool flush)
+{
+  if (!telemetryCapture.file.fs)
+    return;
+
+  if ((tmr10ms_t)(get_tmr10ms() - telemetryCapture.lastWrite) >= 200) {
+    flush = true;
+  }
+
+  const uint8_t * data;
+  int count;
+  while ((flush || telemetryCaptureFifo.size() >= TELEMETRY_CAPTURE_WRITE_SIZE) && (count = telemetryCaptureFifo.readSpan(data)) > 0) {
+    UINT written;
+    count = min<int>(count, TELEMETRY_CAPTURE_WRITE_SIZE);
+    f_write(&telemetryCapture.file, data, count, &written);
+    telemetryCaptureFifo.consume(count);
+    telemetryCaptureStats.written += count;
+    telemetryCapture.lastWrite = get_tmr10ms();
+  }
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#ifndef TELEMETRY_CAPTURE_H
+#define TELEMETRY_CAPTURE_H
+
+// Binary telemetry captures, as written to LOGS/sport.cap when SPORT_FILE_LOG
+// is enabled, and read by the simulator replay and util/sportcap.cpp.
+// All values are little endian. The file is a sequence of records:
+//   uint32_t time       us since the session start, wraps after 71 minutes
+//   uint8_t  length
+//   uint8_t  data[length]
+//
+// Each recording session starts with a header record, with time = 0xFFFFFFFF:
+//   char     magic[4]   "SPCP"
+//   uint8_t  version    TELEMETRY_CAPTURE_VERSION
+//   uint8_t  protocol   telemetryProtocol of the model
+//   uint16_t spare
+//   uint32_t date       seconds since 1970, 0 when unknown
+//
+// The other records are the frames received: the bytes between two START_STOP,
+// still stuffed, with the time at which the first START_STOP was received.
+
+#define TELEMETRY_CAPTURE_MAGIC         "SPCP"
+#define TELEMETRY_CAPTURE_VERSION       1
+#define TELEMETRY_CAPTURE_SESSION       0xFFFFFFFF
+#define TELEMETRY_CAPTURE_HEADER_SIZE   12
+#define TELEMETRY_CAPTURE_RECORD_SIZE   5  /*without the data*/
+
+#endif
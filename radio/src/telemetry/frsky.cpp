@@ -266,6 +266,96 @@ NOINLINE void processSerialData(uint8_t data)
 #endif
 }
 
+#if defined(PCBTARANIS)
+// Frame-at-a-time reception: the raw bytes between two START_STOP
+// delimiters are collected with block copies, then unstuffed and
+// dispatched as a whole frame. Gives the same results as processSerialData()
+uint8_t telemetryFrameBuffer[2*FRSKY_RX_PACKET_SIZE];
+int8_t telemetryFrameLength = -1; // -1 until the next START_STOP
+
+int frskyUnstuffFrame(uint8_t * dest, const uint8_t * src, int len, int max)
+{
+  const uint8_t * end = src + len;
+  int count = 0;
+  while (src < end && count < max) {
+    uint8_t byte = *src++;
+    if (byte == BYTESTUFF) {
+      if (src == end)
+        break;
+      byte = *src++ ^ STUFF_MASK;
+    }
+    dest[count++] = byte;
+  }
+  return count;
+}
+
+bool processTelemetryFrame(bool complete)
+{
+  frskyRxBufferCount = frskyUnstuffFrame(frskyRxBuffer, telemetryFrameBuffer, telemetryFrameLength, FRSKY_RX_PACKET_SIZE);
+
+#if defined(FRSKY_SPORT)
+  if (IS_FRSKY_SPORT_PROTOCOL()) {
+    if (frskyRxBufferCount >= FRSKY_SPORT_PACKET_SIZE) {
+      processSportPacket(frskyRxBuffer);
+      return true;
+    }
+    return false;
+  }
+#endif
+
+  if (complete && frskyRxBufferCount > 0) {
+    frskyDProcessPacket(frskyRxBuffer);
+    return true;
+  }
+  return false;
+}
+
+void processTelemetryData(const uint8_t * data, int len)
+{
+  if (g_eeGeneral.uart3Mode == UART_MODE_TELEMETRY_MIRROR) {
+    for (int i=0; i<len; i++) {
+      uart3Putc(data[i]);
+    }
+  }
+
+  const uint8_t * end = data + len;
+  while (data < end) {
+    const uint8_t * delimiter = (const uint8_t *)memchr(data, START_STOP, end - data);
+    const uint8_t * segmentEnd = (delimiter ? delimiter : end);
+
+    if (telemetryFrameLength >= 0) {
+      int count = min<int>(segmentEnd - data, sizeof(telemetryFrameBuffer) - telemetryFrameLength);
+      memcpy(&telemetryFrameBuffer[telemetryFrameLength], data, count);
+      telemetryFrameLength += count;
+      if (delimiter) {
+        if (telemetryFrameLength > 0) {
+#if defined(TELEMETRY_CAPTURE)
+          telemetryCaptureFrame(telemetryFrameBuffer, telemetryFrameLength);
+#endif
+          processTelemetryFrame(true);
+        }
+      }
+      else if (IS_FRSKY_SPORT_PROTOCOL() && telemetryFrameLength >= FRSKY_SPORT_PACKET_SIZE && processTelemetryFrame(false)) {
+#if defined(TELEMETRY_CAPTURE)
+        telemetryCaptureFrame(telemetryFrameBuffer, telemetryFrameLength);
+#endif
+        // the S.Port packet is complete, the remaining bytes until the next START_STOP are ignored
+        telemetryFrameLength = -1;
+      }
+    }
+
+    if (!delimiter)
+      break;
+
+#if defined(TELEMETRY_CAPTURE)
+    telemetryCaptureFrameStart();
+#endif
+    telemetryFrameLength = 0;
+    data = delimiter + 1;
+  }
+}
+#endif
+
 void telemetryWakeup()
 {
 #if defined(CPUARM)
@@ -277,25 +367,12 @@ void telemetryWakeup()
 #endif
 
 #if defined(PCBTARANIS)
-  uint8_t data;
-#if defined(SPORT_FILE_LOG) && !defined(SIMU)
-  static tmr10ms_t lastTime = 0;
-  tmr10ms_t newTime = get_tmr10ms();
-  struct gtm utm;
-  gettime(&utm);
-#endif
-  while (telemetryFifo.pop(data)) {
-    processSerialData(data);
-#if defined(SPORT_FILE_LOG) && !defined(SIMU)
-    extern FIL g_telemetryFile;
-    if (lastTime != newTime) {
-      f_printf(&g_telemetryFile, "\r\n%4d-%02d-%02d,%02d:%02d:%02d.%02d0: %02X", utm.tm_year+1900, utm.tm_mon+1, utm.tm_mday, utm.tm_hour, utm.tm_min, utm.tm_sec, g_ms100, data);
-      lastTime = newTime;
-    }
-    else {
-      f_printf(&g_telemetryFile, " %02X", data);
-    }
-#endif
+  const uint8_t * data;
+  int count;
+  // frames are parsed in place, straight from the fifo
+  while ((count = telemetryFifo.readSpan(data)) > 0) {
+    processTelemetryData(data, count);
+    telemetryFifo.consume(count);
   }
 #elif defined(PCBSKY9X)
   if (telemetryProtocol == PROTOCOL_FRSKY_D_SECONDARY) {
@@ -324,12 +401,7 @@ void telemetryWakeup()
 #endif
 
 #if defined(CPUARM)
-  for (int i=0; i<TELEM_VALUES_MAX; i++) {
-    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  evalCalculatedSensors();
 #endif
 
 #if defined(VARIO)
@@ -350,7 +422,7 @@ void telemetryWakeup()
       if (isTelemetryFieldAvailable(i)) {
         uint8_t lastReceived = telemetryItems[i].lastReceived;
         if (lastReceived < TELEMETRY_VALUE_TIMER_CYCLE && uint8_t(now - lastReceived) > TELEMETRY_VALUE_OLD_THRESHOLD) {
-          telemetryItems[i].lastReceived = TELEMETRY_VALUE_OLD;
+          telemetryItems[i].setOld();
         }
       }
     }
@@ -481,6 +553,8 @@ void telemetryReset()
   for (int index=0; index<TELEM_VALUES_MAX; index++) {
     telemetryItems[index].clear();
   }
+  resetTelemetryHistories();
+  invalidateCalculatedSensors();
 #endif
 
   frskyStreaming = 0; // reset counter only if valid frsky packets are being detected
@@ -588,6 +662,10 @@ void telemetryInit(void)
   telemetryPortInit();
 #endif
 
+#if defined(PCBTARANIS)
+  telemetryFrameLength = -1;
+#endif
+
   // we don't reset the telemetry here as we would also reset the consumption after model load
 }
 
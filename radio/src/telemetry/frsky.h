@@ -474,8 +474,13 @@ void processHubPacket(uint8_t id, int16_t value);
 void frskyDSendNextAlarm(void);
 void frskyDProcessPacket(uint8_t *packet);
 
+void processSerialData(uint8_t data);
+
 // FrSky S.PORT Protocol
 void processSportPacket(uint8_t *packet);
+#if defined(PCBTARANIS)
+void processTelemetryData(const uint8_t * data, int len);
+#endif
 
 void telemetryWakeup(void);
 void telemetryReset();
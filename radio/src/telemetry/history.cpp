@@ -0,0 +1,235 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#include "../opentx.h"
+
+TelemetryHistory telemetryHistories[TELEMETRY_HISTORY_MAX];
+uint8_t telemetryHistorySlots[TELEM_VALUES_MAX];
+
+void TelemetryHistoryRing::push(int32_t value)
+{
+  if (count < TELEMETRY_HISTORY_SAMPLES)
+    count++;
+  else
+    sum -= samples[next];
+  samples[next] = value;
+  sum += value;
+  next = (next + 1) % TELEMETRY_HISTORY_SAMPLES;
+}
+
+int32_t TelemetryHistoryRing::get(uint8_t age) const
+{
+  return samples[(next + TELEMETRY_HISTORY_SAMPLES - 1 - age) % TELEMETRY_HISTORY_SAMPLES];
+}
+
+int32_t TelemetryHistoryRing::average() const
+{
+  return count ? sum / count : 0;
+}
+
+// Least squares slope over the ring, in units per second
+// period: 10ms ticks between two samples
+int32_t TelemetryHistoryRing::slope(uint32_t period) const
+{
+  if (count < 2)
+    return 0;
+
+  int64_t sx=0, sxx=0, sxy=0;
+  for (uint8_t x=0; x<count; x++) {
+    int32_t y = get(count-1-x);
+    sx += x;
+    sxx += x*x;
+    sxy += (int64_t)x * y;
+  }
+  int64_t num = count*sxy - sx*sum;
+  int64_t den = (count*sxx - sx*sx) * period;
+  return (num * 100) / den;
+}
+
+int32_t TelemetryHistoryRing::percentile(uint8_t percent) const
+{
+  if (count == 0)
+    return 0;
+
+  int32_t sorted[TELEMETRY_HISTORY_SAMPLES];
+  for (uint8_t i=0; i<count; i++) {
+    int32_t value = samples[i];
+    uint8_t j = i;
+    for (; j>0 && sorted[j-1]>value; j--) {
+      sorted[j] = sorted[j-1];
+    }
+    sorted[j] = value;
+  }
+  return sorted[(percent * (count-1) + 50) / 100];
+}
+
+// Values are averaged over the period of scale 0, and every DECIMATION samples
+// of a scale are averaged into one sample of the next. Periods without any value
+// received are not filled.
+void TelemetryHistory::add(int32_t value)
+{
+  tmr10ms_t now = get_tmr10ms();
+
+  if (accumulated[0] && (tmr10ms_t)(now - periodStart) >= TELEMETRY_HISTORY_PERIOD) {
+    int32_t sample = accumulator[0] / accumulated[0];
+    accumulator[0] = accumulated[0] = 0;
+    for (uint8_t i=0; ; i++) {
+      scales[i].push(sample);
+      if (i == TELEMETRY_HISTORY_SCALES-1)
+        break;
+      accumulator[i+1] += sample;
+      if (++accumulated[i+1] < TELEMETRY_HISTORY_DECIMATION)
+        break;
+      sample = accumulator[i+1] / TELEMETRY_HISTORY_DECIMATION;
+      accumulator[i+1] = accumulated[i+1] = 0;
+    }
+  }
+
+  if (!accumulated[0]) {
+    periodStart = now;
+  }
+  accumulator[0] += value;
+  accumulated[0]++;
+}
+
+static TelemetryHistory * allocateTelemetryHistory(uint8_t index)
+{
+  TelemetryHistory * result = NULL;
+
+  // a free slot, or else the one which was read the longest time ago
+  for (int i=0; i<TELEMETRY_HISTORY_MAX; i++) {
+    TelemetryHistory & history = telemetryHistories[i];
+    if (!history.item) {
+      result = &history;
+      break;
+    }
+    else if (!history.pinned && (!result || (int32_t)(history.lastRead - result->lastRead) < 0)) {
+      result = &history;
+    }
+  }
+
+  if (result) {
+    if (result->item) {
+      telemetryHistorySlots[result->item-1] = 0;
+    }
+    memclear(result, sizeof(TelemetryHistory));
+    result->item = index + 1;
+    result->lastRead = get_tmr10ms();
+    telemetryHistorySlots[index] = result - telemetryHistories + 1;
+  }
+
+  return result;
+}
+
+// The history of a sensor, which starts being recorded on the first call
+TelemetryHistory * getTelemetryHistory(uint8_t index)
+{
+  uint8_t slot = telemetryHistorySlots[index];
+  if (slot) {
+    TelemetryHistory * history = &telemetryHistories[slot-1];
+    history->lastRead = get_tmr10ms();
+    return history;
+  }
+  return allocateTelemetryHistory(index);
+}
+
+void releaseTelemetryHistory(uint8_t index)
+{
+  uint8_t slot = telemetryHistorySlots[index];
+  if (slot) {
+    memclear(&telemetryHistories[slot-1], sizeof(TelemetryHistory));
+    telemetryHistorySlots[index] = 0;
+  }
+}
+
+// Called when the calculated sensors are sorted, items = the sensors read by a history sensor
+void pinTelemetryHistories(uint32_t items)
+{
+  for (int i=0; i<TELEMETRY_HISTORY_MAX; i++) {
+    TelemetryHistory & history = telemetryHistories[i];
+    history.pinned = (history.item && (items & ((uint32_t)1 << (history.item-1))));
+  }
+
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    if ((items & ((uint32_t)1 << i)) && !telemetryHistorySlots[i]) {
+      TelemetryHistory * history = allocateTelemetryHistory(i);
+      if (history) {
+        history->pinned = 1;
+      }
+    }
+  }
+}
+
+void resetTelemetryHistories()
+{
+  memclear(telemetryHistories, sizeof(telemetryHistories));
+  memclear(telemetryHistorySlots, sizeof(telemetryHistorySlots));
+}
+
+bool getTelemetryHistoryValue(uint8_t index, uint8_t stat, uint8_t scale, uint8_t percent, int32_t & value)
+{
+  uint8_t slot = telemetryHistorySlots[index];
+  if (!slot || scale >= TELEMETRY_HISTORY_SCALES)
+    return false;
+
+  const TelemetryHistoryRing & ring = telemetryHistories[slot-1].scales[scale];
+  if (ring.count == 0)
+    return false;
+
+  switch (stat) {
+    case TELEM_HISTORY_AVERAGE:
+      value = ring.average();
+      break;
+    case TELEM_HISTORY_SLOPE:
+    {
+      uint32_t period = TELEMETRY_HISTORY_PERIOD;
+      for (uint8_t i=0; i<scale; i++)
+        period *= TELEMETRY_HISTORY_DECIMATION;
+      if (ring.count < 2)
+        return false;
+      value = ring.slope(period);
+      break;
+    }
+    case TELEM_HISTORY_PERCENTILE:
+      value = ring.percentile(min<uint8_t>(percent, 100));
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
@@ -66,9 +66,19 @@ static uint8_t data_stream_start_stop = 0;
 // Telemetry data hold
 Telemetry_Data_t telemetry_data;
 
-// *****************************************************
+/*!	\brief Frame being received
+ *	\details The wire format (STX, LEN, SEQ, SYSID, COMPID, MSGID, payload,
+ *	CRC) is the same as the mavlink_message_t layout starting at the magic
+ *	field, so frames are received straight into the message, the payload and
+ *	CRC ending up where the mavlink_msg_*_get_*() functions expect them.
+ */
+static mavlink_message_t m_mavlink_message;
+static uint16_t mavlinkRxIndex = 0;
+#define MAVLINK_RX_FRAME ((uint8_t *)&m_mavlink_message.magic)
+
 static void MAVLINK_parse_char(uint8_t c);
 
+
 #ifdef DUMP_RX_TX
 #define MAX_RX_BUFFER 16
 uint8_t mavlinkRxBufferCount = 0;
@@ -110,6 +120,7 @@ void MAVLINK_reset(uint8_t warm_reset) {
 	mavlink_status_t* p_status = mavlink_get_channel_status(MAVLINK_COMM_0);
 	p_status->current_rx_seq = 0;
 	p_status->current_tx_seq = 0;
+	mavlinkRxIndex = 0;
 	memset(&telemetry_data, 0, sizeof(telemetry_data));
 	telemetry_data.rcv_control_mode = ERROR_NUM_MODES;
 	telemetry_data.req_mode = ERROR_NUM_MODES;
@@ -267,6 +278,9 @@ static inline void REC_MAVLINK_MSG_ID_GPS_RAW_INT(const mavlink_message_t* msg)
 }
 
 #ifdef MAVLINK_PARAMS
+static uint8_t mav_req_params_nb_recv = 0;
+static uint8_t watch_mav_req_params_list = 0;
+
 const pm_char *getParamId(uint8_t idx) {
 	const pm_char *mav_params_id [((NB_PID_PARAMS / 2) + 4)]  = {
 		PSTR("RATE_YAW"), // Rate Yaw
@@ -351,236 +365,245 @@ void putsMavlinParams(uint8_t x, uint8_t y, uint8_t idx, uint8_t att) {
 	}
 }
 
-static inline void setParamValue(int8_t *id, float value) {
-	int8_t *p_id;
-	for (int8_t idx = 0; idx < NB_PARAMS; idx++) {
-		const pm_char * s = getParamId(idx);
-		p_id = id;
-		while (1) {
-			char c1 = pgm_read_byte(s++);
-			if (!c1) {
-				// Founded !
-				uint8_t founded = !*p_id;
-				if (idx < NB_PID_PARAMS) {
-					p_id++;
-					switch (*p_id++) {
-					case 'P':
-						founded = !*p_id;
-						break;
-					case 'I':
-						founded = !*p_id;
-						idx++;
-						break;
-					default:
-						founded = 0;
-						break;
-					}
-				}
-				// test end of string char == 0 and a valid PI
-				if (founded) {
-					MavlinkParam_t *param = getParam(idx);
-					param->repeat = 0;
-					param->valid = 1;
-					param->value = value;
-					mav_req_params_nb_recv++;
-				}
+//! \brief Parameter name as sent by the autopilot, with "_P" / "_I" for the PIDs
+static void getParamName(uint8_t idx, char * buf) {
+	const pm_char * s = getParamId(idx);
+	while ((*buf = pgm_read_byte(s++)))
+		buf++;
+	if (idx < NB_PID_PARAMS) {
+		*buf++ = '_';
+		*buf++ = "PI"[idx & 0x01];
+		*buf = 0;
+	}
+}
+
+//! \brief Hash of a parameter id, which is not terminated when 16 chars long
+static uint16_t getParamHash(const char * id) {
+	uint16_t hash = 0;
+	for (uint8_t i = 0; i < MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN && id[i]; i++) {
+		hash = (hash << 5) - hash + id[i];
+	}
+	return hash;
+}
+
+/*!	\brief Parameter lookup
+ *	\details The hashes of the known parameter names are computed once, a
+ *	received id is then found with one hash and one string compare instead of
+ *	comparing it with every name.
+ */
+static uint16_t mav_params_hash[NB_PARAMS];
+static bool mav_params_hash_valid = false;
+
+static inline void setParamValue(const char *id, float value) {
+	char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1];
+	if (!mav_params_hash_valid) {
+		for (uint8_t idx = 0; idx < NB_PARAMS; idx++) {
+			getParamName(idx, name);
+			mav_params_hash[idx] = getParamHash(name);
+		}
+		mav_params_hash_valid = true;
+	}
+	uint16_t hash = getParamHash(id);
+	for (uint8_t idx = 0; idx < NB_PARAMS; idx++) {
+		if (mav_params_hash[idx] == hash) {
+			getParamName(idx, name);
+			if (!strncmp(name, id, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN)) {
+				MavlinkParam_t *param = getParam(idx);
+				param->repeat = 0;
+				param->valid = 1;
+				param->value = value;
+				mav_req_params_nb_recv++;
 				return;
-			} else if (c1 != *p_id++) {
-				break;
 			}
 		}
-		if (idx < NB_PID_PARAMS) {
-			// Skip I Parameter from PID
-			idx++;
-		}
 	}
 }
 
 static inline void REC_MAVLINK_MSG_ID_PARAM_VALUE(const mavlink_message_t* msg) {
 	mavlink_param_value_t param_value;
 	mavlink_msg_param_value_decode(msg, &param_value);
-	char *id = param_value.param_id;
-	setParamValue((int8_t*)id, param_value.param_value);
+	setParamValue(param_value.param_id, param_value.param_value);
 	data_stream_start_stop = 0; // stop data stream while getting params list
 	watch_mav_req_params_list = mav_req_params_nb_recv < (NB_PARAMS - 5) ? 20 : 0; // stop timeout
 }
 #endif
 
-static inline void handleMessage(mavlink_message_t* p_rxmsg) {
-	switch (p_rxmsg->msgid) {
-	case MAVLINK_MSG_ID_HEARTBEAT:
-		REC_MAVLINK_MSG_ID_HEARTBEAT(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_STATUSTEXT:
-		REC_MAVLINK_MSG_ID_STATUSTEXT(p_rxmsg);
-		AUDIO_WARNING1();
-		break;
-	case MAVLINK_MSG_ID_SYS_STATUS:
-		REC_MAVLINK_MSG_ID_SYS_STATUS(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_RC_CHANNELS_RAW:
-		REC_MAVLINK_MSG_ID_RC_CHANNELS_RAW(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_RADIO:
-		REC_MAVLINK_MSG_ID_RADIO(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_RADIO_STATUS:
-		REC_MAVLINK_MSG_ID_RADIO_STATUS(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT:
-		REC_MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_VFR_HUD:
-		REC_MAVLINK_MSG_ID_VFR_HUD(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_HIL_CONTROLS:
-		REC_MAVLINK_MSG_ID_HIL_CONTROLS(p_rxmsg);
-		break;
-	case MAVLINK_MSG_ID_GPS_RAW_INT:
-		REC_MAVLINK_MSG_ID_GPS_RAW_INT(p_rxmsg);
-		break;
-#ifdef MAVLINK_PARAMS
-	case MAVLINK_MSG_ID_PARAM_VALUE:
-		REC_MAVLINK_MSG_ID_PARAM_VALUE(p_rxmsg);
-		break;
-#endif
-
-	}
-
-}
-
-
-/*!	\brief Mavlink message parser
- *	\details Parses the characters in to a mavlink message.
- *	Case statement parses each character as it is recieved.
- *	\attention One big change form the 0.9 to 1.0 version is the
- *	MAVLINK_CRC_EXTRA. This requires the mavlink_message_crcs array of 256 bytes.
- *	\todo create dot for the statemachine
+/*!	\brief Message dispatch table
+ *	\details Handlers read the fields in place from the received frame.
+ *	Messages which are not in the table are only counted.
  */
-static void MAVLINK_parse_char(uint8_t c) {
+typedef void (*MavlinkHandler)(const mavlink_message_t* msg);
 
-	static mavlink_message_t m_mavlink_message;
-	//! The currently decoded message
-	static mavlink_message_t* p_rxmsg = &m_mavlink_message;
-	//! The current decode status
-	mavlink_status_t* p_status = mavlink_get_channel_status(MAVLINK_COMM_0);
+typedef struct MavlinkHandlerEntry_ {
+	uint8_t msgid;
+	MavlinkHandler handler;
+} MavlinkHandlerEntry_t;
 
+static void REC_MAVLINK_MSG_ID_STATUSTEXT_WARNING(const mavlink_message_t* msg) {
+	REC_MAVLINK_MSG_ID_STATUSTEXT(msg);
+	AUDIO_WARNING1();
+}
 
-#if MAVLINK_CRC_EXTRA
-	static const uint8_t mavlink_message_crcs[256] PROGMEM = MAVLINK_MESSAGE_CRCS;
-#define MAVLINK_MESSAGE_CRC(msgid) mavlink_message_crcs[msgid]
+static const MavlinkHandlerEntry_t mavlinkHandlers[] PROGMEM = {
+	{ MAVLINK_MSG_ID_HEARTBEAT, REC_MAVLINK_MSG_ID_HEARTBEAT },
+	{ MAVLINK_MSG_ID_STATUSTEXT, REC_MAVLINK_MSG_ID_STATUSTEXT_WARNING },
+	{ MAVLINK_MSG_ID_SYS_STATUS, REC_MAVLINK_MSG_ID_SYS_STATUS },
+	{ MAVLINK_MSG_ID_RC_CHANNELS_RAW, REC_MAVLINK_MSG_ID_RC_CHANNELS_RAW },
+	{ MAVLINK_MSG_ID_RADIO, REC_MAVLINK_MSG_ID_RADIO },
+	{ MAVLINK_MSG_ID_RADIO_STATUS, REC_MAVLINK_MSG_ID_RADIO_STATUS },
+	{ MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, REC_MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT },
+	{ MAVLINK_MSG_ID_VFR_HUD, REC_MAVLINK_MSG_ID_VFR_HUD },
+	{ MAVLINK_MSG_ID_HIL_CONTROLS, REC_MAVLINK_MSG_ID_HIL_CONTROLS },
+	{ MAVLINK_MSG_ID_GPS_RAW_INT, REC_MAVLINK_MSG_ID_GPS_RAW_INT },
+#ifdef MAVLINK_PARAMS
+	{ MAVLINK_MSG_ID_PARAM_VALUE, REC_MAVLINK_MSG_ID_PARAM_VALUE },
 #endif
+};
 
-	// Initializes only once, values keep unchanged after first initialization
-	//mavlink_parse_state_initialize(p_status);
+#define MAVLINK_NUM_HANDLERS (sizeof(mavlinkHandlers) / sizeof(mavlinkHandlers[0]))
 
-	//p_status->msg_received = 0;
+MavlinkStats_t mavlinkStats;
+static uint16_t mavlinkMsgCounts[MAVLINK_NUM_HANDLERS];
 
-	switch (p_status->parse_state) {
-	case MAVLINK_PARSE_STATE_UNINIT:
-	case MAVLINK_PARSE_STATE_IDLE:
-		if (c == MAVLINK_STX) {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
-			mavlink_start_checksum(p_rxmsg);
-		}
-		break;
-
-	case MAVLINK_PARSE_STATE_GOT_STX:
-		// NOT counting STX, LENGTH, SEQ, SYSID, COMPID, MSGID, CRC1 and CRC2
-		p_rxmsg->len = c;
-		p_status->packet_idx = 0;
-		mavlink_update_checksum(p_rxmsg, c);
-		p_status->parse_state = MAVLINK_PARSE_STATE_GOT_LENGTH;
-		break;
-
-	case MAVLINK_PARSE_STATE_GOT_LENGTH:
-		p_rxmsg->seq = c;
-		mavlink_update_checksum(p_rxmsg, c);
-		p_status->parse_state = MAVLINK_PARSE_STATE_GOT_SEQ;
-		break;
-
-	case MAVLINK_PARSE_STATE_GOT_SEQ:
-		p_rxmsg->sysid = c;
-		mavlink_update_checksum(p_rxmsg, c);
-		p_status->parse_state = MAVLINK_PARSE_STATE_GOT_SYSID;
-		break;
-
-	case MAVLINK_PARSE_STATE_GOT_SYSID:
-		p_rxmsg->compid = c;
-		mavlink_update_checksum(p_rxmsg, c);
-		p_status->parse_state = MAVLINK_PARSE_STATE_GOT_COMPID;
-		break;
+//! \brief Number of messages received of the given type, only for the handled types
+uint16_t MAVLINK_getMsgCount(uint8_t msgid) {
+	for (uint8_t i = 0; i < MAVLINK_NUM_HANDLERS; i++) {
+		if (pgm_read_byte(&mavlinkHandlers[i].msgid) == msgid)
+			return mavlinkMsgCounts[i];
+	}
+	return 0;
+}
 
-	case MAVLINK_PARSE_STATE_GOT_COMPID:
-		p_rxmsg->msgid = c;
-		mavlink_update_checksum(p_rxmsg, c);
-		if (p_rxmsg->len == 0) {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_PAYLOAD;
-		} else {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_MSGID;
+static inline void handleMessage(const mavlink_message_t* p_rxmsg) {
+	for (uint8_t i = 0; i < MAVLINK_NUM_HANDLERS; i++) {
+		if (pgm_read_byte(&mavlinkHandlers[i].msgid) == p_rxmsg->msgid) {
+			mavlinkMsgCounts[i]++;
+			MavlinkHandler handler = (MavlinkHandler)pgm_read_adr(&mavlinkHandlers[i].handler);
+			handler(p_rxmsg);
+			return;
 		}
-		break;
+	}
+	mavlinkStats.unhandled++;
+}
 
-	case MAVLINK_PARSE_STATE_GOT_MSGID:
-		_MAV_PAYLOAD_NON_CONST(p_rxmsg)[p_status->packet_idx++] = (char) c;
-		mavlink_update_checksum(p_rxmsg, c);
-		if (p_status->packet_idx == p_rxmsg->len) {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_PAYLOAD;
-		}
-		break;
+/*!	\brief X.25 (CRC-16/MCRF4XX) checksum table
+ *	\details Same result as crc_accumulate() from checksum.h, one table lookup
+ *	per byte instead of the shift sequence.
+ */
+static const uint16_t mavlinkCrcTable[256] PROGMEM = {
+	0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
+	0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
+	0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
+	0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
+	0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
+	0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
+	0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
+	0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
+	0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
+	0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
+	0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
+	0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
+	0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
+	0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
+	0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
+	0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
+	0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
+	0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
+	0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
+	0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
+	0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
+	0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
+	0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
+	0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
+	0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
+	0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
+	0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
+	0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
+	0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
+	0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
+	0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
+	0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78,
+};
+
+static uint16_t mavlinkCrc(const uint8_t * data, uint16_t len, uint16_t crc) {
+	while (len--) {
+		crc = (crc >> 8) ^ pgm_read_word(&mavlinkCrcTable[(crc ^ *data++) & 0xFF]);
+	}
+	return crc;
+}
 
-	case MAVLINK_PARSE_STATE_GOT_PAYLOAD:
+#if MAVLINK_CRC_EXTRA
+static const uint8_t mavlink_message_crcs[256] PROGMEM = MAVLINK_MESSAGE_CRCS;
+#endif
 
+//! \brief Checks the CRC of a complete frame, over the whole span at once
+static bool MAVLINK_checkFrame(mavlink_message_t* p_rxmsg) {
+	uint16_t crc = mavlinkCrc(&MAVLINK_RX_FRAME[1], MAVLINK_CORE_HEADER_LEN + p_rxmsg->len, X25_INIT_CRC);
 #if MAVLINK_CRC_EXTRA
-		mavlink_update_checksum(p_rxmsg, pgm_read_byte(&(mavlink_message_crcs[p_rxmsg->msgid])));
+	uint8_t extra = pgm_read_byte(&mavlink_message_crcs[p_rxmsg->msgid]);
+	crc = mavlinkCrc(&extra, 1, crc);
 #endif
-		if (c != (p_rxmsg->checksum & 0xFF)) {
-			// Check first checksum byte
-			p_status->parse_error = 3;
-		} else {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_CRC1;
-		}
-		break;
+	p_rxmsg->checksum = crc;
+	return mavlink_ck_a(p_rxmsg) == (crc & 0xFF) && mavlink_ck_b(p_rxmsg) == (crc >> 8);
+}
 
-	case MAVLINK_PARSE_STATE_GOT_CRC1:
-		if (c != (p_rxmsg->checksum >> 8)) {
-			// Check second checksum byte
-			p_status->parse_error = 4;
-		} else {
-			// Successfully got message
-			if (mav_heartbeat < 0)
-				mav_heartbeat = 0;
-			p_status->current_rx_seq = p_rxmsg->seq;
-			//p_status->msg_received = 1;
-			p_status->parse_state = MAVLINK_PARSE_STATE_IDLE;
-			//memcpy(r_message, p_rxmsg, sizeof(mavlink_message_t));
-			handleMessage(p_rxmsg);
-		}
-		break;
+//! \brief Called once the last byte of a frame is received
+static void MAVLINK_frameReceived(void) {
+	mavlink_message_t* p_rxmsg = &m_mavlink_message;
+	mavlink_status_t* p_status = mavlink_get_channel_status(MAVLINK_COMM_0);
+
+	mavlinkRxIndex = 0;
+	if (!MAVLINK_checkFrame(p_rxmsg)) {
+		mavlinkStats.crcErrors++;
+		return;
 	}
-	// Error occur
-	if (p_status->parse_error) {
-		p_status->parse_state = MAVLINK_PARSE_STATE_IDLE;
-		if (c == MAVLINK_STX) {
-			p_status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
-			mavlink_start_checksum(p_rxmsg);
+	if (mavlinkStats.frames)
+		mavlinkStats.lost += (uint8_t)(p_rxmsg->seq - p_status->current_rx_seq - 1);
+	mavlinkStats.frames++;
+	// Successfully got message
+	if (mav_heartbeat < 0)
+		mav_heartbeat = 0;
+	p_status->current_rx_seq = p_rxmsg->seq;
+	handleMessage(p_rxmsg);
+}
+
+/*!	\brief Mavlink frame parser, byte by byte from the serial interrupt
+ *	\details Bytes are only stored until the frame is complete, the CRC is
+ *	then checked in one pass and the message dispatched. On a CRC error the
+ *	frame is dropped and the parser waits for the next STX.
+ */
+static void MAVLINK_parse_char(uint8_t c) {
+	if (mavlinkRxIndex == 0 && c != MAVLINK_STX)
+		return;
+	MAVLINK_RX_FRAME[mavlinkRxIndex++] = c;
+	if (mavlinkRxIndex > 2 && mavlinkRxIndex == m_mavlink_message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES)
+		MAVLINK_frameReceived();
+}
+
+//! \brief Same as MAVLINK_parse_char() for blocks of any size
+void MAVLINK_parse(const uint8_t * data, uint16_t len) {
+	while (len > 0) {
+		if (mavlinkRxIndex == 0) {
+			const uint8_t * stx = (const uint8_t *)memchr(data, MAVLINK_STX, len);
+			if (!stx)
+				return;
+			len -= stx - data;
+			data = stx;
 		}
-		p_status->parse_error = 0;
 
+		// up to the length byte first, then up to the end of the frame
+		uint16_t frameLen = (mavlinkRxIndex < 2 ? 2 : m_mavlink_message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+		uint16_t count = frameLen - mavlinkRxIndex;
+		if (count > len)
+			count = len;
+		memcpy(&MAVLINK_RX_FRAME[mavlinkRxIndex], data, count);
+		mavlinkRxIndex += count;
+		data += count;
+		len -= count;
+
+		if (mavlinkRxIndex == frameLen && mavlinkRxIndex > 2)
+			MAVLINK_frameReceived();
 	}
-	// If a message has been sucessfully decoded, check index
-	/*
-	 if (p_status->msg_received == 1) {
-	 p_status->current_rx_seq = p_rxmsg->seq;
-	 p_status->packet_rx_success_count++;
-	 }
-	 */
-
-	//r_mavlink_status->current_rx_seq = p_status->current_rx_seq + 1;
-	//r_mavlink_status->packet_rx_success_count = p_status->packet_rx_success_count;
-	//r_mavlink_status->packet_rx_drop_count = p_status->parse_error;
-	//p_status->parse_error = 0;
-	//return p_status->msg_received;
 }
 
 #ifdef MAVLINK_PARAMS
@@ -590,22 +613,8 @@ static inline void MAVLINK_msg_param_request_list_send() {
 }
 
 static inline void MAVLINK_msg_param_set(uint8_t idx) {
-	const pm_char* s = getParamId(idx);
-	int8_t buf[15];
-	int8_t *p = buf;
-	while (1) {
-		char c = pgm_read_byte(s++);
-		if (!c) {
-			if (idx < NB_PID_PARAMS) {
-				*p++ = '_';
-				uint8_t colIdx = idx & 0x01;
-				*p++ = "PI"[colIdx];
-			}
-			*p++ = 0;
-			break;
-		}
-		*p++ = c;
-	}
+	char buf[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1];
+	getParamName(idx, buf);
 	//float param_value = ((float) telemetry_data.params[idx].pi_param[subIdx].pi_value / 100.00 + 0.005);
 	float param_value = getParam(idx)->value;
 
@@ -217,6 +217,15 @@ typedef struct Telemetry_Data_ {
 // Telemetry data hold
 extern Telemetry_Data_t telemetry_data;
 
+typedef struct MavlinkStats_ {
+	uint16_t frames;
+	uint16_t crcErrors;
+	uint16_t lost; ///< Frames missing in the sequence numbers
+	uint16_t unhandled; ///< Valid frames without a handler
+} MavlinkStats_t;
+
+extern MavlinkStats_t mavlinkStats;
+
 /*
  * Funtion definitions
  */
@@ -241,6 +250,8 @@ extern inline uint8_t MAVLINK_Action2CtrlMode(uint8_t action) {
 #endif
 void telemetryWakeup();
 void MAVLINK_Init(void);
+void MAVLINK_parse(const uint8_t * data, uint16_t len);
+uint16_t MAVLINK_getMsgCount(uint8_t msgid);
 void menuTelemetryMavlink(uint8_t event);
 void MAVLINK10mspoll(uint16_t time);
 
@@ -0,0 +1,212 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+#include "../opentx.h"
+#include "telemetry/capture.h"
+
+#if defined(SIMU) && defined(FRSKY)
+
+// Replays the binary captures written by SPORT_FILE_LOG (see capture.h), or
+// text logs with one record per line: "YYYY-MM-DD,HH:MM:SS.mmm: 7E 98 10 ..."
+
+#define TELEMETRY_REPLAY_LINE_LEN     1024
+#define TELEMETRY_REPLAY_MAX_BYTES    256  // per wakeup, below the telemetry fifo size
+
+struct TelemetryReplay {
+  FILE *   file;
+  bool     ownFile;
+  uint8_t  speed;
+  bool     pending;
+  bool     capture;     // binary capture
+  uint32_t captureTime; // us, time of the last record in the current session
+  int32_t  captureBase; // ms, time at which the current session started
+  int32_t  firstTime;   // ms, time of the first record
+  tmr10ms_t start;
+  int32_t  recordTime;  // ms, relative to the first record
+  uint16_t recordLen;
+  uint8_t  record[TELEMETRY_REPLAY_LINE_LEN/3];
+};
+
+static TelemetryReplay telemetryReplay;
+TelemetryReplayStats telemetryReplayStats;
+
+static bool telemetryReplayReadRecord()
+{
+  char line[TELEMETRY_REPLAY_LINE_LEN];
+
+  while (fgets(line, sizeof(line), telemetryReplay.file)) {
+    int year, month, day, hour, min, sec, ms, pos;
+    if (sscanf(line, "%d-%d-%d,%d:%d:%d.%d: %n", &year, &month, &day, &hour, &min, &sec, &ms, &pos) != 7) {
+      continue;
+    }
+    int32_t time = ((hour*60 + min)*60 + sec)*1000 + ms;
+    if (telemetryReplay.firstTime < 0) {
+      telemetryReplay.firstTime = time;
+    }
+    else if (time < telemetryReplay.firstTime) {
+      time += 24*3600*1000; // midnight
+    }
+    telemetryReplay.recordTime = time - telemetryReplay.firstTime;
+    telemetryReplay.recordLen = 0;
+    char * s = line + pos;
+    unsigned int byte;
+    int len;
+    while (telemetryReplay.recordLen < sizeof(telemetryReplay.record) && sscanf(s, "%2x%n", &byte, &len) == 1) {
+      telemetryReplay.record[telemetryReplay.recordLen++] = byte;
+      s += len;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+static bool telemetryReplayReadCapture()
+{
+  uint8_t header[TELEMETRY_CAPTURE_RECORD_SIZE];
+
+  while (fread(header, 1, sizeof(header), telemetryReplay.file) == sizeof(header)) {
+    uint32_t time = header[0] + (header[1] << 8) + (header[2] << 16) + ((uint32_t)header[3] << 24);
+    uint8_t length = header[4];
+    if (fread(&telemetryReplay.record[1], 1, length, telemetryReplay.file) != length) {
+      return false;
+    }
+    if (time == TELEMETRY_CAPTURE_SESSION && length == TELEMETRY_CAPTURE_HEADER_SIZE && !memcmp(&telemetryReplay.record[1], TELEMETRY_CAPTURE_MAGIC, 4)) {
+      // a new session, with times starting from 0 again
+      telemetryReplay.captureBase = telemetryReplay.recordTime;
+      telemetryReplay.captureTime = 0;
+      continue;
+    }
+    if (time < telemetryReplay.captureTime) {
+      telemetryReplay.captureBase += 4294967; // us clock wrap
+    }
+    telemetryReplay.captureTime = time;
+    telemetryReplay.recordTime = telemetryReplay.captureBase + time / 1000;
+    telemetryReplay.record[0] = START_STOP;
+    telemetryReplay.recordLen = length + 1;
+    return true;
+  }
+
+  return false;
+}
+
+static void telemetryReplayPush(const uint8_t * data, int len)
+{
+#if defined(PCBTARANIS)
+  extern Fifo<512> telemetryFifo;
+  telemetryFifo.push(data, len);
+#else
+  for (int i=0; i<len; i++) {
+    processSerialData(data[i]);
+  }
+#endif
+}
+
+bool telemetryReplayStart(FILE * file, uint8_t speed)
+{
+  telemetryReplayStop();
+  if (!file) {
+    return false;
+  }
+  telemetryReplay.file = file;
+  telemetryReplay.speed = speed;
+
+  uint8_t header[TELEMETRY_CAPTURE_RECORD_SIZE + 4];
+  long position = ftell(file);
+  telemetryReplay.capture = (fread(header, 1, sizeof(header), file) == sizeof(header) && !memcmp(&header[TELEMETRY_CAPTURE_RECORD_SIZE], TELEMETRY_CAPTURE_MAGIC, 4));
+  fseek(file, position, SEEK_SET);
+
+  telemetryReplay.firstTime = -1;
+  telemetryReplay.start = get_tmr10ms();
+  memclear(&telemetryReplayStats, sizeof(telemetryReplayStats));
+  return true;
+}
+
+bool telemetryReplayOpen(const char * filename, uint8_t speed)
+{
+  if (telemetryReplayStart(fopen(filename, "rb"), speed)) {
+    telemetryReplay.ownFile = true;
+    return true;
+  }
+  TRACE("Telemetry replay: cannot open %s", filename);
+  return false;
+}
+
+void telemetryReplayStop()
+{
+  if (telemetryReplay.file && telemetryReplay.ownFile) {
+    fclose(telemetryReplay.file);
+  }
+  memclear(&telemetryReplay, sizeof(telemetryReplay));
+}
+
+bool isTelemetryReplayRunning()
+{
+  return telemetryReplay.file != NULL;
+}
+
+int telemetryReplayWakeup()
+{
+  if (!telemetryReplay.file) {
+    return -1;
+  }
+
+  int32_t elapsed = 10 * (int32_t)(get_tmr10ms() - telemetryReplay.start) * telemetryReplay.speed;
+  int count = 0;
+
+  while (count < TELEMETRY_REPLAY_MAX_BYTES) {
+    if (!telemetryReplay.pending) {
+      if (!(telemetryReplay.capture ? telemetryReplayReadCapture() : telemetryReplayReadRecord())) {
+        telemetryReplayStop();
+        return count > 0 ? count : -1;
+      }
+      telemetryReplay.pending = true;
+    }
+    if (telemetryReplay.speed && telemetryReplay.recordTime > elapsed) {
+      break;
+    }
+    telemetryReplayPush(telemetryReplay.record, telemetryReplay.recordLen);
+    count += telemetryReplay.recordLen;
+    telemetryReplayStats.records++;
+    telemetryReplayStats.bytes += telemetryReplay.recordLen;
+    telemetryReplay.pending = false;
+  }
+
+  return count;
+}
+
+#endif
@@ -1,6 +1,26 @@
 #include "../opentx.h"
 
 TelemetryItem telemetryItems[TELEM_VALUES_MAX];
+uint32_t telemetryItemsUpdated = 0;
+
+// calculated sensors in evaluation order, with the items each one reads
+static uint8_t  calculatedSensorsOrder[TELEM_VALUES_MAX];
+static uint32_t calculatedSensorsSources[TELEM_VALUES_MAX];
+static int8_t   calculatedSensorsCount = -1; // -1 when the order has to be rebuilt
+
+void TelemetryItem::setUpdated()
+{
+  // the read-modify-write must not interleave with evalCalculatedSensors() in another task
+  __disable_irq();
+  telemetryItemsUpdated |= (uint32_t)1 << (this - telemetryItems);
+  __enable_irq();
+}
+
+void TelemetryItem::setOld()
+{
+  lastReceived = TELEMETRY_VALUE_OLD;
+  setUpdated();
+}
 
 void TelemetryItem::gpsReceived()
 {
@@ -14,32 +34,83 @@ void TelemetryItem::gpsReceived()
   lastReceived = now();
 }
 
+// Cells are kept with their sum and the index of the lowest / highest one up
+// to date as they arrive, so that the cell sensors only read the results.
+// A full rescan is only needed when the lowest cell rises or the highest falls.
+void TelemetryItem::setCell(uint8_t index, uint16_t value)
+{
+  CellValue & cell = cells.values[index];
+  uint8_t mask = 1 << index;
+
+  if (value <= 50)
+    return;
+
+  if (cells.valid & mask) {
+    uint16_t previous = cell.value;
+    cell.set(value);
+    cells.sum += value - previous;
+    if ((index == cells.lowest && value > previous) || (index == cells.highest && value < previous)) {
+      for (uint8_t i=0; i<cells.count; i++) {
+        if (cells.valid & (1 << i)) {
+          if (cells.values[i].value < cells.values[cells.lowest].value)
+            cells.lowest = i;
+          if (cells.values[i].value > cells.values[cells.highest].value)
+            cells.highest = i;
+        }
+      }
+      return;
+    }
+  }
+  else {
+    cell.set(value);
+    cells.sum += value;
+    if (!cells.valid) {
+      cells.lowest = cells.highest = index;
+    }
+    cells.valid |= mask;
+  }
+
+  if (value < cells.values[cells.lowest].value)
+    cells.lowest = index;
+  if (value > cells.values[cells.highest].value)
+    cells.highest = index;
+}
+
+// Drop of the lowest cell below the best of the last complete packs
+uint16_t TelemetryItem::getCellsSag() const
+{
+  uint16_t best = 0;
+  for (uint8_t i=0; i<TELEMETRY_CELLS_HISTORY; i++) {
+    if (cells.history[i] > best)
+      best = cells.history[i];
+  }
+  uint16_t lowest = cells.values[cells.lowest].value;
+  return best > lowest ? best - lowest : 0;
+}
+
 void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t newVal, uint32_t unit, uint32_t prec)
 {
+  setUpdated();
+
   if (unit == UNIT_CELLS) {
     uint32_t data = uint32_t(newVal);
     uint8_t cellIndex = data & 0xF;
-    uint8_t count = (data & 0xF0) >> 4;
+    uint8_t count = min<uint8_t>((data & 0xF0) >> 4, TELEMETRY_CELLS_MAX);
     if (count != cells.count) {
       clear();
       cells.count = count;
     }
-    cells.values[cellIndex].set(((data & 0x000FFF00) >>  8) / 5);
-    if (cellIndex+1 < cells.count) {
-      cells.values[cellIndex+1].set(((data & 0xFFF00000) >> 20) / 5);
+    if (cellIndex >= count) {
+      return;
     }
-    if (cellIndex+2 >= cells.count) {
-      newVal = 0;
-      for (int i=0; i<count; i++) {
-        if (cells.values[i].state) {
-          newVal += cells.values[i].value;
-        }
-        else {
-          // we didn't receive all cells values
-          return;
-        }
-      }
-      newVal = sensor.getValue(newVal, UNIT_VOLTS, 2);
+    setCell(cellIndex, ((data & 0x000FFF00) >>  8) / 5);
+    if (cellIndex+1 < count) {
+      setCell(cellIndex+1, ((data & 0xFFF00000) >> 20) / 5);
+    }
+    if (cellIndex+2 >= count && cells.isComplete()) {
+      cells.history[cells.historyIndex] = cells.values[cells.lowest].value;
+      cells.historyIndex = (cells.historyIndex + 1) % TELEMETRY_CELLS_HISTORY;
+      newVal = sensor.getValue(cells.sum, UNIT_VOLTS, 2);
     }
     else {
       // we didn't receive all cells values
@@ -185,6 +256,8 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t newVal, uin
     }
   }
 
+  addTelemetryHistoryValue(this - telemetryItems, newVal);
+
   value = newVal;
   lastReceived = now();
 }
@@ -215,7 +288,7 @@ void TelemetryItem::per10ms(const TelemetrySensor & sensor)
           return;
         }
         else if (currentItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
           return;
         }
         int32_t current = convertTelemetryValue(currentItem.value, currentSensor.unit, currentSensor.prec, UNIT_AMPS, 1);
@@ -239,33 +312,26 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.cell.source) {
         TelemetryItem & cellsItem = telemetryItems[sensor.cell.source-1];
         if (cellsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
         }
         else {
           unsigned int index = sensor.cell.index;
-          if (index == TELEM_CELL_INDEX_LOWEST || index == TELEM_CELL_INDEX_HIGHEST || index == TELEM_CELL_INDEX_DELTA) {
-            unsigned int lowest=0, highest=0;
-            for (int i=0; i<cellsItem.cells.count; i++) {
-              if (cellsItem.cells.values[i].state) {
-                if (!lowest || cellsItem.cells.values[i].value < cellsItem.cells.values[lowest-1].value)
-                  lowest = i+1;
-                if (!highest || cellsItem.cells.values[i].value > cellsItem.cells.values[highest-1].value)
-                  highest = i+1;
-              }
-              else {
-                lowest = highest = 0;
-              }
-            }
-            if (lowest) {
+          if (index == TELEM_CELL_INDEX_LOWEST || index == TELEM_CELL_INDEX_HIGHEST || index == TELEM_CELL_INDEX_DELTA || index == TELEM_CELL_INDEX_SAG) {
+            if (cellsItem.cells.isComplete()) {
+              uint16_t lowest = cellsItem.cells.values[cellsItem.cells.lowest].value;
+              uint16_t highest = cellsItem.cells.values[cellsItem.cells.highest].value;
               switch (index) {
                 case TELEM_CELL_INDEX_LOWEST:
-                  setValue(sensor, cellsItem.cells.values[lowest-1].value, UNIT_VOLTS, 2);
+                  setValue(sensor, lowest, UNIT_VOLTS, 2);
                   break;
                 case TELEM_CELL_INDEX_HIGHEST:
-                  setValue(sensor, cellsItem.cells.values[highest-1].value, UNIT_VOLTS, 2);
+                  setValue(sensor, highest, UNIT_VOLTS, 2);
                   break;
                 case TELEM_CELL_INDEX_DELTA:
-                  setValue(sensor, cellsItem.cells.values[highest-1].value - cellsItem.cells.values[lowest-1].value, UNIT_VOLTS, 2);
+                  setValue(sensor, highest - lowest, UNIT_VOLTS, 2);
+                  break;
+                case TELEM_CELL_INDEX_SAG:
+                  setValue(sensor, cellsItem.getCellsSag(), UNIT_VOLTS, 2);
                   break;
               }
             }
@@ -282,13 +348,13 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
 
     case TELEM_FORMULA_DIST:
       if (sensor.dist.gps) {
-        TelemetryItem gpsItem = telemetryItems[sensor.dist.gps-1];
+        TelemetryItem & gpsItem = telemetryItems[sensor.dist.gps-1];
         TelemetryItem * altItem = NULL;
         if (!gpsItem.isAvailable()) {
           return;
         }
         else if (gpsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
           return;
         }
         if (sensor.dist.alt) {
@@ -297,7 +363,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
             return;
           }
           else if (altItem->isOld()) {
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
             return;
           }
         }
@@ -324,6 +390,25 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       }
       break;
 
+    case TELEM_FORMULA_HISTORY:
+      if (sensor.history.source) {
+        uint8_t index = sensor.history.source-1;
+        TelemetryItem & sourceItem = telemetryItems[index];
+        if (!sourceItem.isAvailable()) {
+          return;
+        }
+        else if (sourceItem.isOld()) {
+          setOld();
+          return;
+        }
+        int32_t value;
+        if (getTelemetryHistoryValue(index, sensor.history.stat, sensor.history.scale, sensor.history.percent, value)) {
+          TelemetrySensor & sourceSensor = g_model.telemetrySensors[index];
+          setValue(sensor, convertTelemetryValue(value, sourceSensor.unit, sourceSensor.prec, sensor.unit, sensor.prec), sensor.unit, sensor.prec);
+        }
+      }
+      break;
+
     case TELEM_FORMULA_ADD:
     case TELEM_FORMULA_AVERAGE:
     case TELEM_FORMULA_MIN:
@@ -354,7 +439,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
               return;
             }
             else if (telemetryItem.isOld()) {
-              lastReceived = TELEMETRY_VALUE_OLD;
+              setOld();
               return;
             }
           }
@@ -380,7 +465,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.formula == TELEM_FORMULA_AVERAGE) {
         if (count == 0) {
           if (available)
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
           return;
         }
         else {
@@ -401,6 +486,119 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
   }
 }
 
+uint32_t getCalculatedSensorSources(const TelemetrySensor & sensor)
+{
+  uint32_t result = 0;
+
+  switch (sensor.formula) {
+    case TELEM_FORMULA_CELL:
+      if (sensor.cell.source)
+        result |= (uint32_t)1 << (sensor.cell.source-1);
+      break;
+
+    case TELEM_FORMULA_DIST:
+      if (sensor.dist.gps)
+        result |= (uint32_t)1 << (sensor.dist.gps-1);
+      if (sensor.dist.alt)
+        result |= (uint32_t)1 << (sensor.dist.alt-1);
+      break;
+
+    case TELEM_FORMULA_HISTORY:
+      if (sensor.history.source)
+        result |= (uint32_t)1 << (sensor.history.source-1);
+      break;
+
+    case TELEM_FORMULA_ADD:
+    case TELEM_FORMULA_AVERAGE:
+    case TELEM_FORMULA_MIN:
+    case TELEM_FORMULA_MAX:
+    case TELEM_FORMULA_MULTIPLY:
+      for (int i=0; i<(sensor.formula==TELEM_FORMULA_MULTIPLY ? 2 : 4); i++) {
+        int8_t source = sensor.calc.sources[i];
+        if (source)
+          result |= (uint32_t)1 << (abs(source)-1);
+      }
+      break;
+
+    default:
+      // consumption is integrated in per10ms()
+      break;
+  }
+
+  return result;
+}
+
+void invalidateCalculatedSensors()
+{
+  calculatedSensorsCount = -1;
+}
+
+// Sorts the calculated sensors so that each one comes after the calculated
+// sensors it reads. Circular references are left in index order.
+void sortCalculatedSensors()
+{
+  uint32_t calculated = 0;
+  uint32_t sorted = 0;
+  uint32_t histories = 0;
+  uint8_t count = 0;
+
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    if (sensor.type == TELEM_TYPE_CALCULATED) {
+      calculated |= (uint32_t)1 << i;
+      if (sensor.formula == TELEM_FORMULA_HISTORY) {
+        histories |= getCalculatedSensorSources(sensor);
+      }
+    }
+  }
+
+  pinTelemetryHistories(histories);
+
+  while (calculated & ~sorted) {
+    bool circular = true;
+    for (int pass=0; pass<2 && circular; pass++) {
+      for (int i=0; i<TELEM_VALUES_MAX; i++) {
+        uint32_t mask = (uint32_t)1 << i;
+        if ((calculated & ~sorted) & mask) {
+          uint32_t sources = getCalculatedSensorSources(g_model.telemetrySensors[i]);
+          if (pass == 1 || !(sources & calculated & ~sorted & ~mask)) {
+            calculatedSensorsOrder[count] = i;
+            calculatedSensorsSources[count] = sources;
+            count++;
+            sorted |= mask;
+            circular = false;
+          }
+        }
+      }
+    }
+  }
+
+  calculatedSensorsCount = count;
+}
+
+void evalCalculatedSensors()
+{
+  if (calculatedSensorsCount < 0) {
+    sortCalculatedSensors();
+    telemetryItemsUpdated = (uint32_t)-1;
+  }
+
+  uint32_t updated = telemetryItemsUpdated;
+
+  for (int i=0; i<calculatedSensorsCount; i++) {
+    if (calculatedSensorsSources[i] & updated) {
+      uint8_t index = calculatedSensorsOrder[i];
+      telemetryItems[index].eval(g_model.telemetrySensors[index]);
+      // the sensors reading this one come later in the order
+      updated |= telemetryItemsUpdated;
+    }
+  }
+
+  __disable_irq();
+  telemetryItemsUpdated &= ~updated;
+  __enable_irq();
+}
+
 int getTelemetryIndex(TelemetryProtocol protocol, uint16_t id, uint8_t instance)
 {
   int available = -1;
@@ -416,6 +614,7 @@ int getTelemetryIndex(TelemetryProtocol protocol, uint16_t id, uint8_t instance)
   }
 
   if (available >= 0) {
+    invalidateCalculatedSensors();
     switch (protocol) {
 #if defined(FRSKY_SPORT)
       case TELEM_PROTO_FRSKY_SPORT:
@@ -439,6 +638,8 @@ void delTelemetryIndex(uint8_t index)
 {
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
   telemetryItems[index].clear();
+  releaseTelemetryHistory(index);
+  invalidateCalculatedSensors();
   eeDirty(EE_MODEL);
 }
 
@@ -49,6 +49,8 @@ enum TelemetryProtocol
 #define TELEMETRY_VALUE_OLD           254
 
 #define TELEMETRY_AVERAGE_COUNT       3
+#define TELEMETRY_CELLS_MAX           6
+#define TELEMETRY_CELLS_HISTORY       4  /*complete packs kept for sag detection*/
 
 enum {
   TELEM_CELL_INDEX_LOWEST,
@@ -60,6 +62,7 @@ enum {
   TELEM_CELL_INDEX_6,
   TELEM_CELL_INDEX_HIGHEST,
   TELEM_CELL_INDEX_DELTA,
+  TELEM_CELL_INDEX_SAG,
 };
 
 PACK(struct CellValue
@@ -104,7 +107,17 @@ class TelemetryItem
       } consumption;
       struct {
         uint8_t   count;
-        CellValue values[6];
+        uint8_t   valid;        // one bit per cell received
+        uint8_t   lowest;       // index of the lowest / highest valid cell
+        uint8_t   highest;
+        uint16_t  sum;          // sum of the valid cells
+        uint8_t   historyIndex;
+        CellValue values[TELEMETRY_CELLS_MAX];
+        uint16_t  history[TELEMETRY_CELLS_HISTORY]; // lowest cell of the last complete packs
+        bool isComplete() const
+        {
+          return count && valid == (1 << count) - 1;
+        }
       } cells;
       struct {
         uint8_t  datestate;
@@ -156,6 +169,10 @@ class TelemetryItem
     void per10ms(const TelemetrySensor & sensor);
 
     void setValue(const TelemetrySensor & sensor, int32_t newVal, uint32_t unit, uint32_t prec=0);
+    void setCell(uint8_t index, uint16_t value);
+    uint16_t getCellsSag() const;
+    void setOld();
+    void setUpdated();
     bool isAvailable();
     bool isFresh();
     bool isOld();
@@ -163,6 +180,7 @@ class TelemetryItem
 };
 
 extern TelemetryItem telemetryItems[TELEM_VALUES_MAX];
+extern uint32_t telemetryItemsUpdated; // one bit per item set since the calculated sensors were last evaluated
 
 inline bool isTelemetryFieldAvailable(int index)
 {
@@ -182,12 +200,125 @@ inline bool isTelemetryFieldComparisonAvailable(int index)
   return (sensor.id != 0);
 }
 
+void evalCalculatedSensors();
+void invalidateCalculatedSensors();
 void setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t instance, int32_t value, uint32_t unit, uint32_t prec);
 void delTelemetryIndex(uint8_t index);
 int availableTelemetryIndex();
 int32_t getTelemetryValue(uint8_t index, uint8_t & prec);
 int32_t convertTelemetryValue(int32_t value, uint8_t unit, uint8_t prec, uint8_t destUnit, uint8_t destPrec);
 
+// Sensors history, a few sensors at a time, each one with decimated rings:
+// scale 0 keeps one sample every 0.2s, scale 1 every 2s, scale 2 every 20s
+#define TELEMETRY_HISTORY_MAX          8
+#define TELEMETRY_HISTORY_SAMPLES      16
+#define TELEMETRY_HISTORY_SCALES       3
+#define TELEMETRY_HISTORY_PERIOD       20  /*10ms ticks per sample on scale 0*/
+#define TELEMETRY_HISTORY_DECIMATION   10  /*samples of one scale averaged into one of the next*/
+
+enum TelemetryHistoryStat {
+  TELEM_HISTORY_AVERAGE,
+  TELEM_HISTORY_SLOPE,       // per second
+  TELEM_HISTORY_PERCENTILE,
+  TELEM_HISTORY_STAT_MAX=TELEM_HISTORY_PERCENTILE
+};
+
+struct TelemetryHistoryRing {
+  int32_t samples[TELEMETRY_HISTORY_SAMPLES];
+  int32_t sum;
+  uint8_t next;
+  uint8_t count;
+
+  void push(int32_t value);
+  int32_t get(uint8_t age) const; // 0 = newest
+  int32_t average() const;
+  int32_t slope(uint32_t period) const;
+  int32_t percentile(uint8_t percent) const;
+};
+
+struct TelemetryHistory {
+  uint8_t   item;     // sensor index + 1, 0 when the slot is free
+  uint8_t   pinned;   // read by a history sensor, never reused for another sensor
+  tmr10ms_t lastRead;
+  tmr10ms_t periodStart;
+  int32_t   accumulator[TELEMETRY_HISTORY_SCALES];
+  uint16_t  accumulated[TELEMETRY_HISTORY_SCALES];
+  TelemetryHistoryRing scales[TELEMETRY_HISTORY_SCALES];
+
+  void add(int32_t value);
+};
+
+extern TelemetryHistory telemetryHistories[TELEMETRY_HISTORY_MAX];
+extern uint8_t telemetryHistorySlots[TELEM_VALUES_MAX]; // slot + 1 for each sensor, 0 without history
+
+inline void addTelemetryHistoryValue(uint8_t index, int32_t value)
+{
+  uint8_t slot = telemetryHistorySlots[index];
+  if (slot) {
+    telemetryHistories[slot-1].add(value);
+  }
+}
+
+TelemetryHistory * getTelemetryHistory(uint8_t index);
+void releaseTelemetryHistory(uint8_t index);
+void pinTelemetryHistories(uint32_t items);
+void resetTelemetryHistories();
+bool getTelemetryHistoryValue(uint8_t index, uint8_t stat, uint8_t scale, uint8_t percent, int32_t & value);
+
+#if defined(SIMU)
+// Telemetry replay of SPORT_FILE_LOG files in the simulator.
+// speed: 1 = real time, n = n times faster, 0 = as fast as the parsers go
+struct TelemetryReplayStats {
+  uint32_t records;
+  uint32_t bytes;
+};
+extern TelemetryReplayStats telemetryReplayStats;
+bool telemetryReplayOpen(const char * filename, uint8_t speed=1);
+bool telemetryReplayStart(FILE * file, uint8_t speed=1);
+void telemetryReplayStop();
+bool isTelemetryReplayRunning();
+int telemetryReplayWakeup();
+#endif
+
+#if defined(PCBTARANIS) && (defined(SPORT_FILE_LOG) || defined(SIMU))
+#define TELEMETRY_CAPTURE
+#include "capture.h"
+
+#define TELEMETRY_CAPTURE_STAMPS        32    /*frame start times kept between two telemetryWakeup()*/
+#define TELEMETRY_CAPTURE_BUFFER        2048  /*records waiting to be written to the SD card*/
+#define TELEMETRY_CAPTURE_WRITE_SIZE    512
+
+// Time of each START_STOP, taken by the receive interrupt
+struct TelemetryCaptureStamp {
+  tmr10ms_t coarse;
+  uint16_t  fine;     // getTmr2MHz()
+};
+extern TelemetryCaptureStamp telemetryCaptureStamps[TELEMETRY_CAPTURE_STAMPS];
+extern uint32_t telemetryCaptureStampsCount;
+
+inline void telemetryCaptureStamp()
+{
+  TelemetryCaptureStamp & stamp = telemetryCaptureStamps[telemetryCaptureStampsCount % TELEMETRY_CAPTURE_STAMPS];
+  stamp.coarse = get_tmr10ms();
+  stamp.fine = getTmr2MHz();
+  __atomic_store_n(&telemetryCaptureStampsCount, telemetryCaptureStampsCount + 1, __ATOMIC_RELEASE);
+}
+
+struct TelemetryCaptureStats {
+  uint32_t frames;
+  uint32_t dropped;   // the RAM buffer was full
+  uint32_t written;   // bytes
+};
+extern TelemetryCaptureStats telemetryCaptureStats;
+
+bool telemetryCaptureStart(const char * path);
+void telemetryCaptureStop();
+bool isTelemetryCaptureRunning();
+void telemetryCaptureFrameStart();
+void telemetryCaptureFrame(const uint8_t * data, uint8_t length);
+void telemetryCaptureWakeup(bool flush=false);
+#endif
+
 void frskySportSetDefault(int index, uint16_t type, uint8_t instance);
 void frskyDSetDefault(int index, uint16_t id);
 
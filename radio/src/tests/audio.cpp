@@ -0,0 +1,172 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <math.h>
+#include "gtests.h"
+
+#if defined(CPUARM)
+#define AUDIO_SILENCE (0x8000 >> 4)
+
+int renderTone(ToneContext & context, int volume, int16_t * samples, int max)
+{
+  int count = 0;
+  AudioBuffer buffer;
+  while (count + AUDIO_BUFFER_SIZE <= max) {
+    for (int i=0; i<AUDIO_BUFFER_SIZE; i++)
+      buffer.data[i] = AUDIO_SILENCE;
+    int result = context.mixBuffer(&buffer, volume, 0);
+    if (result <= 0)
+      break;
+    for (int i=0; i<result; i++)
+      samples[count++] = buffer.data[i] - AUDIO_SILENCE;
+  }
+  return count;
+}
+
+// the floating point synthesizer this one replaced, single buffer, for reference
+void renderReferenceTone(uint16_t freq, int volume, int16_t * samples, int count)
+{
+  const unsigned int toneVolumes[] = { 10, 8, 6, 4, 2 };
+  float ratio = toneVolumes[2+volume];
+  if (freq < 330)
+    ratio = (ratio * freq * freq) / (330 * 330);
+  double step = double(1024*freq) / AUDIO_SAMPLE_RATE;
+  double idx = 0;
+  for (int i=0; i<count; i++) {
+    int16_t sample = sineValues[int(idx)] / ratio;
+    samples[i] = (sample >> 4);
+    idx += step;
+    if ((unsigned int)idx >= 1024)
+      idx -= 1024;
+  }
+}
+
+double goertzel(const int16_t * samples, int count, int freq)
+{
+  double coeff = 2 * cos(2 * M_PI * freq / AUDIO_SAMPLE_RATE);
+  double s1 = 0, s2 = 0;
+  for (int i=0; i<count; i++) {
+    double s0 = samples[i] + coeff * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  return (s1 * s1 + s2 * s2 - coeff * s1 * s2) / count;
+}
+
+int zeroCrossings(const int16_t * samples, int count)
+{
+  int result = 0;
+  for (int i=1; i<count; i++) {
+    if ((samples[i-1] < 0) != (samples[i] < 0))
+      result++;
+  }
+  return result;
+}
+
+TEST(Audio, toneSpectrum)
+{
+  static const uint16_t freqs[] = { 200, 440, 1000, 2250, 3600 };
+  int16_t samples[AUDIO_BUFFER_SIZE], reference[AUDIO_BUFFER_SIZE];
+  ToneContext context;
+
+  for (unsigned int i=0; i<DIM(freqs); i++) {
+    for (int volume=-2; volume<=2; volume++) {
+      AudioFragment fragment;
+      fragment.clear();
+      fragment.type = FRAGMENT_TONE;
+      fragment.tone.freq = freqs[i];
+      fragment.tone.duration = 100;
+      context.clear();
+      context.setFragment(fragment);
+      EXPECT_EQ(AUDIO_BUFFER_SIZE, renderTone(context, volume, samples, AUDIO_BUFFER_SIZE));
+      renderReferenceTone(freqs[i], volume, reference, AUDIO_BUFFER_SIZE);
+      double power = goertzel(samples, AUDIO_BUFFER_SIZE, freqs[i]);
+      double referencePower = goertzel(reference, AUDIO_BUFFER_SIZE, freqs[i]);
+      EXPECT_NEAR(1.0, power / referencePower, 0.02) << freqs[i] << "Hz volume " << volume;
+      EXPECT_GT(power, 20 * goertzel(samples, AUDIO_BUFFER_SIZE, freqs[i] * 3 / 2));
+      EXPECT_NEAR(zeroCrossings(reference, AUDIO_BUFFER_SIZE), zeroCrossings(samples, AUDIO_BUFFER_SIZE), 1);
+    }
+  }
+}
+
+TEST(Audio, toneDuration)
+{
+  int16_t samples[20*AUDIO_BUFFER_SIZE];
+  ToneContext context;
+  AudioFragment fragment;
+  fragment.clear();
+  fragment.type = FRAGMENT_TONE;
+  fragment.tone.freq = 1000;
+  fragment.tone.duration = 95;
+  fragment.tone.pause = 30;
+  context.clear();
+  context.setFragment(fragment);
+
+  int count = renderTone(context, 0, samples, DIM(samples));
+  EXPECT_EQ(13*AUDIO_BUFFER_SIZE, count);
+
+  // the tone stops on a whole period, then the buffers are silent
+  int last = 0;
+  for (int i=0; i<count; i++) {
+    if (samples[i] != 0)
+      last = i;
+  }
+  EXPECT_LE(last, 95 * AUDIO_SAMPLE_RATE / 1000);
+  EXPECT_GE(last, 95 * AUDIO_SAMPLE_RATE / 1000 - AUDIO_SAMPLE_RATE / 1000);
+  EXPECT_EQ(0, context.fragment.type);
+}
+
+TEST(Audio, toneSweep)
+{
+  int16_t samples[10*AUDIO_BUFFER_SIZE];
+  ToneContext context;
+  AudioFragment fragment;
+  fragment.clear();
+  fragment.type = FRAGMENT_TONE;
+  fragment.tone.freq = 1000;
+  fragment.tone.duration = 100;
+  fragment.tone.pause = 10;
+  fragment.tone.freqIncr = 10;
+  context.clear();
+  context.setFragment(fragment);
+
+  EXPECT_EQ(10*AUDIO_BUFFER_SIZE, renderTone(context, 0, samples, DIM(samples)));
+  // 1000Hz in the first buffer, then each buffer glides by 100Hz
+  EXPECT_NEAR(20, zeroCrossings(samples, AUDIO_BUFFER_SIZE), 1);
+  EXPECT_NEAR(2*1750/100, zeroCrossings(&samples[8*AUDIO_BUFFER_SIZE], AUDIO_BUFFER_SIZE), 1);
+  EXPECT_GT(goertzel(&samples[8*AUDIO_BUFFER_SIZE], AUDIO_BUFFER_SIZE, 1750), 20 * goertzel(&samples[8*AUDIO_BUFFER_SIZE], AUDIO_BUFFER_SIZE, 1000));
+}
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include "gtests.h"
+
+#if defined(CPUARM)
+TEST(Fifo, pushPop)
+{
+  Fifo<16> fifo;
+  uint8_t byte;
+
+  EXPECT_TRUE(fifo.empty());
+  EXPECT_FALSE(fifo.pop(byte));
+  for (int i=0; i<16; i++) {
+    EXPECT_TRUE(fifo.push(i));
+  }
+  EXPECT_TRUE(fifo.full());
+  EXPECT_FALSE(fifo.push(16));
+  EXPECT_EQ(1u, fifo.getOverflows());
+  for (int i=0; i<16; i++) {
+    EXPECT_TRUE(fifo.pop(byte));
+    EXPECT_EQ(i, byte);
+  }
+  EXPECT_TRUE(fifo.empty());
+}
+
+TEST(Fifo, bulkWrap)
+{
+  Fifo<16> fifo;
+  uint8_t data[16], result[16];
+  for (int i=0; i<16; i++) {
+    data[i] = 100 + i;
+  }
+
+  // every start offset, every length
+  for (int offset=0; offset<16; offset++) {
+    for (int len=1; len<=16; len++) {
+      fifo.clear();
+      for (int i=0; i<offset; i++) {
+        fifo.push(0);
+      }
+      fifo.clear();
+      EXPECT_EQ(len, fifo.push(data, len));
+      EXPECT_EQ(len, fifo.size());
+      memset(result, 0, sizeof(result));
+      EXPECT_EQ(len, fifo.pop(result, 16));
+      EXPECT_EQ(0, memcmp(data, result, len)) << "offset " << offset << " len " << len;
+      EXPECT_TRUE(fifo.empty());
+    }
+  }
+
+  fifo.clear();
+  EXPECT_EQ(10, fifo.push(data, 10));
+  EXPECT_EQ(6, fifo.push(data, 10));
+  EXPECT_EQ(4u, fifo.getOverflows());
+}
+
+TEST(Fifo, spans)
+{
+  Fifo<16> fifo;
+  uint8_t * w;
+  const uint8_t * r;
+
+  for (int i=0; i<12; i++) {
+    fifo.push(i);
+  }
+  uint8_t byte;
+  for (int i=0; i<10; i++) {
+    fifo.pop(byte);
+  }
+
+  // 2 bytes at the end of the buffer, the free space wraps
+  EXPECT_EQ(4, fifo.writeSpan(w));
+  memset(w, 0xAA, 4);
+  fifo.commit(4);
+  EXPECT_EQ(10, fifo.writeSpan(w));
+  memset(w, 0xBB, 3);
+  fifo.commit(3);
+
+  EXPECT_EQ(6, fifo.readSpan(r));
+  EXPECT_EQ(10, r[0]);
+  EXPECT_EQ(11, r[1]);
+  EXPECT_EQ(0xAA, r[5]);
+  fifo.consume(6);
+  EXPECT_EQ(3, fifo.readSpan(r));
+  EXPECT_EQ(0xBB, r[2]);
+  fifo.consume(3);
+  EXPECT_EQ(0, fifo.readSpan(r));
+  EXPECT_EQ(0u, fifo.getOverflows());
+}
+
+#define FIFO_STRESS_BYTES  (1024*1024)
+
+struct FifoStress {
+  Fifo<64> fifo;
+  bool spans;
+  uint32_t errors;
+};
+
+static uint8_t fifoStressByte(uint32_t index)
+{
+  return index ^ (index >> 8) ^ (index >> 16);
+}
+
+static void * fifoStressProducer(void * arg)
+{
+  FifoStress & stress = *(FifoStress *)arg;
+  uint8_t data[37];
+  uint32_t index = 0;
+  uint32_t random = 1;
+
+  while (index < FIFO_STRESS_BYTES) {
+    if (stress.fifo.full()) {
+      sched_yield();
+      continue;
+    }
+    random = random * 1103515245 + 12345;
+    uint32_t len = 1 + (random >> 16) % sizeof(data);
+    if (len > FIFO_STRESS_BYTES - index)
+      len = FIFO_STRESS_BYTES - index;
+    if (len == 1) {
+      if (stress.fifo.push(fifoStressByte(index)))
+        index++;
+    }
+    else if (stress.spans) {
+      uint8_t * span;
+      uint32_t count = stress.fifo.writeSpan(span);
+      if (count > len)
+        count = len;
+      for (uint32_t i=0; i<count; i++) {
+        span[i] = fifoStressByte(index+i);
+      }
+      stress.fifo.commit(count);
+      index += count;
+    }
+    else {
+      // only push what fits, an overflow would lose bytes
+      uint32_t count = 64 - stress.fifo.size();
+      if (count > len)
+        count = len;
+      for (uint32_t i=0; i<count; i++) {
+        data[i] = fifoStressByte(index+i);
+      }
+      index += stress.fifo.push(data, count);
+    }
+  }
+  return NULL;
+}
+
+static void * fifoStressConsumer(void * arg)
+{
+  FifoStress & stress = *(FifoStress *)arg;
+  uint8_t data[29];
+  uint32_t index = 0;
+
+  while (index < FIFO_STRESS_BYTES) {
+    if (stress.fifo.empty()) {
+      sched_yield();
+      continue;
+    }
+    if (stress.spans) {
+      const uint8_t * span;
+      int count = stress.fifo.readSpan(span);
+      for (int i=0; i<count; i++) {
+        if (span[i] != fifoStressByte(index+i))
+          stress.errors++;
+      }
+      stress.fifo.consume(count);
+      index += count;
+    }
+    else if (index & 1) {
+      uint8_t byte;
+      if (stress.fifo.pop(byte)) {
+        if (byte != fifoStressByte(index))
+          stress.errors++;
+        index++;
+      }
+    }
+    else {
+      int count = stress.fifo.pop(data, sizeof(data));
+      for (int i=0; i<count; i++) {
+        if (data[i] != fifoStressByte(index+i))
+          stress.errors++;
+      }
+      index += count;
+    }
+  }
+  return NULL;
+}
+
+void fifoStress(bool spans)
+{
+  FifoStress stress = FifoStress();
+  stress.spans = spans;
+
+  pthread_t producer, consumer;
+  pthread_create(&consumer, NULL, fifoStressConsumer, &stress);
+  pthread_create(&producer, NULL, fifoStressProducer, &stress);
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+
+  EXPECT_EQ(0u, stress.errors);
+  EXPECT_EQ(0u, stress.fifo.getOverflows());
+  EXPECT_TRUE(stress.fifo.empty());
+}
+
+TEST(Fifo, threadsPushPop)
+{
+  fifoStress(false);
+}
+
+TEST(Fifo, threadsSpans)
+{
+  fifoStress(true);
+}
+#endif
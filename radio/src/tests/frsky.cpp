@@ -113,6 +113,232 @@ TEST(FrSky, FrskyValueWithMinAveraging)
     EXPECT_EQ(testVal.value, expected[testPos++]);
   }
 }
+
+TEST(Telemetry, calculatedSensorsChain)
+{
+  MODEL_RESET();
+  telemetryReset();
+
+  // sensor 1 = sensor 2 + sensor 3, sensor 2 = sensor 3 + sensor 4
+  g_model.telemetrySensors[0].init("SUM1");
+  g_model.telemetrySensors[0].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[0].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[0].calc.sources[0] = 2;
+  g_model.telemetrySensors[0].calc.sources[1] = 3;
+  g_model.telemetrySensors[1].init("SUM2");
+  g_model.telemetrySensors[1].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[1].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[1].calc.sources[0] = 3;
+  g_model.telemetrySensors[1].calc.sources[1] = 4;
+  g_model.telemetrySensors[2].init("A");
+  g_model.telemetrySensors[3].init("B");
+
+  evalCalculatedSensors();
+  EXPECT_FALSE(telemetryItems[0].isAvailable());
+  EXPECT_FALSE(telemetryItems[1].isAvailable());
+
+  telemetryItems[2].setValue(g_model.telemetrySensors[2], 10, UNIT_RAW);
+  telemetryItems[3].setValue(g_model.telemetrySensors[3], 20, UNIT_RAW);
+  evalCalculatedSensors();
+  EXPECT_EQ(30, telemetryItems[1].value);
+  EXPECT_EQ(40, telemetryItems[0].value);
+  EXPECT_EQ(0u, telemetryItemsUpdated);
+
+  // nothing is recomputed until a source is set again
+  telemetryItems[3].value = 100;
+  evalCalculatedSensors();
+  EXPECT_EQ(30, telemetryItems[1].value);
+  telemetryItems[3].setValue(g_model.telemetrySensors[3], 50, UNIT_RAW);
+  evalCalculatedSensors();
+  EXPECT_EQ(60, telemetryItems[1].value);
+  EXPECT_EQ(70, telemetryItems[0].value);
+
+  telemetryItems[2].setOld();
+  evalCalculatedSensors();
+  EXPECT_TRUE(telemetryItems[1].isOld());
+  EXPECT_TRUE(telemetryItems[0].isOld());
+
+  // the sources are read again after a configuration change
+  g_model.telemetrySensors[1].calc.sources[0] = 0;
+  invalidateCalculatedSensors();
+  evalCalculatedSensors();
+  EXPECT_EQ(50, telemetryItems[1].value);
+}
+
+static int32_t cellsData(uint8_t count, uint8_t index, uint16_t cell1, uint16_t cell2)
+{
+  return (count << 4) + index + (((cell1 * 5) & 0xFFF) << 8) + (((cell2 * 5) & 0xFFF) << 20);
+}
+
+TEST(Telemetry, cells)
+{
+  MODEL_RESET();
+  telemetryReset();
+
+  g_model.telemetrySensors[0].init("Cels");
+  g_model.telemetrySensors[0].unit = UNIT_CELLS;
+  g_model.telemetrySensors[0].prec = 2;
+  for (int i=1; i<=5; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    sensor.init("Cell");
+    sensor.type = TELEM_TYPE_CALCULATED;
+    sensor.formula = TELEM_FORMULA_CELL;
+    sensor.unit = UNIT_VOLTS;
+    sensor.prec = 2;
+    sensor.cell.source = 1;
+  }
+  g_model.telemetrySensors[1].cell.index = TELEM_CELL_INDEX_LOWEST;
+  g_model.telemetrySensors[2].cell.index = TELEM_CELL_INDEX_HIGHEST;
+  g_model.telemetrySensors[3].cell.index = TELEM_CELL_INDEX_DELTA;
+  g_model.telemetrySensors[4].cell.index = TELEM_CELL_INDEX_3;
+  g_model.telemetrySensors[5].cell.index = TELEM_CELL_INDEX_SAG;
+
+  TelemetryItem & cells = telemetryItems[0];
+
+  // nothing until all the cells have been received
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 0, 410, 420), UNIT_CELLS);
+  evalCalculatedSensors();
+  EXPECT_FALSE(cells.isAvailable());
+  EXPECT_FALSE(telemetryItems[1].isAvailable());
+
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 2, 400, 0), UNIT_CELLS);
+  evalCalculatedSensors();
+  EXPECT_EQ(1230, cells.value);
+  EXPECT_EQ(400, telemetryItems[1].value);
+  EXPECT_EQ(420, telemetryItems[2].value);
+  EXPECT_EQ(20, telemetryItems[3].value);
+  EXPECT_EQ(400, telemetryItems[4].value);
+  EXPECT_EQ(0, telemetryItems[5].value);
+
+  // the lowest cell rises above another one, the highest one falls
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 0, 390, 380), UNIT_CELLS);
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 2, 395, 0), UNIT_CELLS);
+  evalCalculatedSensors();
+  EXPECT_EQ(1165, cells.value);
+  EXPECT_EQ(380, telemetryItems[1].value);
+  EXPECT_EQ(395, telemetryItems[2].value);
+  EXPECT_EQ(15, telemetryItems[3].value);
+  EXPECT_EQ(395, telemetryItems[4].value);
+  EXPECT_EQ(20, telemetryItems[5].value);
+
+  // the sag is measured against the best of the last packs
+  for (int i=0; i<TELEMETRY_CELLS_HISTORY; i++) {
+    cells.setValue(g_model.telemetrySensors[0], cellsData(3, 0, 390, 385), UNIT_CELLS);
+    cells.setValue(g_model.telemetrySensors[0], cellsData(3, 2, 395, 0), UNIT_CELLS);
+  }
+  evalCalculatedSensors();
+  EXPECT_EQ(385, telemetryItems[1].value);
+  EXPECT_EQ(0, telemetryItems[5].value);
+
+  // values too low are ignored, the previous ones are kept
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 0, 0, 300), UNIT_CELLS);
+  cells.setValue(g_model.telemetrySensors[0], cellsData(3, 2, 395, 0), UNIT_CELLS);
+  evalCalculatedSensors();
+  EXPECT_EQ(1085, cells.value);
+  EXPECT_EQ(300, telemetryItems[1].value);
+  EXPECT_EQ(85, telemetryItems[5].value);
+
+  // a new cells count restarts from scratch
+  cells.setValue(g_model.telemetrySensors[0], cellsData(2, 0, 410, 405), UNIT_CELLS);
+  evalCalculatedSensors();
+  EXPECT_EQ(815, cells.value);
+  EXPECT_EQ(405, telemetryItems[1].value);
+  EXPECT_EQ(5, telemetryItems[3].value);
+  EXPECT_EQ(0, telemetryItems[5].value);
+}
+
+TEST(Telemetry, history)
+{
+  MODEL_RESET();
+  telemetryReset();
+  g_tmr10ms = 0;
+
+  g_model.telemetrySensors[0].init("Alt", UNIT_METERS, 1);
+  for (int i=1; i<=4; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    sensor.init("Hist", UNIT_METERS, 1);
+    sensor.type = TELEM_TYPE_CALCULATED;
+    sensor.formula = TELEM_FORMULA_HISTORY;
+    sensor.history.source = 1;
+  }
+  g_model.telemetrySensors[1].history.stat = TELEM_HISTORY_AVERAGE;
+  g_model.telemetrySensors[2].history.stat = TELEM_HISTORY_SLOPE;
+  g_model.telemetrySensors[3].history.stat = TELEM_HISTORY_PERCENTILE;
+  g_model.telemetrySensors[3].history.percent = 90;
+  g_model.telemetrySensors[4].history.stat = TELEM_HISTORY_AVERAGE;
+  g_model.telemetrySensors[4].history.scale = 1;
+  g_model.telemetrySensors[4].unit = UNIT_FEET;
+  evalCalculatedSensors();
+  EXPECT_EQ(1, telemetryHistorySlots[0]);
+
+  // climbing 1m per second, 2 values per period of scale 0
+  for (int i=0; i<=2*TELEMETRY_HISTORY_SAMPLES; i++) {
+    g_tmr10ms = i * TELEMETRY_HISTORY_PERIOD / 2;
+    telemetryItems[0].setValue(g_model.telemetrySensors[0], g_tmr10ms / 10, UNIT_METERS, 1);
+    evalCalculatedSensors();
+  }
+  const TelemetryHistoryRing & ring = telemetryHistories[0].scales[0];
+  EXPECT_EQ(TELEMETRY_HISTORY_SAMPLES, ring.count);
+  EXPECT_EQ(30, ring.get(0));
+  EXPECT_EQ(0, ring.get(TELEMETRY_HISTORY_SAMPLES-1));
+  EXPECT_EQ(15, telemetryItems[1].value);
+  EXPECT_EQ(10, telemetryItems[2].value);
+  EXPECT_EQ(28, telemetryItems[3].value);
+  EXPECT_EQ(1, telemetryHistories[0].scales[1].count);
+  EXPECT_EQ(convertTelemetryValue(9, UNIT_METERS, 1, UNIT_FEET, 1), telemetryItems[4].value);
+
+  // the next scale gets one sample every DECIMATION samples
+  for (int i=2*TELEMETRY_HISTORY_SAMPLES+1; i<=2*TELEMETRY_HISTORY_SAMPLES*TELEMETRY_HISTORY_DECIMATION; i++) {
+    g_tmr10ms = i * TELEMETRY_HISTORY_PERIOD / 2;
+    telemetryItems[0].setValue(g_model.telemetrySensors[0], g_tmr10ms / 10, UNIT_METERS, 1);
+    evalCalculatedSensors();
+  }
+  EXPECT_EQ(TELEMETRY_HISTORY_SAMPLES, telemetryHistories[0].scales[1].count);
+  EXPECT_EQ(9, telemetryHistories[0].scales[1].get(TELEMETRY_HISTORY_SAMPLES-1));
+  EXPECT_EQ(309, telemetryHistories[0].scales[1].get(0));
+  EXPECT_EQ(10, telemetryHistories[0].scales[1].slope(TELEMETRY_HISTORY_PERIOD*TELEMETRY_HISTORY_DECIMATION));
+  EXPECT_EQ(convertTelemetryValue(159, UNIT_METERS, 1, UNIT_FEET, 1), telemetryItems[4].value);
+
+  // the history goes with the sensor
+  telemetryItems[0].setOld();
+  evalCalculatedSensors();
+  EXPECT_TRUE(telemetryItems[1].isOld());
+  g_model.telemetrySensors[1].history.source = 0;
+  g_model.telemetrySensors[2].history.source = 0;
+  g_model.telemetrySensors[3].history.source = 0;
+  g_model.telemetrySensors[4].history.source = 0;
+  invalidateCalculatedSensors();
+  evalCalculatedSensors();
+  EXPECT_FALSE(telemetryHistories[0].pinned);
+  delTelemetryIndex(0);
+  EXPECT_EQ(0, telemetryHistorySlots[0]);
+  EXPECT_EQ(0, telemetryHistories[0].item);
+}
+
+TEST(Telemetry, historySlots)
+{
+  MODEL_RESET();
+  telemetryReset();
+  g_tmr10ms = 0;
+
+  // the slot read the longest time ago is reused, pinned ones are kept
+  for (int i=0; i<TELEMETRY_HISTORY_MAX; i++) {
+    g_tmr10ms = i;
+    EXPECT_NE((TelemetryHistory *)NULL, getTelemetryHistory(i));
+  }
+  pinTelemetryHistories(1 << 0);
+  g_tmr10ms = 100;
+  getTelemetryHistory(1);
+  TelemetryHistory * history = getTelemetryHistory(TELEMETRY_HISTORY_MAX);
+  EXPECT_EQ(&telemetryHistories[2], history);
+  EXPECT_EQ(0, telemetryHistorySlots[2]);
+  EXPECT_EQ(3, telemetryHistorySlots[TELEMETRY_HISTORY_MAX]);
+
+  pinTelemetryHistories((1 << TELEMETRY_HISTORY_MAX) - 1);
+  EXPECT_EQ(3, telemetryHistorySlots[2]);
+  EXPECT_EQ(0, telemetryHistorySlots[TELEMETRY_HISTORY_MAX]);
+  EXPECT_EQ((TelemetryHistory *)NULL, getTelemetryHistory(TELEMETRY_HISTORY_MAX+1));
+}
 #endif
 
 
@@ -435,6 +661,211 @@ TEST(FrSkySPORT, frskyCurrent)
 }
 #endif
 
+#if defined(PCBTARANIS)
+extern uint8_t telemetryProtocol;
+extern int8_t telemetryFrameLength;
+extern void processSerialData(uint8_t data);
+
+// S.Port stream as logged by SPORT_FILE_LOG: polls, stuffed bytes, a bad CRC and a truncated packet
+const uint8_t sportCapture[] = {
+  0x7E, 0x1B, 0x7E, 0x98, 0x7E, 0x98, 0x10, 0x01, 0xF1, 0x7D, 0x5E, 0x00, 0x00, 0x00, 0x7D, 0x5E,
+  0x7E, 0x39, 0x7E, 0xA1, 0x7E, 0xA1, 0x10, 0x00, 0x03, 0x30, 0x0C, 0x38, 0x7F, 0xF8, 0x7E, 0xA1,
+  0x10, 0x00, 0x03, 0x32, 0xC6, 0x07, 0x00, 0xEC, 0x7E, 0x22, 0x7E, 0x22, 0x10, 0x10, 0x02, 0xA2,
+  0x04, 0x00, 0x00, 0x37, 0x7E, 0x00, 0x10, 0x00, 0x01, 0x7D, 0x5E, 0x7D, 0x5D, 0x00, 0x00, 0xF2,
+  0x7E, 0x98, 0x10, 0x01, 0xF1, 0x37, 0x00, 0x00, 0x00, 0xC4, 0x7E, 0x98, 0x10, 0x01, 0x7E, 0x98,
+  0x10, 0x01, 0xF1, 0x57, 0x00, 0x00, 0x00, 0xA5, 0x7E, 0x98, 0x10, 0x04, 0xF1, 0x7D, 0x5D, 0x00,
+  0x00, 0x00, 0x7C, 0x7E, 0x22, 0x10, 0x00, 0x02, 0x7D, 0x5D, 0x00, 0x00, 0x00, 0x70, 0x7E, 0x22,
+  0x10, 0x10, 0x02, 0x9C, 0x04, 0x00, 0x00, 0x3D, 0x7E, 0x83, 0x7E, 0x83, 0x10, 0x00, 0x05, 0x7D,
+  0x5E, 0x7D, 0x5E, 0x00, 0x00, 0xED, 0x7E, 0xA1, 0x10, 0x00, 0x03, 0x30, 0x07, 0xE8, 0x7D, 0x5E,
+  0x4E, 0x7E, 0xA1, 0x10, 0x00, 0x03, 0x32, 0xCB, 0x07, 0x00, 0xE7, 0x7E, 0xE4, 0x7E
+};
+
+TEST(FrSkySPORT, frameReplay)
+{
+  static TelemetryItem expectedItems[TELEM_VALUES_MAX];
+  static TelemetrySensor expectedSensors[TELEM_VALUES_MAX];
+  static FrskyData expectedData;
+
+  MODEL_RESET();
+  telemetryReset();
+  telemetryProtocol = PROTOCOL_FRSKY_SPORT;
+  for (unsigned int i=0; i<sizeof(sportCapture); i++) {
+    processSerialData(sportCapture[i]);
+  }
+  EXPECT_NE(0, TELEMETRY_RSSI());
+  int sensors = 0;
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    if (telemetryItems[i].isAvailable())
+      sensors++;
+  }
+  EXPECT_EQ(7, sensors);
+  memcpy(expectedItems, telemetryItems, sizeof(telemetryItems));
+  memcpy(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors));
+  memcpy(&expectedData, &frskyData, sizeof(frskyData));
+
+  static const int blockSizes[] = { 1, 3, 7, 16, sizeof(sportCapture) };
+  for (unsigned int i=0; i<DIM(blockSizes); i++) {
+    MODEL_RESET();
+    telemetryReset();
+    telemetryFrameLength = -1;
+    for (unsigned int j=0; j<sizeof(sportCapture); j+=blockSizes[i]) {
+      processTelemetryData(&sportCapture[j], min<int>(blockSizes[i], sizeof(sportCapture)-j));
+    }
+    EXPECT_EQ(0, memcmp(expectedItems, telemetryItems, sizeof(telemetryItems))) << "block size " << blockSizes[i];
+    EXPECT_EQ(0, memcmp(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors))) << "block size " << blockSizes[i];
+    EXPECT_EQ(0, memcmp(&expectedData, &frskyData, sizeof(frskyData))) << "block size " << blockSizes[i];
+  }
+}
+
+static FILE * writeSportLog(const uint8_t * data, int size, int bytesPerRecord, int msPerRecord)
+{
+  FILE * file = tmpfile();
+  for (int i=0, time=0; i<size; i+=bytesPerRecord, time+=msPerRecord) {
+    fprintf(file, "\r\n2014-09-21,23:59:%02d.%03d:", 50+time/1000, time%1000);
+    for (int j=i; j<size && j<i+bytesPerRecord; j++) {
+      fprintf(file, " %02X", data[j]);
+    }
+  }
+  rewind(file);
+  return file;
+}
+
+TEST(FrSkySPORT, replay)
+{
+  static TelemetryItem expectedItems[TELEM_VALUES_MAX];
+  static TelemetrySensor expectedSensors[TELEM_VALUES_MAX];
+
+  MODEL_RESET();
+  telemetryReset();
+  telemetryProtocol = PROTOCOL_FRSKY_SPORT;
+  processTelemetryData(sportCapture, sizeof(sportCapture));
+  memcpy(expectedItems, telemetryItems, sizeof(telemetryItems));
+  memcpy(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors));
+
+  // as fast as possible
+  FILE * file = writeSportLog(sportCapture, sizeof(sportCapture), 10, 50);
+  MODEL_RESET();
+  telemetryReset();
+  telemetryInit();
+  EXPECT_TRUE(telemetryReplayStart(file, 0));
+  while (telemetryReplayWakeup() >= 0) {
+    telemetryWakeup();
+  }
+  EXPECT_FALSE(isTelemetryReplayRunning());
+  EXPECT_EQ(sizeof(sportCapture), telemetryReplayStats.bytes);
+  EXPECT_EQ((sizeof(sportCapture)+9)/10, telemetryReplayStats.records);
+  EXPECT_EQ(0, memcmp(expectedItems, telemetryItems, sizeof(telemetryItems)));
+  EXPECT_EQ(0, memcmp(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors)));
+
+  // real time, one record every 50ms
+  rewind(file);
+  g_tmr10ms = 0;
+  EXPECT_TRUE(telemetryReplayStart(file, 1));
+  EXPECT_EQ(10, telemetryReplayWakeup());
+  EXPECT_EQ(0, telemetryReplayWakeup());
+  g_tmr10ms = 4;
+  EXPECT_EQ(0, telemetryReplayWakeup());
+  g_tmr10ms = 5;
+  EXPECT_EQ(10, telemetryReplayWakeup());
+  EXPECT_EQ(2u, telemetryReplayStats.records);
+
+  // double speed
+  rewind(file);
+  g_tmr10ms = 0;
+  EXPECT_TRUE(telemetryReplayStart(file, 2));
+  telemetryReplayWakeup();
+  g_tmr10ms = 5;
+  EXPECT_EQ(20, telemetryReplayWakeup());
+  EXPECT_EQ(3u, telemetryReplayStats.records);
+
+  telemetryReplayStop();
+  fclose(file);
+}
+
+TEST(FrSkySPORT, capture)
+{
+  static TelemetryItem expectedItems[TELEM_VALUES_MAX];
+  static TelemetrySensor expectedSensors[TELEM_VALUES_MAX];
+  const char * path = "sportcap_test.cap";
+
+  MODEL_RESET();
+  telemetryReset();
+  telemetryProtocol = PROTOCOL_FRSKY_SPORT;
+  telemetryFrameLength = -1;
+  g_tmr10ms = 0;
+  tim7.CNT = 0;
+  EXPECT_TRUE(telemetryCaptureStart(path));
+
+  // one START_STOP every 2.5ms, the 2MHz timer wraps every 32.768ms
+  int frames = 0;
+  for (unsigned int i=0, delimiters=0; i<sizeof(sportCapture); i++) {
+    if (sportCapture[i] == START_STOP) {
+      g_tmr10ms = delimiters * 2500 / 10000;
+      tim7.CNT = delimiters * 5000;
+      telemetryCaptureStamp();
+      if (i+1 < sizeof(sportCapture) && sportCapture[i+1] != START_STOP)
+        frames++;
+      delimiters++;
+    }
+    processTelemetryData(&sportCapture[i], 1);
+  }
+  telemetryCaptureStop();
+  EXPECT_FALSE(isTelemetryCaptureRunning());
+  EXPECT_EQ(frames, (int)telemetryCaptureStats.frames);
+  EXPECT_EQ(0u, telemetryCaptureStats.dropped);
+  memcpy(expectedItems, telemetryItems, sizeof(telemetryItems));
+  memcpy(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors));
+
+  // each record holds the bytes following its START_STOP, with the time of this START_STOP
+  FILE * file = fopen(path, "rb");
+  ASSERT_TRUE(file != NULL);
+  uint8_t record[TELEMETRY_CAPTURE_RECORD_SIZE + 255];
+  ASSERT_EQ(sizeof(record[0])*(TELEMETRY_CAPTURE_RECORD_SIZE+TELEMETRY_CAPTURE_HEADER_SIZE), fread(record, 1, TELEMETRY_CAPTURE_RECORD_SIZE+TELEMETRY_CAPTURE_HEADER_SIZE, file));
+  EXPECT_EQ(TELEMETRY_CAPTURE_SESSION, *(uint32_t *)&record[0]);
+  EXPECT_EQ(0, memcmp(&record[TELEMETRY_CAPTURE_RECORD_SIZE], TELEMETRY_CAPTURE_MAGIC, 4));
+  EXPECT_EQ(PROTOCOL_FRSKY_SPORT, record[TELEMETRY_CAPTURE_RECORD_SIZE+5]);
+  int records = 0;
+  uint32_t lastTime = 0;
+  while (fread(record, 1, TELEMETRY_CAPTURE_RECORD_SIZE, file) == TELEMETRY_CAPTURE_RECORD_SIZE) {
+    uint32_t time = *(uint32_t *)&record[0];
+    uint8_t length = record[4];
+    ASSERT_EQ(length, fread(&record[TELEMETRY_CAPTURE_RECORD_SIZE], 1, length, file));
+    EXPECT_EQ(0u, time % 2500);
+    EXPECT_TRUE(records == 0 || time > lastTime);
+    unsigned int delimiter = 0;
+    for (unsigned int i=0, count=0; i<sizeof(sportCapture); i++) {
+      if (sportCapture[i] == START_STOP && count++ == time / 2500) {
+        delimiter = i;
+        break;
+      }
+    }
+    ASSERT_LE(delimiter+1+length, sizeof(sportCapture));
+    EXPECT_EQ(0, memcmp(&sportCapture[delimiter+1], &record[TELEMETRY_CAPTURE_RECORD_SIZE], length)) << "record " << records;
+    lastTime = time;
+    records++;
+  }
+  EXPECT_EQ(frames, records);
+  EXPECT_GT(lastTime, 32768u);
+
+  // the capture replays to the same sensors
+  rewind(file);
+  MODEL_RESET();
+  telemetryReset();
+  telemetryInit();
+  EXPECT_TRUE(telemetryReplayStart(file, 0));
+  while (telemetryReplayWakeup() >= 0) {
+    telemetryWakeup();
+  }
+  EXPECT_EQ((unsigned int)records, telemetryReplayStats.records);
+  EXPECT_EQ(0, memcmp(expectedItems, telemetryItems, sizeof(telemetryItems)));
+  EXPECT_EQ(0, memcmp(expectedSensors, g_model.telemetrySensors, sizeof(g_model.telemetrySensors)));
+
+  telemetryReplayStop();
+  fclose(file);
+  remove(path);
+}
+#endif
+
 #endif  //#if defined(FRSKY_SPORT)
 
 
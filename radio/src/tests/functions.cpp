@@ -0,0 +1,193 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(CPUARM)
+
+#if defined(PCBTARANIS)
+  #define TEST_SWITCH          SWSRC_SA0
+  #define TEST_SWITCH_ON()     simuSetSwitch(0, -1)
+  #define TEST_SWITCH_OFF()    simuSetSwitch(0, 1)
+#else
+  #define TEST_SWITCH          SWSRC_THR
+  #define TEST_SWITCH_ON()     simuSetSwitch(0, 1)
+  #define TEST_SWITCH_OFF()    simuSetSwitch(0, -1)
+#endif
+
+#define FUNCTIONS_RESET() \
+  memset(&g_model, 0, sizeof(g_model)); \
+  memset(g_eeGeneral.customFn, 0, sizeof(g_eeGeneral.customFn)); \
+  MIXER_RESET(); \
+  customFunctionsReset()
+
+static void setFunction(CustomFunctionData * cfn, int8_t swtch, uint8_t func, int16_t param=0, uint8_t enabled=1)
+{
+  CFN_SWITCH(cfn) = swtch;
+  CFN_FUNC(cfn) = func;
+  CFN_PARAM(cfn) = param;
+  CFN_ACTIVE(cfn) = enabled;
+}
+
+TEST(Functions, SharedSwitch)
+{
+  FUNCTIONS_RESET();
+  setFunction(&g_model.customFn[0], TEST_SWITCH, FUNC_BACKLIGHT);
+  setFunction(&g_model.customFn[1], TEST_SWITCH, FUNC_TRAINER);
+  setFunction(&g_model.customFn[2], -TEST_SWITCH, FUNC_RESET, FUNC_RESET_TIMER2);
+  setFunction(&g_model.customFn[3], TEST_SWITCH, FUNC_RESET, FUNC_RESET_TIMER1, 0); // disabled
+  setFunction(&g_model.customFn[5], SWSRC_ON, FUNC_RESET, FUNC_RESET_TIMER3);
+  g_model.timers[0].start = 60;
+  g_model.timers[1].start = 30;
+  g_model.timers[2].start = 10;
+
+  for (int i=0; i<3; i++) {
+    timersStates[0].val = timersStates[1].val = timersStates[2].val = 5;
+    TEST_SWITCH_OFF();
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    EXPECT_FALSE(isFunctionActive(FUNCTION_BACKLIGHT));
+    EXPECT_FALSE(isFunctionActive(FUNCTION_TRAINER));
+    EXPECT_EQ(timersStates[0].val, 5);
+    EXPECT_EQ(timersStates[1].val, 30);
+    EXPECT_EQ(timersStates[2].val, 10);
+    EXPECT_EQ(modelFunctionsContext.activeSwitches, (MASK_CFN_TYPE)((1 << 2) + (1 << 5)));
+
+    timersStates[0].val = timersStates[1].val = timersStates[2].val = 5;
+    TEST_SWITCH_ON();
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    EXPECT_TRUE(isFunctionActive(FUNCTION_BACKLIGHT));
+    EXPECT_TRUE(isFunctionActive(FUNCTION_TRAINER));
+    EXPECT_EQ(timersStates[0].val, 5);
+    EXPECT_EQ(timersStates[1].val, 5);
+    EXPECT_EQ(timersStates[2].val, 10);
+    EXPECT_EQ(modelFunctionsContext.activeSwitches, (MASK_CFN_TYPE)((1 << 0) + (1 << 1) + (1 << 5)));
+  }
+}
+
+TEST(Functions, ActiveWhileSwitchOn)
+{
+  FUNCTIONS_RESET();
+  setFunction(&g_model.customFn[0], TEST_SWITCH, FUNC_RESET, FUNC_RESET_TIMER1);
+  g_model.timers[0].start = 60;
+
+  TEST_SWITCH_ON();
+  for (int i=0; i<3; i++) {
+    // the timer is reset on each cycle, not only when the switch goes on
+    timersStates[0].val = 5;
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    EXPECT_EQ(timersStates[0].val, 60);
+  }
+
+  TEST_SWITCH_OFF();
+  timersStates[0].val = 5;
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(timersStates[0].val, 5);
+}
+
+TEST(Functions, EditedFunctions)
+{
+  FUNCTIONS_RESET();
+  setFunction(&g_model.customFn[0], TEST_SWITCH, FUNC_BACKLIGHT);
+  setFunction(&g_eeGeneral.customFn[0], TEST_SWITCH, FUNC_TRAINER);
+
+  TEST_SWITCH_ON();
+  evalFunctions(g_eeGeneral.customFn, globalFunctionsContext);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_TRUE(isFunctionActive(FUNCTION_BACKLIGHT));
+  EXPECT_TRUE(isFunctionActive(FUNCTION_TRAINER));
+
+  // the model menus
+  CFN_SWITCH(&g_model.customFn[0]) = -TEST_SWITCH;
+  eeDirty(EE_MODEL);
+  evalFunctions(g_eeGeneral.customFn, globalFunctionsContext);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_FALSE(isFunctionActive(FUNCTION_BACKLIGHT));
+  EXPECT_TRUE(isFunctionActive(FUNCTION_TRAINER));
+
+  // the radio setup menus
+  CFN_ACTIVE(&g_eeGeneral.customFn[0]) = 0;
+  eeDirty(EE_GENERAL);
+  evalFunctions(g_eeGeneral.customFn, globalFunctionsContext);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_FALSE(isFunctionActive(FUNCTION_BACKLIGHT));
+  EXPECT_FALSE(isFunctionActive(FUNCTION_TRAINER));
+
+  TEST_SWITCH_OFF();
+  evalFunctions(g_eeGeneral.customFn, globalFunctionsContext);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_TRUE(isFunctionActive(FUNCTION_BACKLIGHT));
+  EXPECT_FALSE(isFunctionActive(FUNCTION_TRAINER));
+}
+
+#if defined(OVERRIDE_CHANNEL_FUNCTION)
+TEST(Functions, OverrideChannel)
+{
+  FUNCTIONS_RESET();
+  setFunction(&g_model.customFn[0], TEST_SWITCH, FUNC_OVERRIDE_CHANNEL, 50);
+  CFN_CH_INDEX(&g_model.customFn[0]) = 2;
+  setFunction(&g_model.customFn[1], TEST_SWITCH, FUNC_OVERRIDE_CHANNEL, -20);
+  CFN_CH_INDEX(&g_model.customFn[1]) = 2;
+
+  TEST_SWITCH_ON();
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(safetyCh[2], -20); // the last function wins
+  TEST_SWITCH_OFF();
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(safetyCh[2], OVERRIDE_CHANNEL_UNDEFINED);
+}
+#endif
+
+#if defined(GVARS)
+TEST(Functions, AdjustGVarIncrement)
+{
+  FUNCTIONS_RESET();
+  setFunction(&g_model.customFn[0], TEST_SWITCH, FUNC_ADJUST_GVAR, 1);
+  CFN_GVAR_MODE(&g_model.customFn[0]) = 3; // +1 on each activation
+  CFN_GVAR_INDEX(&g_model.customFn[0]) = 0;
+
+  for (int i=1; i<=3; i++) {
+    TEST_SWITCH_ON();
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    EXPECT_EQ(g_model.flightModeData[0].gvars[0], i);
+    TEST_SWITCH_OFF();
+    evalFunctions(g_model.customFn, modelFunctionsContext);
+    EXPECT_EQ(g_model.flightModeData[0].gvars[0], i);
+  }
+}
+#endif
+
+#endif
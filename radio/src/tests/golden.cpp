@@ -0,0 +1,155 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+#include "gtests.h"
+#include "golden/golden.h"
+
+#if defined(SDCARD)
+static GoldenRecord record, rerun;
+static char names[GOLDEN_MAX_MODELS][64];
+
+class GoldenTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+      general = g_eeGeneral;
+      mode = stickMode;
+    }
+    virtual void TearDown()
+    {
+      g_eeGeneral = general;
+      stickMode = mode;
+      MODEL_RESET();
+      MIXER_RESET();
+    }
+    EEGeneral general;
+    uint8_t mode;
+};
+
+#if defined(GOLDEN_CORPUS_OPTIONS)
+// Returns false when the corpus was recorded with other build options, the
+// models are then skipped, but not silently
+static bool loadCorpusModel(const char * name)
+{
+  const char * error = goldenLoadModel(GOLDEN_CORPUS_PATH, name);
+  if (error && !strcmp(error, GOLDEN_OTHER_OPTIONS)) {
+    printf("[  SKIPPED ] %s: the corpus is recorded with " GOLDEN_CORPUS_OPTIONS "\n", name);
+    return false;
+  }
+  EXPECT_EQ(NULL, error) << name;
+  return error == NULL;
+}
+
+TEST_F(GoldenTest, corpusMatches)
+{
+  int count;
+  ASSERT_EQ(NULL, goldenListModels(GOLDEN_CORPUS_PATH, names, count));
+  ASSERT_LT(0, count);
+
+  for (int i=0; i<count; i++) {
+    if (!loadCorpusModel(names[i])) {
+      continue;
+    }
+    goldenRun(record);
+    char filename[256];
+    sprintf(filename, "%s/%s", GOLDEN_CORPUS_PATH, names[i]);
+    strcpy(strrchr(filename, '.'), GOLDEN_EXT);
+    GoldenDiff diff;
+    ASSERT_EQ(NULL, goldenCompare(filename, record, 0, diff)) << names[i];
+    EXPECT_EQ(0u, diff.count) << names[i] << " first difference at tick " << diff.tick << " channel " << diff.channel << ": " << diff.expected << " != " << diff.actual;
+  }
+}
+
+TEST_F(GoldenTest, runIsRepeatable)
+{
+  int count;
+  ASSERT_EQ(NULL, goldenListModels(GOLDEN_CORPUS_PATH, names, count));
+  ASSERT_LE(2, count);
+
+  // the previous model must not change the outputs
+  if (!loadCorpusModel(names[0])) {
+    return;
+  }
+  goldenRun(record);
+  ASSERT_TRUE(loadCorpusModel(names[1]));
+  goldenRun(rerun);
+  ASSERT_TRUE(loadCorpusModel(names[0]));
+  goldenRun(rerun);
+  EXPECT_EQ(record.channels, rerun.channels);
+  EXPECT_EQ(0, memcmp(record.outputs, rerun.outputs, sizeof(record.outputs)));
+}
+
+#endif
+
+TEST_F(GoldenTest, compareReportsFirstDifference)
+{
+  const char * filename = "/tmp/opentx-golden-test" GOLDEN_EXT;
+
+  memclear(&record, sizeof(record));
+  record.ticks = GOLDEN_TICKS;
+  record.channels = 4;
+  for (int tick=0; tick<GOLDEN_TICKS; tick++) {
+    for (int ch=0; ch<4; ch++) {
+      record.outputs[tick][ch] = tick - 500 + 100*ch;
+    }
+  }
+  ASSERT_EQ(NULL, goldenWrite(filename, record));
+
+  GoldenDiff diff;
+  ASSERT_EQ(NULL, goldenCompare(filename, record, 0, diff));
+  EXPECT_EQ(0u, diff.count);
+  EXPECT_EQ(0, diff.maxDiff);
+
+  record.outputs[10][2] += 3;
+  record.outputs[20][1] -= 1;
+  record.outputs[30][5] = 2; // a channel which was not recorded
+  ASSERT_EQ(NULL, goldenCompare(filename, record, 0, diff));
+  EXPECT_EQ(3u, diff.count);
+  EXPECT_EQ(3, diff.maxDiff);
+  EXPECT_EQ(10, diff.tick);
+  EXPECT_EQ(2, diff.channel);
+  EXPECT_EQ(-290, diff.expected);
+  EXPECT_EQ(-287, diff.actual);
+
+  ASSERT_EQ(NULL, goldenCompare(filename, record, 2, diff));
+  EXPECT_EQ(1u, diff.count);
+  EXPECT_EQ(10, diff.tick);
+
+  record.ticks = 10;
+  EXPECT_STREQ("other ticks count", goldenCompare(filename, record, 0, diff));
+  unlink(filename);
+}
+#endif
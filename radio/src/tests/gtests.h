@@ -38,6 +38,7 @@ inline void MIXER_RESET()
   mixerCurrentFlightMode = lastFlightMode = 0;
   lastAct = 0;
   logicalSwitchesReset();
+  INVALIDATE_MODEL_CACHES();
 }
 
 inline void TELEMETRY_RESET()
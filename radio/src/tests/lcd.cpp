@@ -324,6 +324,100 @@ TEST(Lcd, lcd_vlineStip)
 }
 #endif
 
+#if defined(PCBTARANIS)
+// lcd_filled_rect() done pixel by pixel with lcd_plot()
+void filledRectPixels(coord_t x, coord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags att)
+{
+  for (coord_t i=y; i<y+h; i++) {
+    coord_t x1 = x, x2 = x+w;
+    if ((att&ROUND) && (i==y || i==y+h-1)) {
+      x1++;
+      x2--;
+    }
+    for (coord_t j=x1; j<x2; j++) {
+      if (pat & (1 << ((j-x1) & 7)))
+        lcd_plot(j, i, att);
+    }
+    pat = (pat >> 1) + ((pat & 1) << 7);
+  }
+}
+
+TEST(Lcd, lcd_filled_rect)
+{
+  static const uint8_t patterns[] = { SOLID, DOTTED, 0xEE, 0x81 };
+  static const LcdFlags flags[] = { 0, FORCE, ERASE, ROUND, GREY(5), FORCE|GREY(11), FILL_WHITE|GREY_DEFAULT, ROUND|FILL_WHITE|GREY(12) };
+  static const coord_t rects[][4] = { {0, 0, LCD_W, FH}, {3, 5, 100, 20}, {1, 1, 7, 3}, {-5, -3, 30, 10}, {200, 60, 30, 10} };
+  uint8_t expected[DISPLAY_BUF_SIZE];
+
+  for (unsigned int r=0; r<DIM(rects); r++) {
+    for (unsigned int p=0; p<DIM(patterns); p++) {
+      for (unsigned int f=0; f<DIM(flags); f++) {
+        lcd_clear();
+        lcd_putsAtt(0, 2, "TEST", INVERS);
+        lcd_putsAtt(10, 20, "TEST", DBLSIZE|GREY(7));
+        filledRectPixels(rects[r][0], rects[r][1], rects[r][2], rects[r][3], patterns[p], flags[f]);
+        memcpy(expected, displayBuf, DISPLAY_BUF_SIZE);
+        lcd_clear();
+        lcd_putsAtt(0, 2, "TEST", INVERS);
+        lcd_putsAtt(10, 20, "TEST", DBLSIZE|GREY(7));
+        lcd_filled_rect(rects[r][0], rects[r][1], rects[r][2], rects[r][3], patterns[p], flags[f]);
+        EXPECT_EQ(0, memcmp(expected, displayBuf, DISPLAY_BUF_SIZE)) << "rect " << r << " pattern " << p << " flags " << f;
+      }
+    }
+  }
+}
+#endif
+
+#if defined(PCBTARANIS)
+uint8_t getPixel(const uint8_t * buf, coord_t x, coord_t y)
+{
+  uint8_t b = buf[(y/2)*LCD_W + x];
+  return (y & 1) ? (b >> 4) : (b & 0x0F);
+}
+
+TEST(Lcd, lcdSurface)
+{
+  static const coord_t areas[][4] = { {0, 8, LCD_W, 48}, {5, 9, 40, 14}, {30, 20, 33, 13}, {100, 51, 30, 12}, {190, 55, 40, 20} };
+  static uint8_t surface[LCD_SURFACE_SIZE(LCD_W, LCD_H)];
+  uint8_t background[DISPLAY_BUF_SIZE];
+  uint8_t content[DISPLAY_BUF_SIZE];
+
+  for (unsigned int a=0; a<DIM(areas); a++) {
+    coord_t x = areas[a][0], y = areas[a][1], w = areas[a][2], h = areas[a][3];
+
+    lcd_clear();
+    lcd_rect(x, y, w, h);
+    lcd_putsAtt(x+2, y+2, "ABC", GREY(9));
+    memcpy(content, displayBuf, DISPLAY_BUF_SIZE);
+
+    lcd_clear();
+    lcd_filled_rect(0, 0, LCD_W, LCD_H, DOTTED, GREY(5));
+    lcd_putsAtt(0, 30, "BACKGROUND", DBLSIZE);
+    memcpy(background, displayBuf, DISPLAY_BUF_SIZE);
+
+    // what is drawn inside the surface doesn't touch the screen
+    lcdSurfaceBegin(surface, x, y, w, h);
+    lcd_rect(x, y, w, h);
+    lcd_putsAtt(x+2, y+2, "ABC", GREY(9));
+    lcdSurfaceEnd();
+    EXPECT_EQ(0, memcmp(background, displayBuf, DISPLAY_BUF_SIZE)) << "area " << a;
+
+    lcd_bmp(x, y, surface);
+    for (coord_t j=0; j<LCD_H; j++) {
+      for (coord_t i=0; i<LCD_W; i++) {
+        bool inside = (i >= x && i < x+w && j >= y && j < y+h);
+        if (i >= x && i < x+w && j == y+h && (h & 1)) {
+          // lcd_bmp() draws whole rows, the line below a surface of odd height is cleared
+          EXPECT_EQ(0, getPixel(displayBuf, i, j));
+          continue;
+        }
+        EXPECT_EQ(getPixel(inside ? content : background, i, j), getPixel(displayBuf, i, j)) << "area " << a << " pixel " << i << "," << j;
+      }
+    }
+  }
+}
+#endif
+
 template <int padding> class TestBuffer
 {
 private:
@@ -395,3 +489,49 @@ TEST(Lcd, lcd_bmpLoadAndDisplay)
   }
 }
 #endif
+
+#if defined(PCBTARANIS)
+TEST(Lcd, bmpCache)
+{
+  static const char * const files[] = { "./tests/4b_7x32.bmp", "./tests/1b_6x32.bmp", "./tests/4b_31x31.bmp", "./tests/1b_39x32.bmp" };
+  uint8_t decoded[DIM(files)][BITMAP_BUFFER_SIZE(LCD_W/2, LCD_H)];
+  uint8_t bitmap[BITMAP_BUFFER_SIZE(LCD_W/2, LCD_H)];
+
+  bmpFlushCache();
+  memset(&bmpCacheStats, 0, sizeof(bmpCacheStats));
+  for (unsigned int i=0; i<DIM(files); i++) {
+    EXPECT_EQ((char *)0, bmpLoad(decoded[i], files[i], LCD_W/2, LCD_H));
+  }
+  EXPECT_EQ(0, bmpCacheStats.hits);
+  EXPECT_EQ(DIM(files), bmpCacheStats.misses);
+
+  // cached bitmaps are identical to the decoded ones
+  for (int loop=0; loop<3; loop++) {
+    for (unsigned int i=0; i<DIM(files); i++) {
+      memset(bitmap, 0xA5, sizeof(bitmap));
+      EXPECT_EQ((char *)0, bmpLoad(bitmap, files[i], LCD_W/2, LCD_H));
+      EXPECT_EQ(0, memcmp(decoded[i], bitmap, BITMAP_BUFFER_SIZE(bitmap[0], bitmap[1])));
+    }
+  }
+  EXPECT_EQ(3*DIM(files), bmpCacheStats.hits);
+  EXPECT_EQ(DIM(files), bmpCacheStats.misses);
+
+  // the size is part of the key
+  EXPECT_EQ(STR_INCOMPATIBLE, bmpLoad(bitmap, files[3], 10, 10));
+  EXPECT_EQ(DIM(files)+1, bmpCacheStats.misses);
+
+  // the least recently used bitmaps are evicted when the cache is full
+  for (unsigned int i=1; i<2*BMP_CACHE_ENTRIES; i++) {
+    EXPECT_EQ((char *)0, bmpLoad(bitmap, files[0], LCD_W/2-i, LCD_H));
+    EXPECT_EQ(0, memcmp(decoded[0], bitmap, BITMAP_BUFFER_SIZE(bitmap[0], bitmap[1])));
+  }
+  EXPECT_EQ(BMP_CACHE_ENTRIES + DIM(files) - 1, bmpCacheStats.evictions);
+  EXPECT_EQ((char *)0, bmpLoad(bitmap, files[0], LCD_W/2-2*BMP_CACHE_ENTRIES+1, LCD_H));
+  EXPECT_EQ(3*DIM(files)+1, bmpCacheStats.hits);
+
+  bmpFlushCache();
+  EXPECT_EQ((char *)0, bmpLoad(bitmap, files[1], LCD_W/2, LCD_H));
+  EXPECT_EQ(0, memcmp(decoded[1], bitmap, BITMAP_BUFFER_SIZE(bitmap[0], bitmap[1])));
+  EXPECT_EQ(3*DIM(files)+1, bmpCacheStats.hits);
+}
+#endif
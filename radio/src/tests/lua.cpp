@@ -124,4 +124,86 @@ TEST(Lua, testPanicProtection)
 
   EXPECT_EQ(passed, true);
 }
+
+TEST(Lua, testLcdSurface)
+{
+  extern bool luaLcdAllowed;
+  luaLcdAllowed = true;
+
+  lcd_clear();
+  lcd_putsAtt(10, 10, "Surface", DBLSIZE);
+  uint8_t expected[DISPLAY_BUF_SIZE];
+  memcpy(expected, displayBuf, DISPLAY_BUF_SIZE);
+
+  lcd_clear();
+  luaExecStr("s = lcd.createSurface(100, 20)");
+  luaExecStr("lcd.beginSurface(s, 10, 10); lcd.drawText(10, 10, 'Surface', DBLSIZE); lcd.endSurface()");
+  for (int i=0; i<DISPLAY_BUF_SIZE; i++) {
+    ASSERT_EQ(0, displayBuf[i]);
+  }
+  luaExecStr("lcd.drawSurface(10, 10, s)");
+  EXPECT_EQ(0, memcmp(expected, displayBuf, DISPLAY_BUF_SIZE));
+
+  // the surface being rendered is kept, even when the script doesn't
+  lcd_clear();
+  luaExecStr("lcd.beginSurface(lcd.createSurface(100, 20), 10, 10); collectgarbage(); lcd.drawText(10, 10, 'Surface', DBLSIZE); lcd.endSurface()");
+  for (int i=0; i<DISPLAY_BUF_SIZE; i++) {
+    ASSERT_EQ(0, displayBuf[i]);
+  }
+
+  luaExecStr("if pcall(lcd.drawSurface, 10, 10, 'x') then error('not a surface') end");
+}
+
+static double luaGetGlobalNumber(const char * name)
+{
+  extern lua_State * L;
+  lua_getglobal(L, name);
+  double result = lua_tonumber(L, -1);
+  lua_pop(L, 1);
+  return result;
+}
+
+TEST(Lua, getValueHistory)
+{
+  memclear(&g_model, sizeof(g_model));
+  telemetryReset();
+  g_tmr10ms = 0;
+  g_model.telemetrySensors[0].init("Alt", UNIT_METERS, 1);
+
+  char script[32];
+  sprintf(script, "src = %d", MIXSRC_FIRST_TELEM);
+  luaExecStr(script);
+
+  // the history is recorded from the first request
+  luaExecStr("a = getValue(src, 'avg')");
+  luaExecStr("nothing = (a == nil) and 1 or 0");
+  EXPECT_EQ(1, luaGetGlobalNumber("nothing"));
+  EXPECT_NE(0, telemetryHistorySlots[0]);
+
+  // one value per period, 1m more each time
+  for (int i=0; i<=8; i++) {
+    g_tmr10ms = i * TELEMETRY_HISTORY_PERIOD;
+    telemetryItems[0].setValue(g_model.telemetrySensors[0], i*10, UNIT_METERS, 1);
+  }
+  luaExecStr("a = getValue(src, 'avg'); s = getValue(src, 'slope'); p = getValue(src, 'p50')");
+  luaExecStr("t = getValue(src, 'samples'); count = #t; first = t[1]; last = t[#t]");
+  EXPECT_EQ(3.5, luaGetGlobalNumber("a"));
+  EXPECT_EQ(5.0, luaGetGlobalNumber("s"));
+  EXPECT_EQ(4.0, luaGetGlobalNumber("p"));
+  EXPECT_EQ(8, luaGetGlobalNumber("count"));
+  EXPECT_EQ(0.0, luaGetGlobalNumber("first"));
+  EXPECT_EQ(7.0, luaGetGlobalNumber("last"));
+
+  // percentiles are 0..100
+  luaExecStr("p = getValue(src, 'p100'); ok = pcall(getValue, src, 'p300') and 1 or 0");
+  EXPECT_EQ(7.0, luaGetGlobalNumber("p"));
+  EXPECT_EQ(0, luaGetGlobalNumber("ok"));
+
+  // a sensor which isn't configured has no history
+  sprintf(script, "a = getValue(%d, 'avg')", MIXSRC_FIRST_TELEM+3);
+  luaExecStr(script);
+  luaExecStr("nothing = (a == nil) and 1 or 0");
+  EXPECT_EQ(1, luaGetGlobalNumber("nothing"));
+  EXPECT_EQ(0, telemetryHistorySlots[1]);
+}
 #endif
@@ -0,0 +1,116 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(MAVLINK)
+static int mavlinkBuildStream(uint8_t * buffer)
+{
+  mavlink_message_t msg;
+  int len = 0;
+
+  // the pack functions take the sequence numbers from the channel status
+  mavlink_get_channel_status(MAVLINK_COMM_0)->current_tx_seq = 0;
+
+  mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_MODE_FLAG_SAFETY_ARMED, 5, MAV_STATE_ACTIVE);
+  len += mavlink_msg_to_send_buffer(&buffer[len], &msg);
+  mavlink_msg_sys_status_pack(1, 1, &msg, 0, 0, 0, 500, 12600, 1530, 87, 0, 0, 0, 0, 0, 0);
+  len += mavlink_msg_to_send_buffer(&buffer[len], &msg);
+  mavlink_msg_attitude_pack(1, 1, &msg, 1000, 0.1, 0.2, 0.3, 0, 0, 0);
+  len += mavlink_msg_to_send_buffer(&buffer[len], &msg);
+  mavlink_msg_gps_raw_int_pack(1, 1, &msg, 0, 3, 457000000, 67000000, 512000, 150, 0, 1234, 9000, 11);
+  len += mavlink_msg_to_send_buffer(&buffer[len], &msg);
+  mavlink_msg_vfr_hud_pack(1, 1, &msg, 10.0, 12.0, 270, 50, 123.0, 0.5);
+  len += mavlink_msg_to_send_buffer(&buffer[len], &msg);
+  return len;
+}
+
+TEST(Mavlink, parseBlocks)
+{
+  uint8_t stream[512];
+  int len = mavlinkBuildStream(stream);
+
+  static const int blockSizes[] = { 1, 2, 7, 64, 512 };
+  for (unsigned int i=0; i<DIM(blockSizes); i++) {
+    MAVLINK_Init();
+    memclear(&mavlinkStats, sizeof(mavlinkStats));
+    for (int j=0; j<len; j+=blockSizes[i]) {
+      MAVLINK_parse(&stream[j], min<int>(blockSizes[i], len-j));
+    }
+    EXPECT_EQ(5, mavlinkStats.frames) << "block size " << blockSizes[i];
+    EXPECT_EQ(0, mavlinkStats.crcErrors);
+    EXPECT_EQ(1, mavlinkStats.unhandled);
+    EXPECT_EQ(MAVLINK_ARDUCOPTER, telemetry_data.type_autopilot);
+    EXPECT_TRUE(telemetry_data.active);
+    EXPECT_EQ(126, telemetry_data.vbat);
+    EXPECT_EQ(153, telemetry_data.ibat);
+    EXPECT_EQ(87, telemetry_data.rem_bat);
+    EXPECT_EQ(3, telemetry_data.fix_type);
+    EXPECT_EQ(11, telemetry_data.satellites_visible);
+    EXPECT_FLOAT_EQ(45.7, telemetry_data.loc_current.lat);
+    EXPECT_EQ(90, telemetry_data.course);
+    EXPECT_EQ(270, telemetry_data.heading);
+    EXPECT_FLOAT_EQ(123.0, telemetry_data.loc_current.rel_alt);
+  }
+  EXPECT_EQ(0, MAVLINK_getMsgCount(MAVLINK_MSG_ID_ATTITUDE));
+  EXPECT_NE(0, MAVLINK_getMsgCount(MAVLINK_MSG_ID_GPS_RAW_INT));
+}
+
+TEST(Mavlink, errors)
+{
+  uint8_t stream[512];
+  int len = mavlinkBuildStream(stream);
+
+  // garbage and a corrupted frame, the next frames are still decoded
+  uint8_t corrupted[512+4] = { 0x00, 0x12, 0x34, 0x56 };
+  memcpy(&corrupted[4], stream, len);
+  corrupted[4+20] ^= 0x01; // sys_status header
+  MAVLINK_Init();
+  memclear(&mavlinkStats, sizeof(mavlinkStats));
+  MAVLINK_parse(corrupted, len+4);
+  EXPECT_EQ(1, mavlinkStats.crcErrors);
+  EXPECT_EQ(4, mavlinkStats.frames);
+  EXPECT_EQ(3, telemetry_data.fix_type);
+
+  // sequence numbers 0..4, then the same stream again starting at 0
+  MAVLINK_Init();
+  memclear(&mavlinkStats, sizeof(mavlinkStats));
+  MAVLINK_parse(stream, len);
+  EXPECT_EQ(0, mavlinkStats.lost);
+  MAVLINK_parse(stream, len);
+  EXPECT_EQ(251, mavlinkStats.lost);
+}
+#endif
@@ -639,6 +639,460 @@ TEST(Mixer, RecursiveAddChannelAfterInactivePhase)
   EXPECT_EQ(chans[1], CHANNEL_MAX);
 }
 
+#if defined(PCBTARANIS)
+TEST(Mixer, flightModesFadeSharedWork)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  modelDefault(0);
+  s_mixer_first_run_done = true;
+
+  g_model.flightModeData[1].swtch = SWSRC_SA0;
+  g_model.flightModeData[0].trim[ELE_STICK].value = 40;
+  g_model.flightModeData[1].trim[ELE_STICK].mode = 2; // own trim
+  g_model.flightModeData[1].trim[ELE_STICK].value = -60;
+  g_model.flightModeData[0].trim[THR_STICK].value = -30;
+  g_model.flightModeData[1].trim[THR_STICK].mode = 2;
+  g_model.flightModeData[1].trim[THR_STICK].value = 50;
+  g_model.flightModeData[0].gvars[0] = 80;
+  g_model.flightModeData[1].gvars[0] = 30;
+  g_model.flightModeData[0].gvars[1] = 40;
+  g_model.flightModeData[1].gvars[1] = -20;
+
+  g_model.points[0] = -100;
+  g_model.points[1] = -50;
+  g_model.points[2] = 0;
+  g_model.points[3] = 60;
+  g_model.points[4] = 100;
+
+  // I1 with a curve, shared by the flight modes, I2 with a GV2 expo
+  g_model.expoData[0].curve.type = CURVE_REF_CUSTOM;
+  g_model.expoData[0].curve.value = 1;
+  g_model.expoData[1].curve.type = CURVE_REF_EXPO;
+  g_model.expoData[1].curve.value = -127; // GV2
+
+  // CH5: S1 with a curve and no trim
+  g_model.mixData[4].destCh = 4;
+  g_model.mixData[4].srcRaw = MIXSRC_POT1;
+  g_model.mixData[4].weight = 100;
+  g_model.mixData[4].carryTrim = 1;
+  g_model.mixData[4].curve.type = CURVE_REF_CUSTOM;
+  g_model.mixData[4].curve.value = 1;
+  // CH6: I1 with a GV1 weight
+  g_model.mixData[5].destCh = 5;
+  g_model.mixData[5].srcRaw = MIXSRC_FIRST_INPUT;
+  g_model.mixData[5].weight = 1024; // GV1
+  g_model.mixData[5].carryTrim = 1;
+  // CH7: MAX in flight mode 0 only + SA
+  g_model.mixData[6].destCh = 6;
+  g_model.mixData[6].srcRaw = MIXSRC_MAX;
+  g_model.mixData[6].weight = 50;
+  g_model.mixData[6].flightModes = 0b10;
+  g_model.mixData[7].destCh = 6;
+  g_model.mixData[7].srcRaw = MIXSRC_SA;
+  g_model.mixData[7].weight = 30;
+  g_model.mixData[7].curve.type = CURVE_REF_FUNC;
+  g_model.mixData[7].curve.value = CURVE_ABS_X;
+  // CH8: CH1 + Thr stick with a curve and its trim
+  g_model.mixData[8].destCh = 7;
+  g_model.mixData[8].srcRaw = MIXSRC_CH1;
+  g_model.mixData[8].weight = 50;
+  g_model.mixData[9].destCh = 7;
+  g_model.mixData[9].srcRaw = MIXSRC_Thr;
+  g_model.mixData[9].weight = 50;
+  g_model.mixData[9].offset = 10;
+  g_model.mixData[9].curve.type = CURVE_REF_CUSTOM;
+  g_model.mixData[9].curve.value = 1;
+
+  // flight mode 1 then 0 without fade, the weights are 0 and MAX_ACT
+  simuSetSwitch(0, -1);
+  evalMixes(1);
+  simuSetSwitch(0, 1);
+  evalMixes(1);
+  EXPECT_EQ(0, getFlightMode());
+
+  g_model.flightModeData[1].fadeIn = 10;
+  simuSetSwitch(0, -1);
+  EXPECT_EQ(1, getFlightMode());
+
+  uint16_t delta = (0xffff / (100/SLOW_STEP)) / 10;
+  for (int cycle=0; cycle<20; cycle++) {
+    for (int i=0; i<NUM_STICKS+NUM_POTS; i++) {
+      anaInValues[i] = ((cycle * 97 + i * 211) % 2048) - 1024;
+    }
+
+    // each flight mode evaluated alone
+    int32_t modeChans[2][NUM_CHNOUT];
+    for (int p=0; p<2; p++) {
+      mixerCurrentFlightMode = p;
+      evalFlightModeMixes(p == 1 ? e_perout_mode_normal : e_perout_mode_inactive_flight_mode, 0);
+      memcpy(modeChans[p], chans, sizeof(chans));
+    }
+
+    evalMixes(1);
+
+    uint16_t act[2] = { (uint16_t)(0xffff - cycle*delta), (uint16_t)(cycle*delta) };
+    uint32_t weight = act[0] + act[1];
+    for (int i=0; i<NUM_CHNOUT; i++) {
+      int32_t q = 0;
+      for (int p=0; p<2; p++) {
+        q += ((int64_t)modeChans[p][i] * ((((uint32_t)act[p] << 16) + weight/2) / weight)) >> 16;
+      }
+      EXPECT_EQ(q / 256, ex_chans[i]) << "cycle " << cycle << " channel " << i;
+    }
+  }
+}
+#endif
+
+#if defined(CPUARM)
+TEST(Inputs, CalibrationMatchesDivision)
+{
+  for (int16_t span=0; span<2048; span++) {
+    uint32_t mul = calibrationMultiplier(span);
+    for (int32_t v=-2047; v<=2047; v++) {
+      int32_t expected = v * (int32_t)RESX / max((int16_t)100, span);
+      if (applyCalibration(v, mul) != expected) {
+        FAIL() << "span " << span << " value " << v;
+      }
+    }
+  }
+}
+
+TEST(Inputs, CalibrationFollowsStickMode)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  MIXER_RESET();
+  for (int i=0; i<NUM_STICKS; i++) {
+    anaInValues[i] = 100 * (i + 1);
+  }
+
+  for (int mode=0; mode<4; mode++) {
+    stickMode = mode;
+    evalInputs(e_perout_mode_normal);
+    for (int i=0; i<NUM_STICKS; i++) {
+      EXPECT_EQ(CONVERT_MODE(i), inputsCalibration.channel[i]);
+      EXPECT_EQ(100 * (i + 1), calibratedStick[CONVERT_MODE(i)]) << "mode " << mode << " stick " << i;
+    }
+  }
+
+  stickMode = 0;
+}
+
+TEST(Inputs, AnalogFilter)
+{
+  uint32_t state = 1000 << ANALOG_FILTER_SHIFT;
+  EXPECT_EQ(1000, filterAnalog(state, 1000));
+
+  // a small step is halfway after one sample, then the exact value is reached
+  EXPECT_EQ(1100, filterAnalog(state, 1200));
+  for (int i=0; i<20; i++) {
+    filterAnalog(state, 1200);
+  }
+  EXPECT_EQ(1200, filterAnalog(state, 1200));
+  for (int i=0; i<20; i++) {
+    filterAnalog(state, 1000);
+  }
+  EXPECT_EQ(1000, filterAnalog(state, 1000));
+
+  // a stick move is not delayed
+  EXPECT_EQ(2000, filterAnalog(state, 2000));
+  EXPECT_EQ(1000, filterAnalog(state, 1000));
+
+  // the noise is attenuated
+  for (int i=0; i<20; i++) {
+    EXPECT_NEAR(1000, filterAnalog(state, (i & 1) ? 984 : 1016), 8);
+  }
+}
+#endif
+
+#if defined(CPUARM)
+TEST(Mixer, OutputStagesMatchLimits)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+#if defined(PCBTARANIS)
+  g_model.points[0] = -100;
+  g_model.points[1] = -20;
+  g_model.points[2] = 0;
+  g_model.points[3] = 70;
+  g_model.points[4] = 100;
+#endif
+  for (int i=0; i<NUM_CHNOUT; i++) {
+    LimitData * lim = limitAddress(i);
+#if defined(PCBTARANIS)
+    lim->min = (i * 97) % 700 - 200;
+    lim->max = 200 - (i * 61) % 700;
+    lim->curve = (i % 3) - 1;
+#else
+    lim->min = (i * 7) % 50 - 20;
+    lim->max = 20 - (i * 11) % 50;
+#endif
+    lim->offset = (i * 373) % 1800 - 900;
+    lim->symetrical = (i / 2) % 2;
+    lim->revert = i % 2;
+  }
+
+  compileOutputStages();
+  for (int i=0; i<NUM_CHNOUT; i++) {
+    for (int32_t value=-2*RESXl*256; value<=2*RESXl*256; value+=997) {
+      EXPECT_NEAR(applyLimits(i, value), applyOutputStage(i, value), 1) << "channel " << i << " value " << value;
+    }
+    EXPECT_EQ(applyLimits(i, 0), applyOutputStage(i, 0));
+    EXPECT_EQ(applyLimits(i, -RESXl*256), applyOutputStage(i, -RESXl*256));
+    EXPECT_EQ(applyLimits(i, RESXl*256), applyOutputStage(i, RESXl*256));
+  }
+}
+
+TEST(Mixer, OutputStagesPrecision)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  for (int i=0; i<NUM_CHNOUT; i++) {
+    LimitData * lim = limitAddress(i);
+    lim->min = (i * 7) % 50 - 20;
+    lim->max = 20 - (i * 11) % 50;
+    lim->offset = (i * 373) % 1800 - 900;
+    lim->revert = i % 2;
+  }
+
+  compileOutputStages();
+  double stageError = 0, limitsError = 0;
+  for (int i=0; i<NUM_CHNOUT; i++) {
+    LimitData * lim = limitAddress(i);
+    int ofs = limit<int>(LIMIT_MIN_RESX(lim), LIMIT_OFS_RESX(lim), LIMIT_MAX_RESX(lim));
+    for (int32_t value=-RESXl*256; value<=RESXl*256; value+=331) {
+      double scale = (value > 0 ? LIMIT_MAX_RESX(lim) - ofs : -LIMIT_MIN_RESX(lim) + ofs);
+      double exact = limit<double>(LIMIT_MIN_RESX(lim), ofs + value * scale / (RESXl*256), LIMIT_MAX_RESX(lim));
+      if (lim->revert) exact = -exact;
+      stageError = max(stageError, abs(applyOutputStage(i, value) - exact));
+      limitsError = max(limitsError, abs(applyLimits(i, value) - exact));
+    }
+  }
+  EXPECT_LE(stageError, 0.5);
+  EXPECT_LT(stageError, limitsError);
+}
+
+TEST(Mixer, FixedPointWeightPrecision)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 33;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_MAX;
+  g_model.mixData[1].weight = 50;
+  g_model.mixData[2].destCh = 1;
+  g_model.mixData[2].srcRaw = MIXSRC_MAX;
+  g_model.mixData[2].weight = 33;
+  g_model.mixData[2].mltpx = MLTPX_MUL;
+  evalMixes(1);
+  EXPECT_EQ(channelOutputs[0], 338);  // 1024 * 33% = 337.92
+  EXPECT_EQ(channelOutputs[1], 169);  // 1024 * 50% * 33% = 168.96
+}
+
+TEST(Mixer, FixedPointFadeHeadroom)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 300;
+#if defined(PCBTARANIS)
+  g_model.flightModeData[1].swtch = SWSRC_SA0;
+  simuSetSwitch(0, 0);
+#else
+  g_model.flightModeData[1].swtch = SWSRC_THR;
+  simuSetSwitch(0, 0);
+#endif
+  g_model.flightModeData[1].fadeIn = 10;
+  evalMixes(1);
+  EXPECT_EQ(ex_chans[0], 3072);
+
+#if defined(PCBTARANIS)
+  simuSetSwitch(0, -1);
+#else
+  simuSetSwitch(0, 1);
+#endif
+  for (int cycle=0; cycle<10; cycle++) {
+    evalMixes(1);
+    EXPECT_EQ(ex_chans[0], 3072) << "cycle " << cycle;
+    EXPECT_EQ(channelOutputs[0], 1024) << "cycle " << cycle;
+  }
+
+  // three flight modes fading from MAX_ACT, the summed weights are above 0x20000
+#if defined(PCBTARANIS)
+  const int8_t fmSwitches[] = { SWSRC_SA0, SWSRC_SB0, SWSRC_SC0, SWSRC_SD0, SWSRC_SE0 };
+  const uint8_t fmSimuSwitches[] = { 0, 1, 2, 3, 4 };
+  #define FM_SWITCH_ON  -1
+  #define FM_SWITCH_OFF 1
+#else
+  const int8_t fmSwitches[] = { SWSRC_THR, SWSRC_RUD, SWSRC_ELE, SWSRC_AIL, SWSRC_GEA };
+  const uint8_t fmSimuSwitches[] = { 0, 1, 2, 4, 5 };
+  #define FM_SWITCH_ON  1
+  #define FM_SWITCH_OFF 0
+#endif
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  for (int i=0; i<5; i++) {
+    g_model.flightModeData[i+1].swtch = fmSwitches[i];
+    simuSetSwitch(fmSimuSwitches[i], FM_SWITCH_OFF);
+  }
+  // FM0 -> FM1 and FM2 -> FM3 are slow fades, FM1 -> FM2 and FM3 -> FM4 are
+  // immediate and leave FM0 and FM2 fading, FM4 -> FM5 adds FM4
+  g_model.flightModeData[1].fadeIn = 100;
+  g_model.flightModeData[3].fadeIn = 100;
+  g_model.flightModeData[5].fadeIn = 100;
+  evalMixes(1);
+  EXPECT_EQ(ex_chans[0], 1024);
+  for (int fm=1; fm<=5; fm++) {
+    if (fm > 1) simuSetSwitch(fmSimuSwitches[fm-2], FM_SWITCH_OFF);
+    simuSetSwitch(fmSimuSwitches[fm-1], FM_SWITCH_ON);
+    for (int cycle=0; cycle<3; cycle++) {
+      evalMixes(1);
+      EXPECT_EQ(fm, getFlightMode());
+      EXPECT_NEAR(ex_chans[0], 1024, 1) << "FM" << fm << " cycle " << cycle;
+    }
+  }
+}
+
+TEST(Mixer, OutputStagesRecompiledOnModelChange)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  g_model.limitData[1].offset = 100;
+
+  evalMixes(1);
+  EXPECT_EQ(channelOutputs[0], 1024);
+  EXPECT_EQ(channelOutputs[1], 102);
+
+  g_model.limitData[0].revert = 1;
+  g_model.limitData[1].revert = 1;
+  eeDirty(EE_MODEL);
+  evalMixes(1);
+  EXPECT_EQ(channelOutputs[0], -1024);
+  EXPECT_EQ(channelOutputs[1], -102);
+}
+#endif
+
+#if defined(PCBTARANIS) && defined(LUA_MODEL_SCRIPTS)
+TEST(Mixer, LastScriptOutputSource)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  scriptInputsOutputs[MAX_SCRIPTS-1].outputs[MAX_SCRIPT_OUTPUTS-1].value = 123;
+  EXPECT_EQ(123, getValue(MIXSRC_LAST_LUA));
+  scriptInputsOutputs[MAX_SCRIPTS-1].outputs[MAX_SCRIPT_OUTPUTS-1].value = 0;
+}
+#endif
+
+#if defined(CPUARM) && defined(GVARS)
+TEST(Mixer, GVarsResolvedPerFlightMode)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = GV1_LARGE; // GV1
+  g_model.flightModeData[0].gvars[0] = 50;
+  g_model.flightModeData[1].gvars[0] = GVAR_MAX+1; // FM1 uses the FM0 value
+  g_model.flightModeData[2].gvars[0] = 25;
+
+  mixerCurrentFlightMode = 1;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/2);
+  mixerCurrentFlightMode = 2;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/4);
+
+  // the adjust GVar function writes the inherited value in FM0
+  setGVarValue(0, 100, 1);
+  EXPECT_EQ(100, g_model.flightModeData[0].gvars[0]);
+  mixerCurrentFlightMode = 1;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX);
+
+  // an edit in the model menus
+  g_model.flightModeData[1].gvars[0] = -50;
+  eeDirty(EE_MODEL);
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], -CHANNEL_MAX/2);
+  mixerCurrentFlightMode = 0;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX);
+
+  // checkIncDec() calls eeDirty() before the menu stores the value,
+  // the mixer may rebuild the table in between
+  eeDirty(EE_MODEL);
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  g_model.flightModeData[0].gvars[0] = 50;
+  COMMIT_MODEL_CACHES();
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(chans[0], CHANNEL_MAX/2);
+}
+
+TEST(Mixer, GVarWriteKeepsOtherCaches)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  COMMIT_MODEL_CACHES();
+
+  uint32_t gvars = MODEL_CACHE_VERSION(MODEL_CACHE_GVARS);
+  uint32_t outputs = MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS);
+  uint32_t functions = MODEL_CACHE_VERSION(MODEL_CACHE_FUNCTIONS);
+  uint32_t calibration = MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION);
+  uint32_t timers = MODEL_CACHE_VERSION(MODEL_CACHE_TIMERS);
+
+  // the adjust GVar function, from the mixer task
+  setGVarValue(0, 10, 0);
+  COMMIT_MODEL_CACHES();
+  EXPECT_NE(gvars, MODEL_CACHE_VERSION(MODEL_CACHE_GVARS));
+  EXPECT_EQ(outputs, MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS));
+  EXPECT_EQ(functions, MODEL_CACHE_VERSION(MODEL_CACHE_FUNCTIONS));
+  EXPECT_EQ(calibration, MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION));
+  EXPECT_EQ(timers, MODEL_CACHE_VERSION(MODEL_CACHE_TIMERS));
+
+  // a model edit keeps the calibration, a radio settings edit keeps the limits
+  eeDirty(EE_MODEL);
+  COMMIT_MODEL_CACHES();
+  EXPECT_NE(outputs, MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS));
+  EXPECT_EQ(calibration, MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION));
+  outputs = MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS);
+  eeDirty(EE_GENERAL);
+  COMMIT_MODEL_CACHES();
+  EXPECT_EQ(outputs, MODEL_CACHE_VERSION(MODEL_CACHE_OUTPUTS));
+  EXPECT_NE(calibration, MODEL_CACHE_VERSION(MODEL_CACHE_CALIBRATION));
+}
+
+#if defined(PCBTARANIS)
+TEST(Mixer, GVarLimitFollowsGVarWrites)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].mltpx = MLTPX_ADD;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  g_model.limitData[0].max = GV1_LARGE; // GV1
+  g_model.flightModeData[0].gvars[0] = 50;
+  evalMixes(1);
+  EXPECT_EQ(channelOutputs[0], 512);
+
+  // only the GVars version changes, the output stages are rebuilt anyway
+  setGVarValue(0, 25, 0);
+  evalMixes(1);
+  EXPECT_EQ(channelOutputs[0], 256);
+}
+#endif
+#endif
+
 #if !defined(CPUARM)
 TEST(Mixer, SlowOnSwitch)
 {
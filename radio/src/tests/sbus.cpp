@@ -0,0 +1,242 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(PCBTARANIS)
+extern Fifo<32> sbusFifo;
+extern uint8_t SbusIndex;
+extern uint16_t SbusTimer;
+extern bool SbusFrameStart;
+
+static void sbusBuildFrame(uint8_t * frame, const uint16_t * channels, uint8_t flags, uint8_t end=0x00)
+{
+  memclear(frame, 25);
+  frame[0] = 0x0F;
+  for (int i=0; i<16*11; i++) {
+    if (channels[i/11] & (1 << (i%11)))
+      frame[1+i/8] |= 1 << (i%8);
+  }
+  frame[23] = flags;
+  frame[24] = end;
+}
+
+static void sbusReset(bool idle=true)
+{
+  memclear(&sbusStats, sizeof(sbusStats));
+  memclear(g_ppmIns, sizeof(g_ppmIns));
+  SbusIndex = 0;
+  SbusFrameStart = idle;
+  ppmInValid = 0;
+}
+
+// no byte received for 1ms
+static void sbusGap()
+{
+  TIM7->CNT = SbusTimer + 2000;
+  processSbusInput();
+}
+
+static void sbusCheckChannels(const uint16_t * channels)
+{
+  for (int i=0; i<NUM_TRAINER; i++) {
+    EXPECT_EQ((channels[i] - 0x3E0) * 5 / 8, g_ppmIns[i]) << "channel " << i;
+  }
+}
+
+TEST(Sbus, unpackBlocks)
+{
+  uint16_t channels[16];
+  uint8_t frames[2*25];
+  for (int i=0; i<16; i++) {
+    channels[i] = 172 + i*107;
+  }
+  sbusBuildFrame(&frames[0], channels, 0);
+  channels[0] = 0x7FF; channels[15] = 0;
+  sbusBuildFrame(&frames[25], channels, 0, 0x14); // S.BUS2 end byte
+
+  static const int blockSizes[] = { 1, 5, 24, 25, 50 };
+  for (unsigned int b=0; b<DIM(blockSizes); b++) {
+    sbusReset();
+    for (int i=0; i<50; i+=blockSizes[b]) {
+      processSbusData(&frames[i], min<int>(blockSizes[b], 50-i));
+    }
+    EXPECT_EQ(2u, sbusStats.frames) << "block size " << blockSizes[b];
+    EXPECT_EQ(0u, sbusStats.errors);
+    EXPECT_NE(0, ppmInValid);
+    sbusCheckChannels(channels);
+  }
+}
+
+TEST(Sbus, resync)
+{
+  uint16_t channels[16];
+  uint8_t frame[25];
+  for (int i=0; i<16; i++) {
+    channels[i] = 992 + i*20;
+  }
+  sbusBuildFrame(frame, channels, 0);
+
+  // garbage before the gap and the frame
+  sbusReset();
+  static const uint8_t garbage[] = { 0x12, 0x00, 0xFF };
+  processSbusData(garbage, sizeof(garbage));
+  sbusGap();
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.errors);
+  EXPECT_EQ(1u, sbusStats.frames);
+  sbusCheckChannels(channels);
+
+  // truncated frame followed by good ones: the end byte check fails, the
+  // decoder restarts after the next gap
+  sbusReset();
+  processSbusData(frame, 12);
+  processSbusData(frame, sizeof(frame));
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.errors);
+  EXPECT_EQ(0u, sbusStats.frames);
+  sbusGap();
+  processSbusData(frame, sizeof(frame));
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.errors);
+  EXPECT_EQ(2u, sbusStats.frames);
+  sbusCheckChannels(channels);
+}
+
+TEST(Sbus, streamStartingMidFrame)
+{
+  uint16_t channels[16];
+  uint8_t frame[25];
+  for (int i=0; i<16; i++) {
+    channels[i] = 992 + i*20;
+  }
+  sbusBuildFrame(frame, channels, 0);
+  // channels data which looks like a start byte, with an end byte 25 bytes later
+  frame[2] = 0x04;
+  frame[3] = 0x0F;
+
+  sbusReset();
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.frames);
+  int16_t expected[NUM_TRAINER];
+  memcpy(expected, g_ppmIns, sizeof(expected));
+
+  // the receiver was already sending, the stream starts on the data 0x0F
+  uint8_t stream[22+2*25];
+  memcpy(&stream[0], &frame[3], 22);
+  memcpy(&stream[22], frame, 25);
+  memcpy(&stream[47], frame, 25);
+  sbusReset(false);
+  processSbusData(stream, sizeof(stream));
+  EXPECT_EQ(0u, sbusStats.frames);
+  EXPECT_EQ(0, ppmInValid);
+  sbusGap();
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.frames);
+  EXPECT_EQ(0u, sbusStats.errors);
+  EXPECT_EQ(0, memcmp(expected, g_ppmIns, sizeof(expected)));
+
+  // a bad end byte, the data 0x0F is not taken for the next frame start
+  uint8_t bad[25];
+  memcpy(bad, frame, sizeof(bad));
+  bad[24] = 0xFF;
+  sbusReset();
+  processSbusData(bad, sizeof(bad));
+  processSbusData(frame, sizeof(frame));
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(0u, sbusStats.frames);
+  EXPECT_EQ(1u, sbusStats.errors);
+
+  // a partial frame is only decoded when it started after a gap
+  sbusReset(false);
+  processSbusData(&frame[3], 22);
+  sbusGap();
+  EXPECT_EQ(0u, sbusStats.frames);
+  processSbusData(frame, 23);
+  sbusGap();
+  EXPECT_EQ(1u, sbusStats.frames);
+}
+
+TEST(Sbus, flags)
+{
+  uint16_t channels[16];
+  uint8_t frame[25];
+  for (int i=0; i<16; i++) {
+    channels[i] = 1500;
+  }
+
+  sbusReset();
+  sbusBuildFrame(frame, channels, 0x04);
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(1u, sbusStats.frames);
+  EXPECT_EQ(1u, sbusStats.lostFrames);
+  sbusCheckChannels(channels);
+
+  sbusReset();
+  sbusBuildFrame(frame, channels, 0x08);
+  processSbusData(frame, sizeof(frame));
+  EXPECT_EQ(0u, sbusStats.frames);
+  EXPECT_EQ(1u, sbusStats.failsafes);
+  EXPECT_EQ(0, ppmInValid);
+  EXPECT_EQ(0, g_ppmIns[0]);
+}
+
+TEST(Sbus, shortFrameTimeout)
+{
+  uint16_t channels[16];
+  uint8_t frame[25];
+  for (int i=0; i<16; i++) {
+    channels[i] = 300 + i;
+  }
+  sbusBuildFrame(frame, channels, 0);
+
+  // 23 bytes, no flags and no end byte: decoded after the gap
+  sbusReset();
+  TIM7->CNT = 0;
+  for (int i=0; i<23; i++) {
+    sbusFifo.push(frame[i]);
+  }
+  processSbusInput();
+  EXPECT_EQ(0u, sbusStats.frames);
+  TIM7->CNT = 500;
+  processSbusInput();
+  EXPECT_EQ(0u, sbusStats.frames);
+  TIM7->CNT = 1500;
+  processSbusInput();
+  EXPECT_EQ(1u, sbusStats.frames);
+  sbusCheckChannels(channels);
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(CPUARM) && defined(SDCARD)
+void fillSector(uint8_t * buff, uint32_t sector, uint8_t version)
+{
+  for (int i=0; i<512; i++) {
+    buff[i] = sector + version + i;
+  }
+}
+
+TEST(SdCard, sectorCache)
+{
+  uint8_t sector[512], expected[512];
+  sdCacheFlush();
+  memset(&sdStats, 0, sizeof(sdStats));
+
+  for (uint32_t i=0; i<SD_CACHE_SECTORS; i++) {
+    EXPECT_FALSE(sdCacheRead(sector, 100+i));
+    fillSector(sector, 100+i, 0);
+    sdCacheStore(sector, 100+i);
+  }
+  EXPECT_EQ((uint32_t)SD_CACHE_SECTORS, sdStats.cacheMisses);
+
+  for (uint32_t i=0; i<SD_CACHE_SECTORS; i++) {
+    EXPECT_TRUE(sdCacheRead(sector, 100+i));
+    fillSector(expected, 100+i, 0);
+    EXPECT_EQ(0, memcmp(expected, sector, 512));
+  }
+  EXPECT_EQ((uint32_t)SD_CACHE_SECTORS, sdStats.cacheHits);
+
+  // the least recently used sector (the first one read above) is replaced
+  fillSector(sector, 200, 0);
+  sdCacheStore(sector, 200);
+  EXPECT_FALSE(sdCacheRead(sector, 100));
+  EXPECT_TRUE(sdCacheRead(sector, 101));
+  EXPECT_TRUE(sdCacheRead(sector, 200));
+
+  // write-through of multiple sectors
+  uint8_t sectors[3*512];
+  for (int i=0; i<3; i++) {
+    fillSector(&sectors[i*512], 200+i, 1);
+  }
+  sdCacheWrite(sectors, 199, 3);
+  EXPECT_TRUE(sdCacheRead(sector, 200));
+  EXPECT_EQ(0, memcmp(&sectors[512], sector, 512));
+  EXPECT_FALSE(sdCacheRead(sector, 199));
+
+  sdCacheFlush();
+  EXPECT_FALSE(sdCacheRead(sector, 200));
+}
+
+TEST(SdCard, stats)
+{
+  memset(&sdStats, 0, sizeof(sdStats));
+  sdStatsRead(8, 2000);
+  sdStatsRead(1, 500);
+  sdStatsWrite(2, 3000);
+  EXPECT_EQ(9u, sdStats.readSectors);
+  EXPECT_EQ(2500u, sdStats.readTime);
+  EXPECT_EQ(2000u, sdStats.readMaxTime);
+  EXPECT_EQ(2u, sdStats.writeSectors);
+  EXPECT_EQ(3000u, sdStats.writeMaxTime);
+
+  // longer than the 2MHz timer period
+  sdStatsWrite(1, 100000);
+  EXPECT_EQ(100000u, sdStats.writeMaxTime);
+}
+
+TEST(SdCard, statsDuration)
+{
+  // the 2MHz timer wrapped between two 10ms ticks
+  EXPECT_EQ(0x1000u, sdStatsDuration((100 << 16) + 0xF800, (101 << 16) + 0x0800));
+  EXPECT_EQ(40000u, sdStatsDuration((100 << 16) + 0x1000, (102 << 16) + 0x1000 + 40000));
+  // the 2MHz timer wrapped more than once
+  EXPECT_EQ(100000u, sdStatsDuration((100 << 16) + 0x1000, (105 << 16) + 0x1000));
+  // the 10ms tick wrapped
+  EXPECT_EQ(60000u, sdStatsDuration((0xFFFFu << 16), (2 << 16)));
+}
+#endif
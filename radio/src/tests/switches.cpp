@@ -362,3 +362,45 @@ TEST(getSwitch, inputWithTrim)
   EXPECT_EQ(getSwitch(SWSRC_SW1), true);
 }
 #endif
+
+#if defined(CPUARM)
+#if defined(PCBTARANIS)
+  #define SNAPSHOT_SWITCH   SWSRC_SA0
+  #define SNAPSHOT_SW_ON()  simuSetSwitch(0, -1)
+  #define SNAPSHOT_SW_OFF() simuSetSwitch(0, 0)
+#else
+  #define SNAPSHOT_SWITCH   SWSRC_THR
+  #define SNAPSHOT_SW_ON()  simuSetSwitch(0, 1)
+  #define SNAPSHOT_SW_OFF() simuSetSwitch(0, 0)
+#endif
+
+TEST(getSwitch, snapshotFrozenDuringCycle)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  MIXER_RESET();
+
+  SNAPSHOT_SW_OFF();
+  takeSwitchesSnapshot();
+  EXPECT_EQ(getSwitch(SNAPSHOT_SWITCH), false);
+  SNAPSHOT_SW_ON();
+  EXPECT_EQ(getSwitch(SNAPSHOT_SWITCH), false);
+  EXPECT_EQ(getSwitch(-SNAPSHOT_SWITCH), true);
+  releaseSwitchesSnapshot();
+  EXPECT_EQ(getSwitch(SNAPSHOT_SWITCH), true);
+  SNAPSHOT_SW_OFF();
+}
+
+TEST(getSwitch, snapshotReleasedAfterMixer)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  MIXER_RESET();
+
+  SNAPSHOT_SW_ON();
+  doMixerCalculations();
+  EXPECT_EQ(switchesSnapshotValid, false);
+  SNAPSHOT_SW_OFF();
+  EXPECT_EQ(getSwitch(SNAPSHOT_SWITCH), false);
+}
+#endif // #if defined(CPUARM)
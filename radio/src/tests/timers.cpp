@@ -0,0 +1,261 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <sys/stat.h>
+#include "gtests.h"
+
+#define TIMERS_RESET() \
+  memset(&g_model, 0, sizeof(g_model)); \
+  MIXER_RESET()
+
+static void startTimers()
+{
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    timerReset(i);
+  }
+}
+
+// runs the timers for the given number of seconds, and returns the elapsed
+// seconds at which something else than counting was done
+static std::vector<int> runTimerSeconds(uint8_t idx, int seconds, int16_t throttle=0)
+{
+  std::vector<int> events;
+  uint16_t start = g_model.timers[idx].start;
+  for (int i=0; i<seconds; i++) {
+    int16_t nextEvent = timersStates[idx].nextEvent;
+    evalTimers(throttle, 100);
+    int16_t elapsed = start ? start - timersStates[idx].val : timersStates[idx].val;
+    if (elapsed >= nextEvent) {
+      events.push_back(elapsed);
+    }
+  }
+  return events;
+}
+
+TEST(Timers, CountdownEvents)
+{
+  TIMERS_RESET();
+  g_model.timers[0].mode = TMRMODE_ABS;
+  g_model.timers[0].start = 65;
+  g_model.timers[0].countdownBeep = COUNTDOWN_BEEPS;
+  g_model.timers[0].minuteBeep = 1;
+  startTimers();
+
+  // 1:00 call, 30s and 20s beeps, 10s to 1s beeps, 0s and the timer stop
+  const int expected[] = { 5, 35, 45, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 125 };
+  std::vector<int> events = runTimerSeconds(0, 64);
+  EXPECT_EQ(TMR_RUNNING, timersStates[0].state);
+  EXPECT_EQ(1, timersStates[0].val);
+  std::vector<int> more = runTimerSeconds(0, 1);
+  events.insert(events.end(), more.begin(), more.end());
+  EXPECT_EQ(TMR_NEGATIVE, timersStates[0].state);
+  EXPECT_EQ(0, timersStates[0].val);
+  more = runTimerSeconds(0, MAX_ALERT_TIME+10);
+  events.insert(events.end(), more.begin(), more.end());
+  EXPECT_EQ(TMR_STOPPED, timersStates[0].state);
+  EXPECT_EQ(-MAX_ALERT_TIME-10, timersStates[0].val);
+  EXPECT_EQ(std::vector<int>(expected, expected+DIM(expected)), events);
+}
+
+TEST(Timers, MinuteCalls)
+{
+  TIMERS_RESET();
+  g_model.timers[0].mode = TMRMODE_ABS;
+  g_model.timers[0].minuteBeep = 1;
+  startTimers();
+  const int expected[] = { 60, 120, 180 };
+  std::vector<int> events = runTimerSeconds(0, 200);
+  EXPECT_EQ(200, timersStates[0].val);
+  EXPECT_EQ(TMR_RUNNING, timersStates[0].state);
+  EXPECT_EQ(std::vector<int>(expected, expected+DIM(expected)), events);
+}
+
+TEST(Timers, SetValue)
+{
+  TIMERS_RESET();
+  g_model.timers[0].mode = TMRMODE_ABS;
+  g_model.timers[0].start = 120;
+  g_model.timers[0].countdownBeep = COUNTDOWN_BEEPS;
+  startTimers();
+  runTimerSeconds(0, 1);
+
+  // the countdown beeps are scheduled again after the value was changed
+  timerSet(0, 15);
+  const int expected[] = { 110, 111, 112, 113, 114, 115 };
+  std::vector<int> events = runTimerSeconds(0, 10);
+  EXPECT_EQ(5, timersStates[0].val);
+  EXPECT_EQ(std::vector<int>(expected, expected+DIM(expected)), events);
+}
+
+TEST(Timers, ThrottleRelative)
+{
+  TIMERS_RESET();
+  g_model.timers[0].mode = TMRMODE_THR_REL;
+  g_model.timers[1].mode = TMRMODE_THR;
+  startTimers();
+
+  // a quarter of the throttle, plus less than what the throttle trace resolution shows
+  runTimerSeconds(0, 1000, RESX/2 + 8);
+  EXPECT_EQ(253, timersStates[0].val);
+  EXPECT_EQ(1000, timersStates[1].val);
+
+  timerReset(0);
+  timerReset(1);
+  runTimerSeconds(0, 100, 2*RESX);
+  EXPECT_EQ(100, timersStates[0].val);
+  runTimerSeconds(0, 100, RESX/128); // below the THR timers resolution
+  EXPECT_EQ(100, timersStates[0].val);
+  EXPECT_EQ(100, timersStates[1].val);
+}
+
+TEST(Timers, FlightReset)
+{
+  TIMERS_RESET();
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    g_model.timers[i].mode = TMRMODE_ABS;
+    g_model.timers[i].start = 100;
+  }
+#if defined(CPUARM) || defined(CPUM2560)
+  g_model.timers[1].persistent = 2;
+#endif
+  startTimers();
+  runTimerSeconds(0, 10);
+  flightReset();
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    if (IS_MANUAL_RESET_TIMER(i))
+      EXPECT_EQ(90, timersStates[i].val);
+    else
+      EXPECT_EQ(100, timersStates[i].val);
+  }
+}
+
+#if defined(TIMERS_JOURNAL)
+class TimersJournalTest : public testing::Test {
+  protected:
+    virtual void SetUp()
+    {
+      strcpy(savedSdDirectory, simuSdDirectory);
+      strcpy(simuSdDirectory, "/tmp/timersXXXXXX");
+      ASSERT_TRUE(mkdtemp(simuSdDirectory) != NULL);
+      TIMERS_RESET();
+      g_eeGeneral.currModel = 3;
+      g_model.timers[0].mode = TMRMODE_ABS;
+      g_model.timers[0].persistent = 1;
+      g_model.timers[0].value = 100;
+      g_model.timers[1].mode = TMRMODE_ABS;
+      startTimers();
+      restoreTimers();
+      checkTimersJournal(); // no journal
+      s_eeDirtyMsk = 0;
+    }
+
+    virtual void TearDown()
+    {
+      char path[1100];
+      sprintf(path, "%s" TIMERS_JOURNAL_PATH, simuSdDirectory);
+      unlink(path);
+      sprintf(path, "%s" MODELS_PATH, simuSdDirectory);
+      rmdir(path);
+      rmdir(simuSdDirectory);
+      strcpy(simuSdDirectory, savedSdDirectory);
+      s_eeDirtyMsk = 0;
+    }
+
+    void createModelsFolder()
+    {
+      char path[1100];
+      sprintf(path, "%s" MODELS_PATH, simuSdDirectory);
+      mkdir(path, 0777);
+    }
+
+    char savedSdDirectory[1024];
+};
+
+TEST_F(TimersJournalTest, roundTrip)
+{
+  createModelsFolder();
+  EXPECT_EQ(100, timersStates[0].val);
+  runTimerSeconds(0, 50);
+  closeTimers();
+  EXPECT_EQ(100, g_model.timers[0].value);
+  EXPECT_FALSE(s_eeDirtyMsk & EE_MODEL);
+
+  // power on again, the journal is read once the SD card is mounted
+  timerReset(0);
+  restoreTimers();
+  EXPECT_EQ(100, timersStates[0].val);
+  runTimerSeconds(0, 2);
+  checkTimersJournal();
+  EXPECT_EQ(152, timersStates[0].val);
+  EXPECT_EQ(52, timersStates[1].val);
+}
+
+TEST_F(TimersJournalTest, otherModel)
+{
+  createModelsFolder();
+  runTimerSeconds(0, 50);
+  closeTimers();
+
+  timerReset(0);
+  g_model.header.name[0] = 1;
+  restoreTimers();
+  checkTimersJournal();
+  EXPECT_EQ(100, timersStates[0].val);
+
+  g_model.header.name[0] = 0;
+  g_eeGeneral.currModel = 4;
+  restoreTimers();
+  checkTimersJournal();
+  EXPECT_EQ(100, timersStates[0].val);
+}
+
+TEST_F(TimersJournalTest, modelWrittenAnyway)
+{
+  createModelsFolder();
+  runTimerSeconds(0, 50);
+  eeDirty(EE_MODEL);
+  closeTimers();
+  EXPECT_EQ(150, g_model.timers[0].value);
+}
+
+TEST_F(TimersJournalTest, noSdCard)
+{
+  runTimerSeconds(0, 50);
+  closeTimers();
+  EXPECT_EQ(150, g_model.timers[0].value);
+  EXPECT_TRUE(s_eeDirtyMsk & EE_MODEL);
+}
+#endif
@@ -0,0 +1,374 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "opentx.h"
+
+TimerState timersStates[MAX_TIMERS] = { { 0 } };
+
+#if defined(CPUARM)
+static uint32_t timersVersion = 0;
+#endif
+
+// the timers count the elapsed seconds, they are displayed backwards when they have a start value
+#define TIMER_ELAPSED(tv, val) ((tv) ? (int16_t)((tv) - (val)) : (val))
+
+// smallest multiple of 60 above x
+static int16_t nextMinute(int16_t x)
+{
+  int16_t r = x % 60;
+  if (r < 0) r += 60;
+  return x - r + 60;
+}
+
+static inline void timerEventCandidate(int16_t & result, int16_t elapsed, int16_t candidate)
+{
+  if (candidate > elapsed && candidate < result) {
+    result = candidate;
+  }
+}
+
+// Returns the elapsed seconds at which evalTimers() has something else to do than
+// counting: a countdown beep, a minute call, or a state change. Only the RUNNING and
+// NEGATIVE states have events, and the state changes are returned even if their time
+// is already passed.
+static int16_t timerNextEvent(uint8_t idx)
+{
+  TimerState & timerState = timersStates[idx];
+  TimerData & timer = g_model.timers[idx];
+  int16_t tv = timer.start;
+  int16_t elapsed = TIMER_ELAPSED(tv, timerState.val);
+  int16_t result = TMR_NO_EVENT;
+
+  if (timerState.state == TMR_RUNNING) {
+    if (tv) {
+      result = tv;
+      if (timer.countdownBeep) {
+        timerEventCandidate(result, elapsed, tv-30);
+        timerEventCandidate(result, elapsed, tv-20);
+        timerEventCandidate(result, elapsed, tv-10);
+        if (elapsed >= tv-10) {
+          timerEventCandidate(result, elapsed, elapsed+1);
+        }
+      }
+    }
+    if (timer.minuteBeep) {
+      timerEventCandidate(result, elapsed, tv + nextMinute(elapsed - tv));
+    }
+  }
+  else if (timerState.state == TMR_NEGATIVE) {
+    result = tv + MAX_ALERT_TIME;
+  }
+
+  return result;
+}
+
+void timerSet(uint8_t idx, int16_t val)
+{
+  TimerState & timerState = timersStates[idx];
+  timerState.val = val;
+  timerState.nextEvent = timerNextEvent(idx);
+}
+
+void timerReset(uint8_t idx)
+{
+  TimerState & timerState = timersStates[idx];
+  timerState.state = TMR_OFF; // is changed to RUNNING dep from mode
+  timerState.val_10ms = 0;
+  timerSet(idx, g_model.timers[idx].start);
+}
+
+void evalTimers(int16_t throttle, uint8_t tick10ms)
+{
+#if defined(CPUARM)
+  // the start value or the beeps of a timer may have been changed
+  uint32_t version = MODEL_CACHE_VERSION(MODEL_CACHE_TIMERS);
+  bool modelChanged = (timersVersion != version);
+  timersVersion = version;
+#endif
+
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    int8_t tm = g_model.timers[i].mode;
+    uint16_t tv = g_model.timers[i].start;
+    TimerState * timerState = &timersStates[i];
+
+    if (tm) {
+      if (timerState->state == TMR_OFF) {
+        timerState->state = TMR_RUNNING;
+        timerState->thrSum = 0;
+        timerState->nextEvent = timerNextEvent(i);
+      }
+#if defined(CPUARM)
+      else if (modelChanged) {
+        timerState->nextEvent = timerNextEvent(i);
+      }
+#endif
+
+      if (tm == TMRMODE_THR_REL) {
+        timerState->thrSum += (uint32_t)throttle * tick10ms;
+      }
+
+      if ((timerState->val_10ms += tick10ms) >= 100) {
+        timerState->val_10ms -= 100 ;
+        int16_t newTimerVal = TIMER_ELAPSED(tv, timerState->val);
+
+        if (tm == TMRMODE_ABS) {
+          newTimerVal++;
+        }
+        else if (tm == TMRMODE_THR) {
+          if (throttle >> THR_TRACE_SHIFT) newTimerVal++;
+        }
+        else if (tm == TMRMODE_THR_REL) {
+          if (timerState->thrSum >= TIMER_THR_REL_SECOND) {
+            newTimerVal++;  // add second used of throttle
+            timerState->thrSum -= TIMER_THR_REL_SECOND;
+          }
+        }
+        else if (tm == TMRMODE_THR_TRG) {
+          if (throttle >> THR_TRACE_SHIFT) {
+            timerState->state = TMR_TRIGGED;
+          }
+          if (timerState->state == TMR_TRIGGED) {
+            newTimerVal++;
+          }
+        }
+        else {
+          if (tm > 0) tm -= (TMRMODE_COUNT-1);
+          if (getSwitch(tm))
+            newTimerVal++;
+        }
+
+#if !defined(CPUARM)
+        // there is no model changes counter here
+        timerState->nextEvent = timerNextEvent(i);
+#endif
+
+        bool event = (newTimerVal >= timerState->nextEvent);
+
+        if (event) {
+          switch (timerState->state) {
+            case TMR_RUNNING:
+              if (tv && newTimerVal>=(int16_t)tv) {
+                AUDIO_TIMER_00(g_model.timers[i].countdownBeep);
+                timerState->state = TMR_NEGATIVE;
+              }
+              break;
+            case TMR_NEGATIVE:
+              if (newTimerVal >= (int16_t)tv + MAX_ALERT_TIME) timerState->state = TMR_STOPPED;
+              break;
+          }
+        }
+
+        if (tv) newTimerVal = tv - newTimerVal; // if counting backwards - display backwards
+
+        if (newTimerVal != timerState->val) {
+          timerState->val = newTimerVal;
+          if (event && timerState->state == TMR_RUNNING) {
+            if (g_model.timers[i].countdownBeep && g_model.timers[i].start) {
+              if (newTimerVal==30) AUDIO_TIMER_30();
+              if (newTimerVal==20) AUDIO_TIMER_20();
+              if (newTimerVal<=10) AUDIO_TIMER_LT10(g_model.timers[i].countdownBeep, newTimerVal);
+            }
+            if (g_model.timers[i].minuteBeep && (newTimerVal % 60)==0) {
+              AUDIO_TIMER_MINUTE(newTimerVal);
+            }
+          }
+        }
+
+        if (event) {
+          timerState->nextEvent = timerNextEvent(i);
+        }
+      }
+    }
+  }
+}
+
+#if defined(TIMERS_JOURNAL)
+#define TIMERS_JOURNAL_MAGIC 0x4A524D54 // "TMRJ"
+
+PACK(struct TimersJournalData {
+  uint32_t magic;
+  uint32_t modelChecksum;  // of the model as it is in EEPROM, the values included
+  uint8_t  model;
+  int16_t  values[MAX_TIMERS];
+});
+
+static struct {
+  bool     pending;
+  uint32_t modelChecksum;
+} timersJournal;
+
+static uint32_t modelChecksum()
+{
+  uint32_t a = 1, b = 0;
+  const uint8_t * data = (const uint8_t *)&g_model;
+  for (unsigned int i=0; i<sizeof(g_model); i++) {
+    a += data[i];
+    b += a;
+  }
+  return (b << 16) ^ a;
+}
+
+static bool writeTimersJournal()
+{
+  TimersJournalData journal;
+  journal.magic = TIMERS_JOURNAL_MAGIC;
+  journal.modelChecksum = modelChecksum();
+  journal.model = g_eeGeneral.currModel;
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    journal.values[i] = timersStates[i].val;
+  }
+
+  if (!sdMounted()) {
+    return false;
+  }
+
+  DIR folder;
+  FRESULT result = f_opendir(&folder, MODELS_PATH);
+  if (result == FR_NO_PATH) {
+    result = f_mkdir(MODELS_PATH);
+  }
+  if (result != FR_OK) {
+    return false;
+  }
+
+  FIL file;
+  UINT written = 0;
+  if (f_open(&file, TIMERS_JOURNAL_PATH, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    return false;
+  }
+  result = f_write(&file, &journal, sizeof(journal), &written);
+  if (f_close(&file) != FR_OK) {
+    return false;
+  }
+
+  return result == FR_OK && written == sizeof(journal);
+}
+
+void checkTimersJournal()
+{
+  if (!timersJournal.pending || !sdMounted()) {
+    return;
+  }
+
+  timersJournal.pending = false;
+
+  FIL file;
+  UINT read = 0;
+  TimersJournalData journal;
+  if (f_open(&file, TIMERS_JOURNAL_PATH, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+    return;
+  }
+  FRESULT result = f_read(&file, &journal, sizeof(journal), &read);
+  f_close(&file);
+
+  if (result == FR_OK && read == sizeof(journal) && journal.magic == TIMERS_JOURNAL_MAGIC &&
+      journal.model == g_eeGeneral.currModel && journal.modelChecksum == timersJournal.modelChecksum) {
+    for (uint8_t i=0; i<MAX_TIMERS; i++) {
+      if (g_model.timers[i].persistent) {
+        // the timers may have already run since the model was loaded
+        timerSet(i, timersStates[i].val + journal.values[i] - (int16_t)g_model.timers[i].value);
+      }
+    }
+    f_unlink(TIMERS_JOURNAL_PATH);
+  }
+}
+#endif
+
+#if !defined(PCBSTD)
+void restoreTimers()
+{
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    if (g_model.timers[i].persistent) {
+      timerSet(i, g_model.timers[i].value);
+    }
+  }
+
+#if defined(TIMERS_JOURNAL)
+  timersJournal.pending = true;
+  timersJournal.modelChecksum = modelChecksum();
+#endif
+}
+#endif
+
+#if defined(CPUARM) || defined(CPUM2560)
+static bool persistentTimersChanged()
+{
+  for (uint8_t i=0; i<MAX_TIMERS; i++) {
+    if (g_model.timers[i].persistent && g_model.timers[i].value != (uint16_t)timersStates[i].val) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void saveSessionTimer()
+{
+#if defined(CPUARM) && !defined(REVA)
+  if (sessionTimer > 0) {
+    g_eeGeneral.globalTimer += sessionTimer;
+    eeDirty(EE_GENERAL);
+    sessionTimer = 0;
+  }
+#endif
+}
+
+void saveTimers()
+{
+  if (persistentTimersChanged()) {
+    for (uint8_t i=0; i<MAX_TIMERS; i++) {
+      if (g_model.timers[i].persistent) {
+        g_model.timers[i].value = timersStates[i].val;
+      }
+    }
+    eeDirty(EE_MODEL);
+  }
+
+  saveSessionTimer();
+}
+#endif
+
+#if defined(TIMERS_JOURNAL)
+void closeTimers()
+{
+  // the values go in the model if it has to be written anyway
+  if (persistentTimersChanged() && !(s_eeDirtyMsk & EE_MODEL) && writeTimersJournal()) {
+    saveSessionTimer();
+  }
+  else {
+    saveTimers();
+  }
+}
+#endif
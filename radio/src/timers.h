@@ -0,0 +1,104 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef timers_h
+#define timers_h
+
+#if !defined(CPUM64) && !defined(ACCURAT_THROTTLE_TIMER)
+  //  code cost is about 16 bytes for higher throttle accuracy for timer
+  //  would not be noticable anyway, because all version up to this change had only 16 steps;
+  //  now it has already 32  steps; this define would increase to 128 steps
+  #define ACCURAT_THROTTLE_TIMER
+#endif
+
+// the throttle (0 to 2*RESX) resolution of the throttle trace and of the THR / THR_TRG "on" detection
+#if defined(ACCURAT_THROTTLE_TIMER)
+  #define THR_TRACE_SHIFT      (RESX_SHIFT-6) // calibrate it (resolution increased by factor 4)
+#else
+  #define THR_TRACE_SHIFT      (RESX_SHIFT-4) // calibrate it
+#endif
+
+// THR_REL timers integrate the throttle at full resolution, one second is counted each
+// time the integral reaches one second of full throttle
+#define TIMER_THR_REL_SECOND   (100*2*(uint32_t)RESX)
+
+#define TMR_OFF      0
+#define TMR_RUNNING  1
+#define TMR_NEGATIVE 2
+#define TMR_STOPPED  3
+#define TMR_TRIGGED  4
+
+#define TMR_NO_EVENT 32767
+
+struct TimerState {
+  uint32_t thrSum;      // THR_REL throttle integral, in 10ms ticks of full resolution throttle
+  int16_t  val;
+  int16_t  nextEvent;   // elapsed seconds of the next countdown beep, minute call or state change
+  uint8_t  val_10ms;
+  uint8_t  state;
+};
+
+extern TimerState timersStates[MAX_TIMERS];
+
+void timerReset(uint8_t idx);
+void timerSet(uint8_t idx, int16_t val);
+void evalTimers(int16_t throttle, uint8_t tick10ms);
+
+#if !defined(PCBSTD)
+void restoreTimers();
+#endif
+
+#if defined(CPUARM) || defined(CPUM2560)
+void saveTimers();
+#else
+#define saveTimers()
+#endif
+
+#if defined(CPUARM) && defined(SDCARD)
+  // At power off the persistent timers values are written in a small journal
+  // on the SD card instead of the model, which is then only rewritten when
+  // something else changed. The journal is applied once the SD card is
+  // mounted, if it was written for the model which is loaded.
+  #define TIMERS_JOURNAL
+  #define TIMERS_JOURNAL_PATH  MODELS_PATH "/timers.jnl"
+  void closeTimers();
+  void checkTimersJournal();
+#else
+  #define closeTimers()        saveTimers()
+  #define checkTimersJournal()
+#endif
+
+#endif
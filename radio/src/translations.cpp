@@ -469,6 +469,11 @@ const pm_char STR_SD_TYPE[] PROGMEM = TR_SD_TYPE;
 const pm_char STR_SD_SPEED[] PROGMEM = TR_SD_SPEED;
 const pm_char STR_SD_SECTORS[] PROGMEM = TR_SD_SECTORS;
 const pm_char STR_SD_SIZE[] PROGMEM = TR_SD_SIZE;
+#if defined(CPUARM)
+const pm_char STR_SD_READ[] PROGMEM = TR_SD_READ;
+const pm_char STR_SD_WRITE[] PROGMEM = TR_SD_WRITE;
+const pm_char STR_SD_CACHE[] PROGMEM = TR_SD_CACHE;
+#endif
 const pm_char STR_TYPE[] PROGMEM = TR_TYPE;
 const pm_char STR_GLOBAL_VARS[] PROGMEM = TR_GLOBAL_VARS;
 const pm_char STR_GLOBAL_V[] PROGMEM = TR_GLOBAL_V;
@@ -545,6 +550,12 @@ const pm_char STR_BLCOLOR[]  PROGMEM = TR_BLCOLOR;
   const pm_char STR_SCRIPT[] PROGMEM = TR_SCRIPT;
   const pm_char STR_INPUTS[] PROGMEM = TR_INPUTS;
   const pm_char STR_OUTPUTS[] PROGMEM = TR_OUTPUTS;  
+  const pm_char STR_SBUS[] PROGMEM = TR_SBUS;
+  const pm_char STR_SBUS_ERRORS[] PROGMEM = TR_SBUS_ERRORS;
+  const pm_char STR_SBUS_LOST[] PROGMEM = TR_SBUS_LOST;
+  const pm_char STR_SBUS_FAILSAFES[] PROGMEM = TR_SBUS_FAILSAFES;
+  const pm_char STR_SBUS_LATENCY[] PROGMEM = TR_SBUS_LATENCY;
+  const pm_char STR_HZ[] PROGMEM = TR_HZ;
 #endif
 
 #if MENUS_LOCK == 1
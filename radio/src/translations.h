@@ -634,6 +634,11 @@ extern const pm_char STR_SD_TYPE[];
 extern const pm_char STR_SD_SPEED[];
 extern const pm_char STR_SD_SECTORS[];
 extern const pm_char STR_SD_SIZE[];
+#if defined(CPUARM)
+extern const pm_char STR_SD_READ[];
+extern const pm_char STR_SD_WRITE[];
+extern const pm_char STR_SD_CACHE[];
+#endif
 extern const pm_char STR_TYPE[];
 extern const pm_char STR_GLOBAL_VARS[];
 extern const pm_char STR_GLOBAL_V[];
@@ -746,6 +751,12 @@ extern const pm_char STR_BLCOLOR[];
   extern const pm_char STR_SCRIPT[];
   extern const pm_char STR_INPUTS[];
   extern const pm_char STR_OUTPUTS[]; 
+  extern const pm_char STR_SBUS[];
+  extern const pm_char STR_SBUS_ERRORS[];
+  extern const pm_char STR_SBUS_LOST[];
+  extern const pm_char STR_SBUS_FAILSAFES[];
+  extern const pm_char STR_SBUS_LATENCY[];
+  extern const pm_char STR_HZ[];
 #endif
 
 #if MENUS_LOCK == 1
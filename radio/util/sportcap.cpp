@@ -0,0 +1,357 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+
+// Offline analyzer for the S.Port captures written by the radio when
+// SPORT_FILE_LOG is enabled (LOGS/sport.cap).
+//
+// Build: make -C src sportcap (or g++ -O2 -o sportcap util/sportcap.cpp)
+// Usage: sportcap [-c] [-e] file.cap
+//   default  per session report: frames, polls and answers per physical id,
+//            rate and jitter per sensor, CRC errors
+//   -c       per sensor time series as CSV: session,time,phys,appid,value
+//   -e       list the frames with a CRC error or truncated
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <map>
+#include "../src/telemetry/capture.h"
+
+#define START_STOP            0x7e
+#define BYTESTUFF             0x7d
+#define STUFF_MASK            0x20
+#define DATA_FRAME            0x10
+#define SPORT_PACKET_SIZE     9
+#define SPORT_PHYS_ID(id)     ((id) & 0x1F)
+
+struct Interval {
+  uint64_t last;
+  uint32_t count;
+  double   sum;
+  double   sum2;
+  uint32_t min;
+  uint32_t max;
+
+  Interval(): last(0), count(0), sum(0), sum2(0), min(0xFFFFFFFF), max(0) { }
+
+  void add(uint64_t time, bool first)
+  {
+    if (!first) {
+      uint32_t delta = time - last;
+      count++;
+      sum += delta;
+      sum2 += (double)delta * delta;
+      if (delta < min) min = delta;
+      if (delta > max) max = delta;
+    }
+    last = time;
+  }
+
+  double mean() const
+  {
+    return count ? sum / count : 0;
+  }
+
+  double stddev() const
+  {
+    if (count < 2)
+      return 0;
+    double m = mean();
+    double variance = sum2 / count - m * m;
+    return variance > 0 ? sqrt(variance) : 0;
+  }
+};
+
+struct PhysicalId {
+  uint32_t polls;
+  uint32_t answers;
+  Interval interval;
+
+  PhysicalId(): polls(0), answers(0) { }
+};
+
+struct Sensor {
+  uint32_t count;
+  uint32_t value;
+  Interval interval;
+
+  Sensor(): count(0), value(0) { }
+};
+
+struct Session {
+  int      index;
+  uint8_t  protocol;
+  uint32_t date;
+  uint64_t start;
+  uint64_t time;       // us, the 32 bits record times unwrapped
+  uint32_t lastRecord;
+  uint32_t frames;
+  uint32_t crcErrors;
+  uint32_t truncated;
+  uint32_t others;     // frames which are neither polls nor packets
+  Interval interval;
+  std::map<uint8_t, PhysicalId> ids;
+  std::map<uint32_t, Sensor> sensors;  // key = phys << 16 | appId
+};
+
+static bool csvOutput = false;
+static bool errorsOutput = false;
+
+static bool checkSportPacket(const uint8_t * packet)
+{
+  uint16_t crc = 0;
+  for (int i=1; i<SPORT_PACKET_SIZE; i++) {
+    crc += packet[i];
+    crc += crc >> 8;
+    crc &= 0x00ff;
+  }
+  return (crc == 0x00ff);
+}
+
+static int unstuff(const uint8_t * data, int length, uint8_t * frame)
+{
+  int result = 0;
+  for (int i=0; i<length; i++) {
+    if (data[i] == BYTESTUFF && i+1 < length)
+      frame[result++] = data[++i] ^ STUFF_MASK;
+    else
+      frame[result++] = data[i];
+  }
+  return result;
+}
+
+static uint32_t getValue(const uint8_t * data, int size)
+{
+  uint32_t result = 0;
+  for (int i=size-1; i>=0; i--) {
+    result = (result << 8) + data[i];
+  }
+  return result;
+}
+
+static void printFrame(const char * error, const Session & session, const uint8_t * frame, int length)
+{
+  printf("%d %.6f %s:", session.index, (session.time - session.start) / 1e6, error);
+  for (int i=0; i<length; i++) {
+    printf(" %02X", frame[i]);
+  }
+  printf("\n");
+}
+
+static void processFrame(Session & session, const uint8_t * data, int length)
+{
+  uint8_t frame[256];
+  length = unstuff(data, length, frame);
+
+  session.interval.add(session.time, session.frames == 0);
+  session.frames++;
+
+  if (length == 0 || length > SPORT_PACKET_SIZE) {
+    session.others++;
+    return;
+  }
+
+  uint8_t phys = SPORT_PHYS_ID(frame[0]);
+  PhysicalId & id = session.ids[phys];
+  id.interval.add(session.time, id.polls == 0);
+  id.polls++;
+
+  if (length == 1) {
+    return;
+  }
+  else if (length < SPORT_PACKET_SIZE) {
+    session.truncated++;
+    if (errorsOutput)
+      printFrame("truncated", session, frame, length);
+    return;
+  }
+  else if (!checkSportPacket(frame)) {
+    session.crcErrors++;
+    if (errorsOutput)
+      printFrame("crc", session, frame, length);
+    return;
+  }
+
+  id.answers++;
+
+  if (frame[1] != DATA_FRAME)
+    return;
+
+  uint16_t appId = getValue(&frame[2], 2);
+  uint32_t value = getValue(&frame[4], 4);
+  Sensor & sensor = session.sensors[(phys << 16) + appId];
+  sensor.interval.add(session.time, sensor.count == 0);
+  sensor.count++;
+  sensor.value = value;
+
+  if (csvOutput) {
+    printf("%d,%.6f,%d,0x%04X,%d\n", session.index, (session.time - session.start) / 1e6, phys, appId, (int32_t)value);
+  }
+}
+
+static void printInterval(const Interval & interval)
+{
+  printf("%8.2f %8.2f %8.2f %8.2f", interval.mean() / 1000, interval.stddev() / 1000, interval.count ? interval.min / 1000.0 : 0, interval.max / 1000.0);
+}
+
+static void printSession(const Session & session)
+{
+  double duration = (session.time - session.start) / 1e6;
+
+  printf("Session %d: protocol %d, date %u, %.3fs\n", session.index, session.protocol, session.date, duration);
+  printf("  frames %u, crc errors %u, truncated %u, others %u\n", session.frames, session.crcErrors, session.truncated, session.others);
+  printf("  frames interval (ms)    mean   stddev      min      max\n");
+  printf("                      ");
+  printInterval(session.interval);
+  printf("\n");
+
+  if (!session.ids.empty()) {
+    printf("  phys   polls  poll/s answers answer%%   mean   stddev      min      max (ms)\n");
+    for (std::map<uint8_t, PhysicalId>::const_iterator it = session.ids.begin(); it != session.ids.end(); ++it) {
+      const PhysicalId & id = it->second;
+      printf("  %4d %7u %7.2f %7u %6.1f%% ", it->first, id.polls, duration > 0 ? id.polls / duration : 0, id.answers, id.polls ? 100.0 * id.answers / id.polls : 0);
+      printInterval(id.interval);
+      printf("\n");
+    }
+  }
+
+  if (!session.sensors.empty()) {
+    printf("  phys  appid   count   rate/s   mean   stddev      min      max (ms)      last\n");
+    for (std::map<uint32_t, Sensor>::const_iterator it = session.sensors.begin(); it != session.sensors.end(); ++it) {
+      const Sensor & sensor = it->second;
+      printf("  %4d 0x%04X %7u %7.2f ", it->first >> 16, it->first & 0xFFFF, sensor.count, duration > 0 ? sensor.count / duration : 0);
+      printInterval(sensor.interval);
+      printf(" %9d\n", (int32_t)sensor.value);
+    }
+  }
+
+  printf("\n");
+}
+
+static void usage()
+{
+  fprintf(stderr, "Usage: sportcap [-c] [-e] file.cap\n");
+  fprintf(stderr, "  -c  print the sensors values as CSV (session,time,phys,appid,value)\n");
+  fprintf(stderr, "  -e  print the frames with a CRC error or truncated\n");
+  exit(1);
+}
+
+int main(int argc, char ** argv)
+{
+  const char * path = NULL;
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp(argv[i], "-c"))
+      csvOutput = true;
+    else if (!strcmp(argv[i], "-e"))
+      errorsOutput = true;
+    else if (argv[i][0] != '-' && !path)
+      path = argv[i];
+    else
+      usage();
+  }
+
+  if (!path)
+    usage();
+
+  FILE * file = fopen(path, "rb");
+  if (!file) {
+    perror(path);
+    return 1;
+  }
+
+  if (csvOutput)
+    printf("session,time,phys,appid,value\n");
+
+  Session * session = NULL;
+  int sessions = 0;
+  int result = 0;
+  uint8_t record[TELEMETRY_CAPTURE_RECORD_SIZE];
+  uint8_t data[256];
+
+  while (fread(record, 1, sizeof(record), file) == sizeof(record)) {
+    uint32_t time = getValue(record, 4);
+    uint8_t length = record[4];
+    if (fread(data, 1, length, file) != length) {
+      fprintf(stderr, "%s: truncated record at the end of the file\n", path);
+      result = 1;
+      break;
+    }
+
+    if (time == TELEMETRY_CAPTURE_SESSION) {
+      if (length < TELEMETRY_CAPTURE_HEADER_SIZE || memcmp(data, TELEMETRY_CAPTURE_MAGIC, 4)) {
+        fprintf(stderr, "%s: invalid session header\n", path);
+        result = 1;
+        break;
+      }
+      if (data[4] > TELEMETRY_CAPTURE_VERSION) {
+        fprintf(stderr, "%s: unsupported version %d\n", path, data[4]);
+        result = 1;
+        break;
+      }
+      if (session && !csvOutput)
+        printSession(*session);
+      delete session;
+      session = new Session();
+      session->index = sessions++;
+      session->protocol = data[5];
+      session->date = getValue(&data[8], 4);
+      session->start = session->time = 0;
+      session->lastRecord = 0;
+      session->frames = session->crcErrors = session->truncated = session->others = 0;
+      continue;
+    }
+
+    if (!session) {
+      fprintf(stderr, "%s: not a capture file\n", path);
+      result = 1;
+      break;
+    }
+
+    session->time += (uint32_t)(time - session->lastRecord);
+    session->lastRecord = time;
+    processFrame(*session, data, length);
+  }
+
+  if (session && !csvOutput)
+    printSession(*session);
+  delete session;
+  fclose(file);
+  return result;
+}